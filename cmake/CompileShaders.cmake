@@ -14,7 +14,7 @@ add_custom_command(
         --output ${SHADER_OUTPUT}
     COMMAND ${CMAKE_COMMAND} -E touch ${SHADER_STAMP}
     DEPENDS ${SHADER_SCRIPT}
-    COMMENT "Compile (vertex and fragment) shaders to SPIR-V"
+    COMMENT "Compile (vertex, fragment, compute, task and mesh) shaders to SPIR-V"
     VERBATIM
 )
 
@@ -7,19 +7,22 @@ import subprocess
 import argparse
 
 parser = argparse.ArgumentParser(description="Compile GLSL shaders to SPIR-V")
-parser.add_argument("--input", required=True, help="Input directory containing .vert/.frag files")
+parser.add_argument("--input", required=True, help="Input directory containing .vert/.frag/.comp/.task/.mesh files")
 parser.add_argument("--output", required=True, help="Output directory for .spv files")
 args = parser.parse_args()
 
 os.makedirs(args.output, exist_ok=True)
 
+SHADER_EXTENSIONS = (".vert", ".frag", ".comp", ".task", ".mesh")
+
 for file in os.listdir(args.input):
-    if file.endswith(".vert") or file.endswith(".frag"):
+    if file.endswith(SHADER_EXTENSIONS):
         in_path = os.path.join(args.input, file)
         out_path = os.path.join(args.output, file + ".spv")
 
         print(f"Compiled {file} -> {out_path}")
-        result = subprocess.run(["glslangValidator", "-V", in_path, "-o", out_path])
+        # Mesh and task shaders (GL_EXT_mesh_shader) need at least SPIR-V 1.4
+        result = subprocess.run(["glslangValidator", "-V", "--target-env", "vulkan1.2", in_path, "-o", out_path])
 
         if result.returncode != 0:
             raise RuntimeError(f"Shader compilation failed: {file}")
@@ -1,19 +1,35 @@
 #include "VulkanRenderer.hpp"
+#include "core/VulkanMeshletCuller.hpp"
 #include "window/Window.hpp"
 
 #include "GLFW/glfw3.h"
 
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 
 static constexpr int WINDOW_WIDTH{700};
 static constexpr int WINDOW_HEIGHT{700};
 static constexpr std::string WINDOW_TITLE{"title"};
 
-int main()
+int main(int argc, char** argv)
 {
+    // NOTE: an optional .obj, .gltf, .glb or .rrmesh file to render instead of the default triangle
+    const std::filesystem::path meshPath{ argc > 1 ? argv[1] : "" }; // NOLINT
+
+    // NOTE: optionally followed by --meshlets for compute culled meshlets, --mesh-shaders for task and mesh shaders or
+    //       --gpu-driven for objects culled on the GPU and drawn with a single indirect draw
+    const std::string_view renderOption{ argc > 2 ? argv[2] : "" }; // NOLINT
+    rr::MeshletMode meshletMode{ rr::MeshletMode::DISABLED };
+    if(renderOption == "--meshlets")
+        meshletMode = rr::MeshletMode::COMPUTE;
+    else if(renderOption == "--mesh-shaders")
+        meshletMode = rr::MeshletMode::MESH_SHADER;
+    const bool gpuDriven{ renderOption == "--gpu-driven" };
+
     std::unique_ptr<rr::Window> w{ std::make_unique<rr::Window>(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE) };
-    std::unique_ptr<rr::VulkanRenderer> r{ std::make_unique<rr::VulkanRenderer>(*w) };
+    std::unique_ptr<rr::VulkanRenderer> r{ std::make_unique<rr::VulkanRenderer>(*w, meshPath, meshletMode, gpuDriven) };
 
     while(w->shouldClose() == 0)
     {
@@ -1,17 +1,39 @@
 #include "VulkanRenderer.hpp"
 
 #include "GLFW/glfw3.h"
-#include "core/VulkanCommandPool.hpp"
 #include "core/VulkanDebugMessenger.hpp"
+#include "core/VulkanDefragmenter.hpp"
 #include "core/VulkanDevice.hpp"
+#include "core/VulkanDrawBatcher.hpp"
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanFrameContext.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "core/VulkanGpuScene.hpp"
 #include "core/VulkanInstance.hpp"
 #include "core/VulkanMesh.hpp"
+#include "core/VulkanMeshletCuller.hpp"
+#include "core/VulkanParallelRecorder.hpp"
 #include "core/VulkanPipeline.hpp"
 #include "core/VulkanPipelineLayout.hpp"
 #include "core/VulkanSurface.hpp"
 #include "core/VulkanSwapchain.hpp"
+#include "core/VulkanUploadScheduler.hpp"
 #include "exception/EngineException.hpp"
+#include "exception/MeshImportException.hpp"
 #include "exception/VulkanException.hpp"
+#include "mesh/InstanceData.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/MeshFile.hpp"
+#include "mesh/MeshImporter.hpp"
+#include "mesh/MeshLod.hpp"
+#include "mesh/MeshOptimizer.hpp"
+#include "mesh/MeshSimplifier.hpp"
+#include "mesh/Meshlet.hpp"
+#include "mesh/MeshletBuilder.hpp"
+#include "mesh/Vertex.hpp"
+#include "scene/CullingSet.hpp"
+#include "scene/Frustum.hpp"
+#include "utility/Hasher.hpp"
 #include "window/Window.hpp"
 
 #include "spdlog/spdlog.h"
@@ -19,39 +41,82 @@
 #include <utility>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
 #include <memory>
 #include <source_location>
+#include <span>
+#include <system_error>
 #include <vector>
 
 namespace rr
 {
 
-VulkanRenderer::VulkanRenderer(Window& window)
+VulkanRenderer::VulkanRenderer(Window& window, const std::filesystem::path& meshPath, MeshletMode meshletMode, bool gpuDriven)
     : window(window)
     , m_debugMessenger(std::make_unique<VulkanDebugMessenger>(m_instance->getHandle()))
     , m_surface(std::make_unique<VulkanSurface>(m_instance->getHandle(), window))
-    , m_device(std::make_unique<VulkanDevice>(m_instance->getHandle(), m_surface->getHandle()))
-    , m_swapchain(std::make_unique<VulkanSwapchain>(*m_device, m_surface->getHandle(), window.getExtent()))
-    , m_pipelineLayout(std::make_unique<VulkanPipelineLayout>(m_device->getHandle()))
-    , m_pipeline(createPipeline())
-    , m_commandPool(std::make_unique<VulkanCommandPool>(*m_device))
-    , m_commandBuffers(m_commandPool->allocateCommandBuffer(m_swapchain->imageCount()))
+    , m_device(m_startupTimer.measure("device", [this] { return std::make_unique<VulkanDevice>(m_instance->getHandle(), m_surface->getHandle()); }))
+    , m_swapchain(m_startupTimer.measure("swapchain", [this, &window] { return std::make_unique<VulkanSwapchain>(*m_device, m_surface->getHandle(), window.getExtent(), m_device->supportsDynamicRendering()); }))
+    , m_frameAllocator(std::make_unique<VulkanFrameAllocator>(*m_device, VulkanSwapchain::MAX_FRAMES_IN_FLIGHT))
+    , m_pipelineLayout(std::make_unique<VulkanPipelineLayout>(m_device->getHandle(), std::vector{ m_frameAllocator->getDescriptorSetLayoutHandle() }))
+    , m_pipeline(m_startupTimer.measure("pipeline", [this] { return createPipeline(); }))
+    , m_instancedPipeline(createInstancedPipeline())
+    , m_frameContext(std::make_unique<VulkanFrameContext>(*m_device, VulkanSwapchain::MAX_FRAMES_IN_FLIGHT))
+    , m_recorder(std::make_unique<VulkanParallelRecorder>(*m_device, VulkanSwapchain::MAX_FRAMES_IN_FLIGHT))
 {
-    std::vector<Vertex> vertices{
-        {.position = {0.f, -0.5f}, .color = {1.f, 0.f, 0.f}}, //NOLINT
-        {.position = {0.5f, 0.5f}, .color = {0.f, 1.f, 0.f}}, //NOLINT
-        {.position = {-0.5f, 0.5f}, .color = {0.f, 0.f, 1.f}} //NOLINT
-    };
-    m_model = std::make_unique<VulkanMesh>(*m_device, vertices);
+    spdlog::info("rendering with {}", m_swapchain->usesDynamicRendering() ? "dynamic rendering" : "render pass objects");
+
+    m_meshletMode = resolveMeshletMode(meshletMode);
+    if(gpuDriven && !m_device->supportsDrawIndirectCount())
+    {
+        spdlog::warn("draw indirect count is not supported, culling objects on the CPU instead");
+        gpuDriven = false;
+    }
+
+    // NOTE: the GPU scene culls whole objects and draws them with a single indirect draw, meshlets are not needed
+    if(gpuDriven)
+        m_meshletMode = MeshletMode::DISABLED;
+
+    m_model = m_startupTimer.measure("mesh", [this, &meshPath] { return loadModel(meshPath); });
+    if(gpuDriven)
+        createGpuScene();
+
+    for(std::uint32_t i{ 0 }; i < OBJECT_COUNT; ++i)
+        m_cullingSet.add(m_model->getBounds());
+    spdlog::info("culling {} objects with {} lanes ({})", m_cullingSet.size(), CullingSet::SIMD_WIDTH, CullingSet::SIMD_NAME);
+
+    // NOTE: meshlets index into the index buffer, non indexed meshes are always drawn whole
+    if(m_meshletMode != MeshletMode::DISABLED && !m_model->hasMeshlets())
+        m_meshletMode = MeshletMode::DISABLED;
 
-    spdlog::info("allocated {} command buffers", m_commandBuffers.size());
+    if(m_meshletMode != MeshletMode::DISABLED)
+    {
+        m_meshletCuller = std::make_unique<VulkanMeshletCuller>(*m_device, *m_model, m_meshletMode, m_frameAllocator->getDescriptorSetLayoutHandle(), VulkanSwapchain::MAX_FRAMES_IN_FLIGHT);
+        if(m_meshletMode == MeshletMode::MESH_SHADER)
+            m_meshletPipeline = createMeshletPipeline();
+    }
+
+    m_device->getUploadScheduler().flush();
+
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    for(const auto& stage : m_startupTimer.getStages())
+        spdlog::info("startup: {} took {:.2f} ms", stage.name, Milliseconds{ stage.duration }.count());
+    spdlog::info("startup: renderer ready after {:.2f} ms", Milliseconds{ m_startupTimer.elapsed() }.count());
 }
 
 void VulkanRenderer::render()
 {
+    // NOTE: submit uploads recorded since the last frame before anything that reads them is submitted
+    m_device->getUploadScheduler().flush();
+    m_device->updateMemoryBudget();
+
     std::uint32_t imageIndex{};
     auto result{ m_swapchain->acquireNextImage(&imageIndex) };
 
@@ -65,8 +130,16 @@ void VulkanRenderer::render()
     if(result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::IMAGE_ACQUISITION);
 
-    recordCommandBuffers(imageIndex);
-    result = m_swapchain->submitCommandBuffer(&m_commandBuffers[imageIndex]->getHandle(), &imageIndex);
+    // NOTE: the fence of the current frame signaled in acquireNextImage, so its per frame data can be overwritten
+    m_frameAllocator->beginFrame(m_swapchain->getCurrentFrame());
+    m_frameContext->beginFrame(m_swapchain->getCurrentFrame());
+
+    const VkCommandBuffer commandBuffer{ recordCommandBuffers(imageIndex) };
+    result = m_swapchain->submitCommandBuffer(
+        &commandBuffer,
+        &imageIndex,
+        m_device->getUploadScheduler().getTimelineSemaphore(),
+        std::max(m_model->getUploadValue(), m_gpuScene != nullptr ? m_gpuScene->getUploadValue() : 0));
 
     if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || window.wasWindowResized())
     {
@@ -83,7 +156,47 @@ void VulkanRenderer::render()
 void VulkanRenderer::shutdown()
 {
     if(m_device)
+    {
         vkDeviceWaitIdle(m_device->getHandle());
+
+        const auto stats{ m_device->getAllocationStatistics() };
+        spdlog::info("device memory: {} block(s), {} dedicated allocation(s), {} allocation(s) using {} of {} bytes",
+                     stats.blockCount,
+                     stats.dedicatedAllocationCount,
+                     stats.allocationCount,
+                     stats.usedBytes,
+                     stats.blockBytes + stats.dedicatedBytes);
+
+        for(std::size_t i{ 0 }; i < MEMORY_CATEGORY_COUNT; ++i)
+        {
+            const auto category{ static_cast<MemoryCategory>(i) };
+            spdlog::info("\t{}: {} bytes", memoryCategoryToString(category), stats.bytesOf(category));
+        }
+
+        const auto budgets{ m_device->getMemoryBudget() };
+        for(std::size_t i{ 0 }; i < budgets.size(); ++i)
+            spdlog::info("\theap {}: {} of {} bytes budget used", i, budgets[i].usage, budgets[i].budget);
+
+        const auto cacheStats{ m_recorder->getCacheStatistics() };
+        spdlog::info("command cache: {} secondary command buffer(s) reused, {} recorded", cacheStats.hitCount, cacheStats.missCount);
+
+        const auto defragStats{ m_device->getDefragmenter().getStatistics() };
+        spdlog::info("defragmentation: {} pass(es) moved {} allocation(s) ({} bytes) and reclaimed {} bytes",
+                     defragStats.passCount,
+                     defragStats.movedAllocationCount,
+                     defragStats.movedBytes,
+                     defragStats.reclaimedBytes);
+    }
+}
+
+/**
+ *  Without a render pass the pipeline is created against the formats of the swapchain image and depth buffer instead.
+*/
+void VulkanRenderer::setRenderTargets(PipelineConfigInfo& configInfo) const
+{
+    configInfo.renderPass = m_swapchain->getRenderPassHandle();
+    configInfo.colorAttachmentFormat = m_swapchain->getImageFormat();
+    configInfo.depthAttachmentFormat = m_swapchain->getDepthFormat();
 }
 
 std::unique_ptr<VulkanPipeline> VulkanRenderer::createPipeline()
@@ -93,68 +206,330 @@ std::unique_ptr<VulkanPipeline> VulkanRenderer::createPipeline()
 
     PipelineConfigInfo pipelineConfig{};
     VulkanPipeline::defaultPipelineConfigInfo(pipelineConfig);
-    pipelineConfig.renderPass = m_swapchain->getRenderPassHandle();
+    setRenderTargets(pipelineConfig);
     pipelineConfig.pipelineLayout = m_pipelineLayout->getHandle();
     return std::make_unique<VulkanPipeline>(m_device->getHandle(), pipelineConfig, BASIC_VERT_SHADER_PATH, BASIC_FRAG_SHADER_PATH);
 }
 
-void VulkanRenderer::recreateSwapchain()
+/**
+ *  Pipeline that reads the transform and color of every instance from a second vertex buffer instead of the draw data.
+*/
+std::unique_ptr<VulkanPipeline> VulkanRenderer::createInstancedPipeline()
 {
-    auto extent{ window.getExtent() };
-    while(extent.height == 0 || extent.width == 0)
+    assert(m_swapchain != nullptr && "Cannot create pipeline before swapchain");
+    assert(m_pipelineLayout != nullptr && "cannot create pipeline before pipeline layout");
+
+    PipelineConfigInfo pipelineConfig{};
+    VulkanPipeline::defaultPipelineConfigInfo(pipelineConfig);
+    pipelineConfig.setVertexLayout<InstancedVertex>();
+    setRenderTargets(pipelineConfig);
+    pipelineConfig.pipelineLayout = m_pipelineLayout->getHandle();
+    return std::make_unique<VulkanPipeline>(m_device->getHandle(), pipelineConfig, INSTANCED_VERT_SHADER_PATH, INSTANCED_FRAG_SHADER_PATH);
+}
+
+/**
+ *  Mesh shading pipeline that draws meshlets without any vertex input, it shares the fragment shader with the regular
+ *  pipeline.
+*/
+std::unique_ptr<VulkanPipeline> VulkanRenderer::createMeshletPipeline()
+{
+    assert(m_meshletCuller != nullptr && "Cannot create meshlet pipeline before meshlet culler");
+
+    PipelineConfigInfo pipelineConfig{};
+    VulkanPipeline::defaultPipelineConfigInfo(pipelineConfig);
+    setRenderTargets(pipelineConfig);
+    pipelineConfig.pipelineLayout = m_meshletCuller->getPipelineLayoutHandle();
+
+    const std::array stages{
+        ShaderStageInfo{ .stage = VK_SHADER_STAGE_TASK_BIT_EXT, .path = VulkanMeshletCuller::MESHLET_TASK_SHADER_PATH },
+        ShaderStageInfo{ .stage = VK_SHADER_STAGE_MESH_BIT_EXT, .path = VulkanMeshletCuller::MESHLET_MESH_SHADER_PATH },
+        ShaderStageInfo{ .stage = VK_SHADER_STAGE_FRAGMENT_BIT, .path = BASIC_FRAG_SHADER_PATH }
+    };
+    return std::make_unique<VulkanPipeline>(m_device->getHandle(), pipelineConfig, stages);
+}
+
+MeshletMode VulkanRenderer::resolveMeshletMode(MeshletMode requested) const
+{
+    if(requested == MeshletMode::MESH_SHADER && !m_device->supportsMeshShaders())
     {
-        extent = window.getExtent();
-        glfwWaitEvents();
+        spdlog::warn("mesh shaders are not supported, culling meshlets in a compute pass instead");
+        requested = MeshletMode::COMPUTE;
+    }
+
+    if(requested == MeshletMode::COMPUTE && !m_device->supportsDrawIndirectCount())
+    {
+        spdlog::warn("draw indirect count is not supported, drawing without meshlets");
+        requested = MeshletMode::DISABLED;
     }
 
-    vkDeviceWaitIdle(m_device->getHandle());
+    return requested;
+}
 
-    if(m_swapchain == nullptr)
+/**
+ *  Static copies of the model at the positions the CPU path starts at, culled and drawn without any per frame work on
+ *  the CPU. All of them share the geometry of the model, so the whole scene is drawn after a single bind.
+*/
+void VulkanRenderer::createGpuScene()
+{
+    if(!m_model->isIndexed())
     {
-        m_swapchain = std::make_unique<VulkanSwapchain>(*m_device, m_surface->getHandle(), extent);
+        spdlog::warn("GPU driven rendering needs an indexed mesh, culling objects on the CPU instead");
+        return;
+    }
+
+    m_gpuScene = std::make_unique<VulkanGpuScene>(*m_device, m_frameAllocator->getDescriptorSetLayoutHandle(), VulkanSwapchain::MAX_FRAMES_IN_FLIGHT);
+    for(std::uint32_t object{ 0 }; object < OBJECT_COUNT; ++object)
+    {
+        const float y{ -0.4f + (static_cast<float>(object) * 0.25f) }; //NOLINT
+        const float blue{ 0.2f + (0.2f * static_cast<float>(object)) }; //NOLINT
+        m_gpuScene->add(*m_model, { .transform = { -0.5f, y, 0.f, 1.f }, .color = { 0.f, 0.f, blue, 1.f }, .payload = { 0.f, 0.f, 0.f, 0.f } }); //NOLINT
+    }
+    m_gpuScene->upload();
+}
+
+/**
+ *  Split the finest level of detail of <code>model<\code> into meshlets and upload them, if meshlets are drawn at all.
+*/
+void VulkanRenderer::uploadMeshlets(VulkanMesh& model, std::span<const std::byte> vertexData, std::span<const std::byte> indexData, VkIndexType indexType) const
+{
+    if(m_meshletMode == MeshletMode::DISABLED || !model.isIndexed())
+        return;
+
+    // NOTE: meshlet triangle offsets double as first indices of indirect draws, so the finest level has to start at 0
+    const auto& lod{ model.getLods().front() };
+    assert(lod.firstIndex == 0 && "The finest level of detail has to start at the first index");
+
+    std::vector<std::uint32_t> indices(lod.indexCount);
+    if(indexType == VK_INDEX_TYPE_UINT16)
+    {
+        const auto shortIndices{ std::span{ reinterpret_cast<const std::uint16_t*>(indexData.data()), lod.indexCount } };
+        std::ranges::copy(shortIndices, indices.begin());
     }
     else
     {
-        m_swapchain = std::make_unique<VulkanSwapchain>(*m_device, m_surface->getHandle(), extent, std::move(m_swapchain));
+        std::memcpy(indices.data(), indexData.data(), sizeof(std::uint32_t) * lod.indexCount);
+    }
+
+    const auto meshlets{ MeshletBuilder::build(vertexData, sizeof(Vertex), offsetof(Vertex, position), indices) };
+    spdlog::info("mesh split into {} meshlets of {:.1f} triangles on average",
+                 meshlets.meshlets.size(),
+                 static_cast<double>(lod.indexCount / 3) / static_cast<double>(meshlets.meshlets.size()));
+
+    model.setMeshlets(meshlets);
+}
 
-        if(m_swapchain->imageCount() != m_commandBuffers.size())
-            m_commandBuffers = m_commandPool->allocateCommandBuffer(m_swapchain->imageCount());
+/**
+ *  Load the mesh at <code>meshPath<\code>. Native mesh files are mapped and uploaded directly, any other format is
+ *  imported and optimized once and then cached as a native mesh file next to its source.
+*/
+std::unique_ptr<VulkanMesh> VulkanRenderer::loadModel(const std::filesystem::path& meshPath)
+{
+    const bool isMeshFile{ meshPath.extension() == MeshFile::EXTENSION };
+    const auto cachePath{ isMeshFile ? meshPath : MeshFile::cachePathFor(meshPath) };
+
+    std::error_code error;
+    const bool cacheUpToDate{ !meshPath.empty() && std::filesystem::exists(cachePath, error)
+                              && (isMeshFile || std::filesystem::last_write_time(cachePath, error) >= std::filesystem::last_write_time(meshPath, error)) };
+
+    if(isMeshFile || cacheUpToDate)
+    {
+        try
+        {
+            const MeshFile file{ cachePath };
+            spdlog::info("mapped {}: {} vertices, {} indices, {} levels of detail, {} bytes",
+                         cachePath.filename().string(),
+                         file.getVertexCount(),
+                         file.getIndexCount(),
+                         file.getLods().size(),
+                         file.getFileSize());
+
+            auto model{ std::make_unique<VulkanMesh>(*m_device, file.getVertexData(), file.getVertexCount(), file.getIndexData(), file.getIndexType(), file.getLods()) };
+            model->setBounds(file.getBounds());
+            uploadMeshlets(*model, file.getVertexData(), file.getIndexData(), file.getIndexType());
+
+            return model;
+        }
+        catch(const MeshImportException& ex)
+        {
+            if(isMeshFile)
+                throw;
+
+            spdlog::warn("ignoring outdated mesh cache: {}", ex.what());
+        }
+    }
+
+    MeshData mesh;
+    if(!meshPath.empty())
+    {
+        // NOTE: the worker threads are only needed while importing
+        MeshImporter importer;
+        mesh = importer.import(meshPath);
+    }
+    else
+    {
+        mesh.vertices = {
+            {.position = {0.f, -0.5f, 0.f}, .color = {1.f, 0.f, 0.f}}, //NOLINT
+            {.position = {0.5f, 0.5f, 0.f}, .color = {0.f, 1.f, 0.f}}, //NOLINT
+            {.position = {-0.5f, 0.5f, 0.f}, .color = {0.f, 0.f, 1.f}} //NOLINT
+        };
+    }
+
+    const auto optimization{ MeshOptimizer::optimize(mesh.vertices, mesh.indices, offsetof(Vertex, position), 3) };
+    spdlog::info("mesh optimized: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+                 optimization.vertexCountBefore,
+                 optimization.vertexCountAfter,
+                 optimization.before.acmr,
+                 optimization.after.acmr,
+                 optimization.before.atvr,
+                 optimization.after.atvr);
+
+    const SimplificationLayout layout{ .positionOffset = offsetof(Vertex, position), .attributeOffset = offsetof(Vertex, color), .attributeCount = 3 };
+    const auto lods{ MeshSimplifier::generateLods(mesh.vertices, mesh.indices, layout) };
+    for(std::size_t i{ 1 }; i < lods.size(); ++i)
+        spdlog::info("mesh LOD {}: {} triangles, error {:.5f}", i, lods[i].indexCount / 3, lods[i].error);
+
+    if(!meshPath.empty())
+    {
+        // NOTE: a missing cache only costs load time, e.g. in read only asset directories
+        try
+        {
+            MeshFile::write(cachePath, mesh.vertices, mesh.indices, lods);
+        }
+        catch(const std::exception& ex)
+        {
+            spdlog::warn("could not write mesh cache {}: {}", cachePath.string(), ex.what());
+        }
     }
 
-    m_pipeline = createPipeline();
+    auto model{ std::make_unique<VulkanMesh>(*m_device, mesh.vertices, mesh.indices, lods) };
+    model->setBounds(MeshBounds::compute(mesh.vertices));
+    uploadMeshlets(*model, std::as_bytes(std::span{ mesh.vertices }), std::as_bytes(std::span{ mesh.indices }), VK_INDEX_TYPE_UINT32);
+
+    return model;
 }
 
-void VulkanRenderer::recordCommandBuffers(std::size_t imageIndex)
+void VulkanRenderer::recreateSwapchain()
+{
+    auto extent{ window.getExtent() };
+    while(extent.height == 0 || extent.width == 0)
+    {
+        extent = window.getExtent();
+        glfwWaitEvents();
+    }
+
+    // NOTE: viewport and scissor are dynamic, so the pipeline only depends on the render pass or, with dynamic
+    //       rendering, on the attachment formats
+    if(m_swapchain->recreate(extent))
+    {
+        // NOTE: the surface format rarely changes, stalling once is cheaper than tracking pipelines in flight
+        vkDeviceWaitIdle(m_device->getHandle());
+        m_pipeline = createPipeline();
+        m_instancedPipeline = createInstancedPipeline();
+        if(m_meshletPipeline != nullptr)
+            m_meshletPipeline = createMeshletPipeline();
+
+        // NOTE: cached command buffers only know the pipelines by address, which new pipelines may reuse
+        m_recorder->invalidate();
+    }
+}
+
+VkCommandBuffer VulkanRenderer::recordCommandBuffers(std::size_t imageIndex)
 {
     static int frame{ 30 }; //NOLINT
     frame = (++frame) % 100; //NOLINT
 
+    // NOTE: command buffers belong to the frame in flight, whose fence signaled in acquireNextImage
+    const VkCommandBuffer commandBuffer{ m_frameContext->acquire() };
+
     VkCommandBufferBeginInfo beginInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     };
 
-    if(vkBeginCommandBuffer(m_commandBuffers.at(imageIndex)->getHandle(), &beginInfo) != VK_SUCCESS)
+    if(vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BEGIN_RECORD_COMMAND_BUFFER, imageIndex);
 
-    std::array<VkClearValue, 2> clearValues{
-        VkClearValue{ .color = CLEAR_COLOR },
-        VkClearValue{ .depthStencil = { 1.f, 0 } }
-    };
-    VkRenderPassBeginInfo renderPassBeginInfo{
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = m_swapchain->getRenderPassHandle(),
-        .framebuffer = m_swapchain->getFramebufferHandle(imageIndex),
-        .renderArea = {
-            .offset = { 0, 0 },
-            .extent = m_swapchain->getExtent()
-        },
-        .clearValueCount = static_cast<std::uint32_t>(clearValues.size()),
-        .pClearValues = clearValues.data()
+    // NOTE: copies are not allowed inside a render pass, so relocations are recorded before it begins
+    m_device->getDefragmenter().recordMoves(commandBuffer);
+    m_device->getGeometryPool().recordMoves(commandBuffer);
+
+    // NOTE: positions are used as normalized device coordinates, so the viewport shows two units vertically at any distance
+    const auto lodSelector{ LodSelector::orthographic(2.f, static_cast<float>(m_swapchain->getExtent().height), MAX_LOD_PIXEL_ERROR) };
+
+    struct MeshletDraw
+    {
+        std::uint32_t dynamicOffset;
+        std::uint32_t meshletDrawIndex;
     };
+    std::array<MeshletDraw, OBJECT_COUNT> meshletDraws{};
+    std::uint32_t meshletDrawCount{ 0 };
+
+    const auto objectOffset{ [](std::uint32_t object) { return glm::vec2{ -0.5f + (frame * 0.02f), -0.4f + (object * 0.25f) }; } }; //NOLINT
+
+    const VkDescriptorSet drawDataSet{ m_frameAllocator->getDescriptorSetHandle() };
+    if(m_gpuScene != nullptr)
+    {
+        // NOTE: the scene is culled into this frame's indirect commands, no object is visited on the CPU
+        const GpuCullData cullData{ .frustumPlanes = Frustum::ndc().planes, .objectCount = m_gpuScene->getObjectCount() };
+        m_gpuScene->cull(commandBuffer, drawDataSet, m_frameAllocator->pushUniform(cullData).dynamicOffset(), m_swapchain->getCurrentFrame());
+        m_visibleObjects.clear();
+    }
+    else
+    {
+        // NOTE: objects that leave the view volume are neither written to the frame allocator nor recorded
+        for(std::uint32_t object{ 0 }; object < OBJECT_COUNT; ++object)
+        {
+            const auto offset{ objectOffset(object) };
+            m_cullingSet.setTransform(object, { offset.x, offset.y, 0.f });
+        }
+        m_cullingSet.cull(Frustum::ndc(), m_visibleObjects);
+    }
+
+    // NOTE: draw data is written up front, meshlets of a draw are culled before the render pass begins
+    if(m_meshletCuller != nullptr)
+        m_meshletCuller->beginFrame(commandBuffer, m_swapchain->getCurrentFrame());
 
-    vkCmdBeginRenderPass(m_commandBuffers[imageIndex]->getHandle(), &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    for(const std::uint32_t object : m_visibleObjects)
+    {
+        const auto offset{ objectOffset(object) };
+        const float blue{ 0.2f + (0.2f * static_cast<float>(object)) }; //NOLINT
+        const std::size_t lod{ lodSelector.select(m_model->getLods(), 0.f) };
+
+        // NOTE: meshlets only exist for the finest level, coarser levels are cheap enough to draw whole
+        const bool meshlets{ m_meshletCuller != nullptr && lod == 0 && meshletDrawCount < m_meshletCuller->getMaxDraws() };
+        if(!meshlets)
+        {
+            const InstanceData instance{ .transform = { offset.x, offset.y, 0.f, 1.f }, .color = { 0.f, 0.f, blue, 1.f }, .payload = { 0.f, 0.f, 0.f, 0.f } };
+            m_drawBatcher.submit(*m_instancedPipeline, *m_model, instance, lod);
+            continue;
+        }
+
+        // NOTE: there is no camera yet and the pipeline culls no faces, so only the view volume of the NDC box is tested
+        auto& draw{ meshletDraws[meshletDrawCount] };
+        draw.meshletDrawIndex = meshletDrawCount++;
+        const MeshletDrawData meshletDrawData{
+            .draw = { .offset = offset, .color = { 0.f, 0.f, blue } },
+            .cull = {
+                .frustumPlanes = Frustum::ndc().planes,
+                .camera = { 0.f, 0.f, 1.f, 0.f },
+                .translation = { offset.x, offset.y, 0.f, 0.f },
+                .meshletCount = m_model->getMeshletCount(),
+                .drawIndex = draw.meshletDrawIndex,
+                .coneCulling = 0,
+                .firstIndex = m_model->getFirstIndex(),
+                .vertexOffset = static_cast<std::int32_t>(m_model->getFirstVertex())
+            }
+        };
+        draw.dynamicOffset = m_frameAllocator->pushUniform(meshletDrawData).dynamicOffset();
+
+        if(m_meshletMode == MeshletMode::COMPUTE)
+            m_meshletCuller->cull(commandBuffer, drawDataSet, draw.dynamicOffset, draw.meshletDrawIndex);
+    }
 
-    VkViewport viewport{
+    if(m_meshletCuller != nullptr)
+        m_meshletCuller->endCulling(commandBuffer);
+
+    const VkViewport viewport{
         .x = 0,
         .y = 0,
         .width = static_cast<float>(m_swapchain->getExtent().width),
@@ -162,32 +537,123 @@ void VulkanRenderer::recordCommandBuffers(std::size_t imageIndex)
         .minDepth = 0.f,
         .maxDepth = 1.f
     };
-    vkCmdSetViewport(m_commandBuffers[imageIndex]->getHandle(), 0, 1, &viewport);
-
-    VkRect2D scissor{
+    const VkRect2D scissor{
         { 0, 0 },
         m_swapchain->getExtent()
     };
-    vkCmdSetScissor(m_commandBuffers[imageIndex]->getHandle(), 0, 1, &scissor);
 
-    m_pipeline->bind(m_commandBuffers[imageIndex]->getHandle());
-    m_model->bind(m_commandBuffers[imageIndex]->getHandle());
+    // NOTE: secondary command buffers inherit no state, every one of them sets the dynamic state itself
+    const auto setDynamicState{ [&viewport, &scissor](VkCommandBuffer cmdBuffer) {
+        vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+    } };
 
-    for(int i{ 0 }; i < 4; ++i)
+    if(m_swapchain->usesDynamicRendering())
+        m_recorder->beginFrame(m_swapchain->getCurrentFrame(), m_swapchain->getImageFormat(), m_swapchain->getDepthFormat());
+    else
+        m_recorder->beginFrame(m_swapchain->getCurrentFrame(), m_swapchain->getRenderPassHandle(), m_swapchain->getFramebufferHandle(imageIndex));
+
+    // NOTE: objects that share pipeline, mesh and level of detail become a single instanced draw, and meshes share the
+    //       buffers of the geometry pool, so only the first draw out of a pool block binds them. The draws are split
+    //       into chunks that are recorded on the worker threads of the recorder, chunks that did not change since
+    //       this frame in flight recorded them are reused. Moving objects only change their instance data, so the
+    //       commands of a scene stay the same until objects enter or leave the view or change their level of detail
+    const std::size_t batchedDrawCount{ m_drawBatcher.prepare(*m_frameAllocator) };
+    m_recorder->recordParallelCached(
+        BATCHED_DRAWS,
+        batchedDrawCount,
+        MIN_DRAWS_PER_CHUNK,
+        [this, &viewport, &scissor](std::size_t first, std::size_t last) { return Hasher{}.add(viewport).add(scissor).add(m_drawBatcher.hashDraws(first, last)).value(); },
+        [this, &setDynamicState](VkCommandBuffer cmdBuffer, std::size_t first, std::size_t last) {
+            setDynamicState(cmdBuffer);
+            GeometryBindState boundGeometry{};
+            m_drawBatcher.recordDraws(cmdBuffer, first, last, boundGeometry);
+        });
+
+    // NOTE: the GPU scene only reads buffers of this frame in flight, its commands only change with the object count
+    if(m_gpuScene != nullptr)
     {
-        SimplePushConstantData pushData{
-            .offset = { -0.5f + (frame * 0.02f), -0.4f + (i * 0.25f) }, //NOLINT
-            .color = { 0.f, 0.f, 0.2f + (0.2f * i) } //NOLINT
-        };
+        const std::uint64_t sceneHash{ Hasher{}
+                                           .add(viewport)
+                                           .add(scissor)
+                                           .add(m_instancedPipeline.get())
+                                           .add(m_gpuScene->getObjectCount())
+                                           .add(m_model->getVertexBufferHandle())
+                                           .add(m_model->getIndexBufferHandle())
+                                           .value() };
+        m_recorder->recordCached(GPU_SCENE_DRAWS, sceneHash, [this, &setDynamicState](VkCommandBuffer cmdBuffer) {
+            setDynamicState(cmdBuffer);
+            GeometryBindState boundGeometry{};
+            m_instancedPipeline->bind(cmdBuffer);
+            m_gpuScene->draw(cmdBuffer, boundGeometry);
+        });
+    }
 
-        vkCmdPushConstants(m_commandBuffers[imageIndex]->getHandle(), m_pipelineLayout->getHandle(), VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(SimplePushConstantData), &pushData);
-        m_model->draw(m_commandBuffers[imageIndex]->getHandle());
+    // NOTE: the meshlet culler rewrites its descriptor sets every frame, which invalidates any command buffer that
+    //       bound them, so meshlet draws are always recorded again. They are a handful of commands
+    if(meshletDrawCount > 0)
+    {
+        m_recorder->record([&](VkCommandBuffer cmdBuffer) {
+            setDynamicState(cmdBuffer);
+            GeometryBindState boundGeometry{};
+
+            VulkanPipeline* boundPipeline{ nullptr };
+            for(const auto& draw : std::span{ meshletDraws }.first(meshletDrawCount))
+            {
+                const bool meshShading{ m_meshletMode == MeshletMode::MESH_SHADER };
+                VulkanPipeline* const pipeline{ meshShading ? m_meshletPipeline.get() : m_pipeline.get() };
+                if(pipeline != boundPipeline)
+                {
+                    pipeline->bind(cmdBuffer);
+                    boundPipeline = pipeline;
+                }
+
+                if(meshShading)
+                {
+                    m_meshletCuller->drawMeshTasks(cmdBuffer, drawDataSet, draw.dynamicOffset);
+                    continue;
+                }
+
+                m_model->bind(cmdBuffer, boundGeometry);
+                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout->getHandle(), 0, 1, &drawDataSet, 1, &draw.dynamicOffset);
+                m_meshletCuller->drawIndirect(cmdBuffer, draw.meshletDrawIndex);
+            }
+        });
     }
 
-    vkCmdEndRenderPass(m_commandBuffers[imageIndex]->getHandle());
+    if(m_swapchain->usesDynamicRendering())
+    {
+        m_swapchain->beginRendering(commandBuffer, imageIndex, CLEAR_COLOR, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+        m_recorder->execute(commandBuffer);
+        m_swapchain->endRendering(commandBuffer, imageIndex);
+    }
+    else
+    {
+        std::array<VkClearValue, 2> clearValues{
+            VkClearValue{ .color = CLEAR_COLOR },
+            VkClearValue{ .depthStencil = { 1.f, 0 } }
+        };
+        VkRenderPassBeginInfo renderPassBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = m_swapchain->getRenderPassHandle(),
+            .framebuffer = m_swapchain->getFramebufferHandle(imageIndex),
+            .renderArea = {
+                .offset = { 0, 0 },
+                .extent = m_swapchain->getExtent()
+            },
+            .clearValueCount = static_cast<std::uint32_t>(clearValues.size()),
+            .pClearValues = clearValues.data()
+        };
 
-    if(vkEndCommandBuffer(m_commandBuffers[imageIndex]->getHandle()) != VK_SUCCESS)
+        vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        m_recorder->execute(commandBuffer);
+        vkCmdEndRenderPass(commandBuffer);
+    }
+
+    if(vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::END_RECORD_COMMAND_BUFFER, imageIndex);
+
+    return commandBuffer;
 }
 
 }
@@ -2,22 +2,31 @@
 #define RRENDERER_ENGINE_VULKAN_RENDERER_HPP
 
 #include "Renderer.hpp"
-#include "core/VulkanCommandBuffer.hpp"
-#include "core/VulkanCommandPool.hpp"
 #include "core/VulkanDebugMessenger.hpp"
 #include "core/VulkanDevice.hpp"
+#include "core/VulkanDrawBatcher.hpp"
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanFrameContext.hpp"
+#include "core/VulkanGpuScene.hpp"
 #include "core/VulkanInstance.hpp"
 #include "core/VulkanMesh.hpp"
+#include "core/VulkanMeshletCuller.hpp"
+#include "core/VulkanParallelRecorder.hpp"
 #include "core/VulkanPipeline.hpp"
 #include "core/VulkanPipelineLayout.hpp"
 #include "core/VulkanSurface.hpp"
 #include "core/VulkanSwapchain.hpp"
+#include "scene/CullingSet.hpp"
+#include "utility/StartupTimer.hpp"
 #include "window/Window.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -33,7 +42,13 @@ namespace rr
 class VulkanRenderer : public Renderer
 {
 public:
-    explicit VulkanRenderer(Window& window);
+    /**
+     *  Without a <code>meshPath<\code> a single triangle is rendered. A <code>meshletMode<\code> the device does not
+     *  support falls back to the next simpler one. With <code>gpuDriven<\code> the objects are culled and drawn from a
+     *  <code>VulkanGpuScene<\code> instead, which replaces meshlets when the device and mesh allow it. Frames are
+     *  rendered with dynamic rendering whenever the device supports it and with render pass objects otherwise.
+    */
+    explicit VulkanRenderer(Window& window, const std::filesystem::path& meshPath = {}, MeshletMode meshletMode = MeshletMode::DISABLED, bool gpuDriven = false);
     ~VulkanRenderer() override = default;
 
     VulkanRenderer(const VulkanRenderer&) = delete;
@@ -47,26 +62,61 @@ public:
 private:
     Window& window;
 
+    // NOTE: has to be initialized before everything it measures
+    StartupTimer m_startupTimer;
+
     //NOTE: Order here matters in orer for the right order of dstructions to work and not interfere with vulkan objects
-    std::unique_ptr<VulkanInstance> m_instance{ std::make_unique<VulkanInstance>() };
+    std::unique_ptr<VulkanInstance> m_instance{ m_startupTimer.measure("instance", [] { return std::make_unique<VulkanInstance>(); }) };
     std::unique_ptr<VulkanDebugMessenger> m_debugMessenger;
     std::unique_ptr<VulkanSurface> m_surface;
     std::unique_ptr<VulkanDevice> m_device;
     std::unique_ptr<VulkanSwapchain> m_swapchain;
+    std::unique_ptr<VulkanFrameAllocator> m_frameAllocator;
     std::unique_ptr<VulkanPipelineLayout> m_pipelineLayout;
     std::unique_ptr<VulkanPipeline> m_pipeline;
-    std::unique_ptr<VulkanCommandPool> m_commandPool;
-    std::vector<std::unique_ptr<VulkanCommandBuffer>> m_commandBuffers;
+    std::unique_ptr<VulkanPipeline> m_instancedPipeline;
+    std::unique_ptr<VulkanFrameContext> m_frameContext;
+    std::unique_ptr<VulkanParallelRecorder> m_recorder;
+    MeshletMode m_meshletMode{ MeshletMode::DISABLED };
     std::unique_ptr<VulkanMesh> m_model;
+    std::unique_ptr<VulkanMeshletCuller> m_meshletCuller;
+    std::unique_ptr<VulkanGpuScene> m_gpuScene;
+    std::unique_ptr<VulkanPipeline> m_meshletPipeline;
+    CullingSet m_cullingSet;
+    VulkanDrawBatcher m_drawBatcher;
+    std::vector<std::uint32_t> m_visibleObjects;
+
+    /** Call sites of cached secondary command buffers */
+    enum RecordSite : std::uint32_t
+    {
+        BATCHED_DRAWS,
+        GPU_SCENE_DRAWS
+    };
 
     static constexpr VkClearColorValue CLEAR_COLOR{ 0.01f, 0.01f, 0.01f, 1.f };
+    /** Level of detail is reduced as long as the simplification error stays below this many pixels */
+    static constexpr float MAX_LOD_PIXEL_ERROR{ 1.f };
+    /** Copies of the model drawn every frame */
+    static constexpr std::uint32_t OBJECT_COUNT{ 4 };
+    /** Fewer batched draws than this are not worth handing to another thread */
+    static constexpr std::size_t MIN_DRAWS_PER_CHUNK{ 64 };
     static constexpr std::string_view BASIC_VERT_SHADER_PATH{ "./shaders/basic.vert.spv" };
     static constexpr std::string_view BASIC_FRAG_SHADER_PATH{ "./shaders/basic.frag.spv" };
+    static constexpr std::string_view INSTANCED_VERT_SHADER_PATH{ "./shaders/instanced.vert.spv" };
+    static constexpr std::string_view INSTANCED_FRAG_SHADER_PATH{ "./shaders/instanced.frag.spv" };
     
+    void setRenderTargets(PipelineConfigInfo& configInfo) const;
     [[nodiscard]] std::unique_ptr<VulkanPipeline> createPipeline();
+    [[nodiscard]] std::unique_ptr<VulkanPipeline> createInstancedPipeline();
+    [[nodiscard]] std::unique_ptr<VulkanPipeline> createMeshletPipeline();
+    [[nodiscard]] std::unique_ptr<VulkanMesh> loadModel(const std::filesystem::path& meshPath);
+    [[nodiscard]] MeshletMode resolveMeshletMode(MeshletMode requested) const;
+    void createGpuScene();
+    void uploadMeshlets(VulkanMesh& model, std::span<const std::byte> vertexData, std::span<const std::byte> indexData, VkIndexType indexType) const;
 
     void recreateSwapchain();
-    void recordCommandBuffers(std::size_t imageIndex);
+    /** Record the frame into a command buffer of the current frame context and return it for submission */
+    [[nodiscard]] VkCommandBuffer recordCommandBuffers(std::size_t imageIndex);
 };
 
 } // !rr
@@ -0,0 +1,357 @@
+#include "VulkanAllocator.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "utility/FreeListAllocator.hpp"
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace rr
+{
+
+VulkanAllocator::VulkanAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties)
+    : device(device)
+    , memoryProperties(memoryProperties)
+{}
+
+VulkanAllocator::~VulkanAllocator()
+{
+    for(const auto& block : m_blocks)
+    {
+        if(!block->allocator.empty())
+            spdlog::warn("Memory block of type {} still holds {} allocation(s) on destruction", block->memoryTypeIndex, block->allocator.allocationCount());
+
+        freeDeviceMemory(block->memory, block->allocator.size(), block->memoryTypeIndex);
+    }
+
+    if(m_dedicatedAllocationCount > 0)
+        spdlog::warn("{} dedicated allocation(s) were not freed", m_dedicatedAllocationCount);
+}
+
+/**
+ *  Find space for a resource with the given requirements.
+ *
+ *  @param requirements - size, alignment and allowed memory types of the resource
+ *  @param memoryTypeIndex - memory type the resource is going to be placed in
+ *  @param kind - whether the resource is a buffer/linear image or an optimally tiled image
+ *  @param category - what the memory is used for, only used for statistics
+ *  @returns VulkanAllocation - memory handle and offset the resource can be bound at
+*/
+VulkanAllocation VulkanAllocator::allocate(const VkMemoryRequirements& requirements, std::uint32_t memoryTypeIndex, AllocationKind kind, MemoryCategory category)
+{
+    std::lock_guard lock{ m_mutex };
+
+    // NOTE: category bytes are only counted once the allocation succeeded, both paths below can throw
+    const VkDeviceSize blockSize{ blockSizeFor(memoryTypeIndex) };
+
+    if(requirements.size > blockSize / 2)
+    {
+        VulkanAllocation allocation{
+            .memory = VK_NULL_HANDLE,
+            .offset = 0,
+            .size = requirements.size,
+            .mappedData = nullptr,
+            .memoryTypeIndex = memoryTypeIndex,
+            .category = category,
+            .block = nullptr
+        };
+        allocation.memory = allocateDeviceMemory(requirements.size, memoryTypeIndex, &allocation.mappedData);
+
+        ++m_dedicatedAllocationCount;
+        m_dedicatedBytes += requirements.size;
+        m_categoryBytes[static_cast<std::size_t>(category)] += requirements.size;
+
+        return allocation;
+    }
+
+    VulkanMemoryBlock* target{ nullptr };
+    std::optional<std::uint64_t> offset;
+
+    for(const auto& block : m_blocks)
+    {
+        if(block->memoryTypeIndex != memoryTypeIndex || block->kind != kind)
+            continue;
+
+        offset = block->allocator.allocate(requirements.size, requirements.alignment);
+        if(offset.has_value())
+        {
+            target = block.get();
+            break;
+        }
+    }
+
+    if(target == nullptr)
+    {
+        target = &createBlock(memoryTypeIndex, kind);
+        offset = target->allocator.allocate(requirements.size, requirements.alignment);
+
+        if(!offset.has_value())
+            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_MEMORY);
+    }
+
+    m_categoryBytes[static_cast<std::size_t>(category)] += requirements.size;
+
+    return makeAllocation(*target, offset.value(), requirements.size, category);
+}
+
+/**
+ *  Place a resource in an existing block that is not in <code>excluded<\code>. Fuller blocks are tried first so
+ *  relocated resources get packed together. No new device memory is allocated.
+ *
+ *  @returns std::optional<VulkanAllocation> - empty if none of the blocks has enough space
+*/
+std::optional<VulkanAllocation> VulkanAllocator::allocateInExistingBlock(
+    const VkMemoryRequirements& requirements,
+    std::uint32_t memoryTypeIndex,
+    AllocationKind kind,
+    MemoryCategory category,
+    const std::vector<const VulkanMemoryBlock*>& excluded)
+{
+    std::lock_guard lock{ m_mutex };
+
+    std::vector<VulkanMemoryBlock*> candidates;
+    for(const auto& block : m_blocks)
+    {
+        if(block->memoryTypeIndex == memoryTypeIndex && block->kind == kind && std::ranges::find(excluded, block.get()) == excluded.end())
+            candidates.push_back(block.get());
+    }
+
+    std::ranges::sort(candidates, std::greater{}, [](const auto* block) { return block->allocator.usedSize(); });
+
+    for(auto* const block : candidates)
+    {
+        const auto offset{ block->allocator.allocate(requirements.size, requirements.alignment) };
+        if(!offset.has_value())
+            continue;
+
+        m_categoryBytes[static_cast<std::size_t>(category)] += requirements.size;
+
+        return makeAllocation(*block, offset.value(), requirements.size, category);
+    }
+
+    return std::nullopt;
+}
+
+/**
+ *  Give the memory of <code>allocation<\code> back. The allocation is reset afterwards.
+*/
+void VulkanAllocator::free(VulkanAllocation& allocation)
+{
+    if(!allocation.isValid())
+        return;
+
+    std::lock_guard lock{ m_mutex };
+
+    m_categoryBytes[static_cast<std::size_t>(allocation.category)] -= allocation.size;
+
+    if(allocation.isDedicated())
+    {
+        freeDeviceMemory(allocation.memory, allocation.size, allocation.memoryTypeIndex);
+
+        --m_dedicatedAllocationCount;
+        m_dedicatedBytes -= allocation.size;
+    }
+    else
+    {
+        allocation.block->allocator.free(allocation.offset);
+
+        if(allocation.block->allocator.empty())
+            releaseEmptyBlock(allocation.block);
+    }
+
+    allocation = {};
+}
+
+/**
+ *  Free every block that does not hold any allocation, including the one that is usually kept around.
+ *
+ *  @param heapIndex - only free blocks in this heap, all heaps without it
+ *  @returns VkDeviceSize - amount of device memory that was given back
+*/
+VkDeviceSize VulkanAllocator::releaseEmptyBlocks(std::optional<std::uint32_t> heapIndex)
+{
+    std::lock_guard lock{ m_mutex };
+
+    const auto releasable{ [this, heapIndex](const auto& block) {
+        return block->allocator.empty() && (!heapIndex.has_value() || heapIndexOf(block->memoryTypeIndex) == heapIndex.value());
+    } };
+
+    VkDeviceSize released{ 0 };
+    for(const auto& block : m_blocks)
+    {
+        if(!releasable(block))
+            continue;
+
+        released += block->allocator.size();
+        freeDeviceMemory(block->memory, block->allocator.size(), block->memoryTypeIndex);
+    }
+
+    std::erase_if(m_blocks, releasable);
+
+    return released;
+}
+
+AllocationStatistics VulkanAllocator::getStatistics() const
+{
+    std::lock_guard lock{ m_mutex };
+
+    AllocationStatistics stats{
+        .blockCount = m_blocks.size(),
+        .dedicatedAllocationCount = m_dedicatedAllocationCount,
+        .allocationCount = m_dedicatedAllocationCount,
+        .blockBytes = 0,
+        .dedicatedBytes = m_dedicatedBytes,
+        .usedBytes = m_dedicatedBytes,
+        .categoryBytes = m_categoryBytes
+    };
+
+    for(const auto& block : m_blocks)
+    {
+        stats.allocationCount += block->allocator.allocationCount();
+        stats.blockBytes += block->allocator.size();
+        stats.usedBytes += block->allocator.usedSize();
+    }
+
+    return stats;
+}
+
+std::vector<MemoryBlockInfo> VulkanAllocator::getBlockInfos() const
+{
+    std::lock_guard lock{ m_mutex };
+
+    std::vector<MemoryBlockInfo> infos;
+    infos.reserve(m_blocks.size());
+
+    for(const auto& block : m_blocks)
+    {
+        infos.push_back({
+            .block = block.get(),
+            .id = block->id,
+            .memoryTypeIndex = block->memoryTypeIndex,
+            .kind = block->kind,
+            .size = block->allocator.size(),
+            .usedSize = block->allocator.usedSize()
+        });
+    }
+
+    return infos;
+}
+
+/**
+ *  @returns VkDeviceSize - bytes of <code>VkDeviceMemory<\code> this allocator holds in the heap
+*/
+VkDeviceSize VulkanAllocator::getHeapUsage(std::uint32_t heapIndex) const
+{
+    std::lock_guard lock{ m_mutex };
+
+    return m_heapBytes.at(heapIndex);
+}
+
+/**
+ *  Blocks take up at most an eighth of their heap so small heaps (e.g. the 256MiB BAR heap) are not exhausted
+ *  by a single block.
+*/
+VkDeviceSize VulkanAllocator::blockSizeFor(std::uint32_t memoryTypeIndex) const
+{
+    const auto heapIndex{ heapIndexOf(memoryTypeIndex) };
+    const VkDeviceSize heapSize{ memoryProperties.memoryHeaps[heapIndex].size };
+
+    return std::min(DEFAULT_BLOCK_SIZE, heapSize / 8);
+}
+
+VulkanMemoryBlock& VulkanAllocator::createBlock(std::uint32_t memoryTypeIndex, AllocationKind kind)
+{
+    const VkDeviceSize blockSize{ blockSizeFor(memoryTypeIndex) };
+
+    void* mappedData{ nullptr };
+    VkDeviceMemory memory{ allocateDeviceMemory(blockSize, memoryTypeIndex, &mappedData) };
+
+    m_blocks.push_back(std::make_unique<VulkanMemoryBlock>(VulkanMemoryBlock{
+        .id = m_nextBlockId++,
+        .memory = memory,
+        .mappedData = mappedData,
+        .memoryTypeIndex = memoryTypeIndex,
+        .kind = kind,
+        .allocator = FreeListAllocator(blockSize)
+    }));
+
+    spdlog::info("Allocated memory block #{} ({} bytes, memory type {})", m_blocks.size() - 1, blockSize, memoryTypeIndex);
+
+    return *m_blocks.back();
+}
+
+VulkanAllocation VulkanAllocator::makeAllocation(VulkanMemoryBlock& block, VkDeviceSize offset, VkDeviceSize size, MemoryCategory category)
+{
+    return {
+        .memory = block.memory,
+        .offset = offset,
+        .size = size,
+        .mappedData = block.mappedData == nullptr ? nullptr : static_cast<std::byte*>(block.mappedData) + offset,
+        .memoryTypeIndex = block.memoryTypeIndex,
+        .category = category,
+        .block = &block
+    };
+}
+
+VkDeviceMemory VulkanAllocator::allocateDeviceMemory(VkDeviceSize size, std::uint32_t memoryTypeIndex, void** mappedData)
+{
+    VkMemoryAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = size,
+        .memoryTypeIndex = memoryTypeIndex
+    };
+
+    VkDeviceMemory memory{ VK_NULL_HANDLE };
+    if(vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_MEMORY);
+
+    *mappedData = nullptr;
+    if(static_cast<bool>(memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+    {
+        if(vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, mappedData) != VK_SUCCESS)
+        {
+            vkFreeMemory(device, memory, nullptr);
+            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::MAP_MEMORY);
+        }
+    }
+
+    // NOTE: only counted once the memory is usable, so a failed map does not leave the heap usage inflated
+    m_heapBytes[heapIndexOf(memoryTypeIndex)] += size;
+
+    return memory;
+}
+
+void VulkanAllocator::freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, std::uint32_t memoryTypeIndex)
+{
+    vkFreeMemory(device, memory, nullptr);
+    m_heapBytes[heapIndexOf(memoryTypeIndex)] -= size;
+}
+
+/**
+ *  Free a block that no longer holds any allocation. One empty block per memory type and kind is kept around so
+ *  that creating and destroying a single resource in a loop does not hit the driver every time.
+*/
+void VulkanAllocator::releaseEmptyBlock(VulkanMemoryBlock* block)
+{
+    const auto hasOtherEmptyBlock{ std::ranges::any_of(m_blocks, [block](const auto& other) {
+        return other.get() != block && other->memoryTypeIndex == block->memoryTypeIndex && other->kind == block->kind && other->allocator.empty();
+    }) };
+
+    if(!hasOtherEmptyBlock)
+        return;
+
+    freeDeviceMemory(block->memory, block->allocator.size(), block->memoryTypeIndex);
+    std::erase_if(m_blocks, [block](const auto& other) { return other.get() == block; });
+}
+
+} // !rr
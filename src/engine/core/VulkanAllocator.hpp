@@ -0,0 +1,173 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_ALLOCATOR_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_ALLOCATOR_HPP
+
+#include "utility/FreeListAllocator.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Buffers and linear images may not share a <code>bufferImageGranularity<\code> page with optimally tiled images.
+ *  Instead of padding every sub-allocation the allocator keeps both kinds in separate blocks.
+*/
+enum class AllocationKind : std::uint8_t
+{
+    LINEAR,
+    OPTIMAL
+};
+
+/**
+ *  What a piece of memory is used for. Usage is tracked per category so memory pressure can be attributed.
+*/
+enum class MemoryCategory : std::uint8_t
+{
+    MESH,
+    DEPTH,
+    STAGING,
+    TEXTURE,
+    OTHER,
+    COUNT
+};
+
+constexpr std::size_t MEMORY_CATEGORY_COUNT{ static_cast<std::size_t>(MemoryCategory::COUNT) };
+
+constexpr const char* memoryCategoryToString(MemoryCategory category)
+{
+    switch(category)
+    {
+        using enum MemoryCategory;
+
+        case MESH: return "mesh";
+        case DEPTH: return "depth";
+        case STAGING: return "staging";
+        case TEXTURE: return "texture";
+        default: return "other";
+    }
+}
+
+struct VulkanMemoryBlock;
+
+/**
+ *  Handle to a piece of device memory handed out by the <code>VulkanAllocator<\code>. Resources are bound to
+ *  <code>memory<\code> at <code>offset<\code>.
+*/
+struct VulkanAllocation
+{
+    VkDeviceMemory memory{ VK_NULL_HANDLE };
+    VkDeviceSize offset{ 0 };
+    VkDeviceSize size{ 0 };
+    void* mappedData{ nullptr };
+    std::uint32_t memoryTypeIndex{ 0 };
+    MemoryCategory category{ MemoryCategory::OTHER };
+    VulkanMemoryBlock* block{ nullptr };
+
+    [[nodiscard]] bool isValid() const { return memory != VK_NULL_HANDLE; }
+    [[nodiscard]] bool isDedicated() const { return block == nullptr; }
+};
+
+struct AllocationStatistics
+{
+    std::size_t blockCount{ 0 };
+    std::size_t dedicatedAllocationCount{ 0 };
+    std::size_t allocationCount{ 0 };
+    VkDeviceSize blockBytes{ 0 };
+    VkDeviceSize dedicatedBytes{ 0 };
+    VkDeviceSize usedBytes{ 0 };
+    std::array<VkDeviceSize, MEMORY_CATEGORY_COUNT> categoryBytes{};
+
+    [[nodiscard]] VkDeviceSize bytesOf(MemoryCategory category) const { return categoryBytes[static_cast<std::size_t>(category)]; }
+
+    /** Number of live <code>VkDeviceMemory<\code> objects */
+    [[nodiscard]] std::size_t deviceMemoryCount() const { return blockCount + dedicatedAllocationCount; }
+};
+
+struct MemoryBlockInfo
+{
+    const VulkanMemoryBlock* block{ nullptr };
+    std::uint64_t id{ 0 };
+    std::uint32_t memoryTypeIndex{ 0 };
+    AllocationKind kind{ AllocationKind::LINEAR };
+    VkDeviceSize size{ 0 };
+    VkDeviceSize usedSize{ 0 };
+};
+
+struct VulkanMemoryBlock
+{
+    /** Unique for the lifetime of the allocator, unlike the address of the block */
+    std::uint64_t id{ 0 };
+    VkDeviceMemory memory{ VK_NULL_HANDLE };
+    void* mappedData{ nullptr };
+    std::uint32_t memoryTypeIndex{ 0 };
+    AllocationKind kind{ AllocationKind::LINEAR };
+    FreeListAllocator allocator;
+};
+
+/**
+ *  <code>VulkanAllocator<\code> sub-allocates device memory out of large per-memory-type blocks so that a resource
+ *  does not cost a whole <code>vkAllocateMemory<\code>. Host visible blocks are mapped once on creation and stay
+ *  mapped for their entire lifetime. Resources that would take up a big part of a block get a dedicated allocation.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanAllocator
+{
+public:
+    VulkanAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties);
+    ~VulkanAllocator();
+
+    VulkanAllocator(const VulkanAllocator&) = delete;
+    VulkanAllocator(VulkanAllocator&&) = delete;
+    VulkanAllocator& operator=(const VulkanAllocator&) = delete;
+    VulkanAllocator& operator=(VulkanAllocator&&) = delete;
+
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE{ 64ULL * 1024 * 1024 };
+
+    [[nodiscard]] VulkanAllocation allocate(const VkMemoryRequirements& requirements, std::uint32_t memoryTypeIndex, AllocationKind kind, MemoryCategory category);
+    [[nodiscard]] std::optional<VulkanAllocation> allocateInExistingBlock(
+        const VkMemoryRequirements& requirements,
+        std::uint32_t memoryTypeIndex,
+        AllocationKind kind,
+        MemoryCategory category,
+        const std::vector<const VulkanMemoryBlock*>& excluded);
+    void free(VulkanAllocation& allocation);
+    VkDeviceSize releaseEmptyBlocks(std::optional<std::uint32_t> heapIndex = std::nullopt);
+
+    [[nodiscard]] AllocationStatistics getStatistics() const;
+    [[nodiscard]] std::vector<MemoryBlockInfo> getBlockInfos() const;
+    [[nodiscard]] VkDeviceSize getHeapUsage(std::uint32_t heapIndex) const;
+
+private:
+    VkDevice device;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<VulkanMemoryBlock>> m_blocks;
+    std::uint64_t m_nextBlockId{ 0 };
+    std::size_t m_dedicatedAllocationCount{ 0 };
+    VkDeviceSize m_dedicatedBytes{ 0 };
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> m_heapBytes{};
+    std::array<VkDeviceSize, MEMORY_CATEGORY_COUNT> m_categoryBytes{};
+
+    [[nodiscard]] VkDeviceSize blockSizeFor(std::uint32_t memoryTypeIndex) const;
+    [[nodiscard]] VulkanMemoryBlock& createBlock(std::uint32_t memoryTypeIndex, AllocationKind kind);
+    [[nodiscard]] static VulkanAllocation makeAllocation(VulkanMemoryBlock& block, VkDeviceSize offset, VkDeviceSize size, MemoryCategory category);
+    [[nodiscard]] VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, std::uint32_t memoryTypeIndex, void** mappedData);
+    void freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, std::uint32_t memoryTypeIndex);
+    [[nodiscard]] std::uint32_t heapIndexOf(std::uint32_t memoryTypeIndex) const { return memoryProperties.memoryTypes[memoryTypeIndex].heapIndex; }
+    void releaseEmptyBlock(VulkanMemoryBlock* block);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_ALLOCATOR_HPP
@@ -16,16 +16,16 @@
 namespace rr
 {
 
-VulkanCommandPool::VulkanCommandPool(VulkanDevice& device)
+VulkanCommandPool::VulkanCommandPool(VulkanDevice& device, VkCommandPoolCreateFlags flags)
     : device(device)
 {
-    QueueFamilyIndices indices{ device.findPhysicalQueueFamilies() };
+    const QueueFamilyIndices& indices{ device.findPhysicalQueueFamilies() };
     if(!indices.graphicsFamily.has_value())
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::QUEUE_FAMILY_INDEX_IS_EMPTY);
 
     VkCommandPoolCreateInfo createInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .flags = flags,
         .queueFamilyIndex = indices.graphicsFamily.value()
     };
 
@@ -40,14 +40,20 @@ VulkanCommandPool::~VulkanCommandPool()
     vkDestroyCommandPool(device.getHandle(), m_commandPool, nullptr);
 }
 
-std::unique_ptr<VulkanCommandBuffer> VulkanCommandPool::allocateCommandBuffer()
+std::unique_ptr<VulkanCommandBuffer> VulkanCommandPool::allocateCommandBuffer(VkCommandBufferLevel level)
 {
-    return std::make_unique<VulkanCommandBuffer>(device.getHandle(), m_commandPool);
+    return std::make_unique<VulkanCommandBuffer>(device.getHandle(), m_commandPool, level);
 }
 
-std::vector<std::unique_ptr<VulkanCommandBuffer>> VulkanCommandPool::allocateCommandBuffer(std::uint32_t count)
+std::vector<std::unique_ptr<VulkanCommandBuffer>> VulkanCommandPool::allocateCommandBuffer(std::uint32_t count, VkCommandBufferLevel level)
 {
-    return VulkanCommandBuffer::create(device.getHandle(), m_commandPool, count);
+    return VulkanCommandBuffer::create(device.getHandle(), m_commandPool, count, level);
+}
+
+void VulkanCommandPool::reset()
+{
+    if(vkResetCommandPool(device.getHandle(), m_commandPool, 0) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::RESET_COMMAND_POOL);
 }
 
 } // !rr
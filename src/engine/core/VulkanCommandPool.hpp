@@ -16,7 +16,9 @@ namespace rr
 class VulkanCommandPool
 {
 public:
-    explicit VulkanCommandPool(VulkanDevice& device);
+    static constexpr VkCommandPoolCreateFlags DEFAULT_FLAGS{ VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT };
+
+    explicit VulkanCommandPool(VulkanDevice& device, VkCommandPoolCreateFlags flags = DEFAULT_FLAGS);
     ~VulkanCommandPool();
 
     VulkanCommandPool(const VulkanCommandPool&) = delete;
@@ -26,8 +28,11 @@ public:
 
     [[nodiscard]] VkCommandPool getHandle() const { return m_commandPool; }
 
-    std::unique_ptr<VulkanCommandBuffer> allocateCommandBuffer();
-    std::vector<std::unique_ptr<VulkanCommandBuffer>> allocateCommandBuffer(std::uint32_t count);
+    std::unique_ptr<VulkanCommandBuffer> allocateCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    std::vector<std::unique_ptr<VulkanCommandBuffer>> allocateCommandBuffer(std::uint32_t count, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    /** Reset every command buffer of the pool at once, none of them may be pending execution */
+    void reset();
 
 private:
     VulkanDevice& device;
@@ -0,0 +1,258 @@
+#include "VulkanDefragmenter.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanSwapchain.hpp"
+
+#include "spdlog/spdlog.h"
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rr
+{
+
+VulkanDefragmenter::VulkanDefragmenter(VulkanDevice& device, VkDeviceSize copyBudgetPerFrame)
+    : device(device)
+    , copyBudgetPerFrame(copyBudgetPerFrame)
+{}
+
+VulkanDefragmenter::~VulkanDefragmenter()
+{
+    retireBuffers(true);
+
+    if(!m_buffers.empty())
+        spdlog::warn("{} relocatable buffer(s) are still registered on destruction", m_buffers.size());
+}
+
+/**
+ *  Allow the defragmenter to move a buffer. The buffer needs VK_BUFFER_USAGE_TRANSFER_SRC_BIT and
+ *  VK_BUFFER_USAGE_TRANSFER_DST_BIT and must not be written by the host or GPU after it was registered.
+ *
+ *  @param onRelocated - invoked with the new buffer when it was moved, must not call back into the defragmenter
+ *  @returns std::size_t - id to unregister the buffer with before it is destroyed
+*/
+std::size_t VulkanDefragmenter::registerBuffer(VkBuffer buffer, const VulkanAllocation& allocation, VkDeviceSize size, VkBufferUsageFlags usage, RelocationCallback onRelocated)
+{
+    assert((usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) == (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT) &&
+           "Relocatable buffers have to be a transfer source and destination");
+
+    std::lock_guard lock{ m_mutex };
+
+    m_buffers.emplace(m_nextId, MovableBuffer{
+        .buffer = buffer,
+        .allocation = allocation,
+        .size = size,
+        .usage = usage,
+        .onRelocated = std::move(onRelocated)
+    });
+
+    return m_nextId++;
+}
+
+void VulkanDefragmenter::unregisterBuffer(std::size_t id)
+{
+    std::lock_guard lock{ m_mutex };
+
+    m_buffers.erase(id);
+}
+
+/**
+ *  Start a pass right away instead of waiting for the next interval.
+*/
+void VulkanDefragmenter::beginPass()
+{
+    std::lock_guard lock{ m_mutex };
+
+    if(!m_passActive)
+        startPass();
+}
+
+/**
+ *  Record the moves for this frame into <code>commandBuffer<\code>. Has to be called after the fence of the frame
+ *  signaled and before anything that uses relocatable buffers is recorded.
+*/
+void VulkanDefragmenter::recordMoves(VkCommandBuffer commandBuffer)
+{
+    std::lock_guard lock{ m_mutex };
+
+    ++m_frame;
+    retireBuffers(false);
+
+    if(!m_passActive && m_frame % PASS_INTERVAL == 0)
+        startPass();
+
+    if(!m_passActive)
+        return;
+
+    // NOTE: once nothing can be moved anymore the pass ends after the last moved buffers were released
+    if(!m_sourceBlockIds.empty() && moveBuffers(commandBuffer) == 0)
+        m_sourceBlockIds.clear();
+
+    if(m_sourceBlockIds.empty() && m_retired.empty())
+        finishPass();
+}
+
+bool VulkanDefragmenter::isPassActive() const
+{
+    std::lock_guard lock{ m_mutex };
+
+    return m_passActive;
+}
+
+DefragmentationStatistics VulkanDefragmenter::getStatistics() const
+{
+    std::lock_guard lock{ m_mutex };
+
+    return m_stats;
+}
+
+/**
+ *  Pick the blocks to evacuate. Per memory type and kind the sparse blocks become sources, but the fullest block of
+ *  a group always stays as a destination.
+*/
+void VulkanDefragmenter::startPass()
+{
+    std::map<std::pair<std::uint32_t, AllocationKind>, std::vector<MemoryBlockInfo>> groups;
+    for(const auto& info : device.getAllocator().getBlockInfos())
+        groups[{ info.memoryTypeIndex, info.kind }].push_back(info);
+
+    m_sourceBlockIds.clear();
+    for(auto& [key, blocks] : groups)
+    {
+        if(blocks.size() < 2)
+            continue;
+
+        std::ranges::sort(blocks, std::greater{}, &MemoryBlockInfo::usedSize);
+
+        for(std::size_t i{ 1 }; i < blocks.size(); ++i)
+        {
+            if(blocks[i].usedSize * 100 < blocks[i].size * SPARSE_BLOCK_PERCENT)
+                m_sourceBlockIds.push_back(blocks[i].id);
+        }
+    }
+
+    if(m_sourceBlockIds.empty())
+        return;
+
+    m_passActive = true;
+    m_passStartBlockBytes = device.getAllocationStatistics().blockBytes;
+    ++m_stats.passCount;
+
+    spdlog::info("Defragmentation pass started, evacuating {} block(s)", m_sourceBlockIds.size());
+}
+
+/**
+ *  Move registered buffers out of the source blocks until the copy budget of the frame is used up.
+ *
+ *  @returns VkDeviceSize - amount of bytes that were copied
+*/
+VkDeviceSize VulkanDefragmenter::moveBuffers(VkCommandBuffer commandBuffer)
+{
+    const auto sources{ findSourceBlocks() };
+    VkDeviceSize moved{ 0 };
+
+    for(auto& [id, entry] : m_buffers)
+    {
+        if(moved >= copyBudgetPerFrame)
+            break;
+
+        if(entry.allocation.isDedicated() || std::ranges::find(sources, entry.allocation.block) == sources.end())
+            continue;
+
+        VkBuffer newBuffer{ VK_NULL_HANDLE };
+        VulkanAllocation newAllocation;
+        if(!device.createBufferInExistingBlock(entry.size, entry.usage, entry.allocation, sources, newBuffer, newAllocation))
+            continue;
+
+        VkBufferCopy region{
+            .srcOffset = 0,
+            .dstOffset = 0,
+            .size = entry.size
+        };
+        vkCmdCopyBuffer(commandBuffer, entry.buffer, newBuffer, 1, &region);
+
+        m_retired.push_back({ .buffer = entry.buffer, .allocation = entry.allocation, .frame = m_frame });
+        entry.buffer = newBuffer;
+        entry.allocation = newAllocation;
+        entry.onRelocated(newBuffer, newAllocation);
+
+        moved += entry.size;
+        m_stats.movedBytes += entry.size;
+        ++m_stats.movedAllocationCount;
+    }
+
+    if(moved == 0)
+        return 0;
+
+    VkMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+    };
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+
+    return moved;
+}
+
+/**
+ *  Blocks can be freed while a pass is running, so the sources are looked up by id every frame.
+*/
+std::vector<const VulkanMemoryBlock*> VulkanDefragmenter::findSourceBlocks() const
+{
+    std::vector<const VulkanMemoryBlock*> sources;
+
+    for(const auto& info : device.getAllocator().getBlockInfos())
+    {
+        if(std::ranges::find(m_sourceBlockIds, info.id) != m_sourceBlockIds.end())
+            sources.push_back(info.block);
+    }
+
+    return sources;
+}
+
+/**
+ *  Destroy the buffers that were moved away from once no frame in flight can use them anymore.
+ *
+ *  @param all - destroy every retired buffer, the device has to be idle
+*/
+void VulkanDefragmenter::retireBuffers(bool all)
+{
+    while(!m_retired.empty() && (all || m_retired.front().frame + VulkanSwapchain::MAX_FRAMES_IN_FLIGHT <= m_frame))
+    {
+        auto& retired{ m_retired.front() };
+        device.destroyBuffer(retired.buffer, retired.allocation);
+
+        m_retired.pop_front();
+    }
+}
+
+void VulkanDefragmenter::finishPass()
+{
+    device.getAllocator().releaseEmptyBlocks();
+
+    const VkDeviceSize blockBytes{ device.getAllocationStatistics().blockBytes };
+    const VkDeviceSize reclaimed{ m_passStartBlockBytes > blockBytes ? m_passStartBlockBytes - blockBytes : 0 };
+
+    m_stats.reclaimedBytes += reclaimed;
+    m_passActive = false;
+
+    spdlog::info("Defragmentation pass finished, reclaimed {} bytes ({} bytes moved in total)", reclaimed, m_stats.movedBytes);
+}
+
+} // !rr
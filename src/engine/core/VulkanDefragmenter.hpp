@@ -0,0 +1,107 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_DEFRAGMENTER_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_DEFRAGMENTER_HPP
+
+#include "core/VulkanAllocator.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rr
+{
+
+class VulkanDevice;
+
+/** Called while recording a frame when a buffer was moved, every command recorded afterwards has to use the new one */
+using RelocationCallback = std::function<void(VkBuffer buffer, const VulkanAllocation& allocation)>;
+
+struct DefragmentationStatistics
+{
+    std::size_t passCount{ 0 };
+    std::size_t movedAllocationCount{ 0 };
+    VkDeviceSize movedBytes{ 0 };
+    VkDeviceSize reclaimedBytes{ 0 };
+};
+
+/**
+ *  <code>VulkanDefragmenter<\code> compacts long lived buffers. A pass looks for memory blocks that are mostly empty
+ *  and moves the registered buffers inside them into fuller blocks. Moves are GPU copies recorded at the start of a
+ *  frame and are capped to a copy budget per frame, so a pass is spread over several frames. The old buffer is kept
+ *  alive until no frame in flight can read it anymore. Once a pass is done, emptied blocks are given back.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanDefragmenter
+{
+public:
+    explicit VulkanDefragmenter(VulkanDevice& device, VkDeviceSize copyBudgetPerFrame = DEFAULT_COPY_BUDGET);
+    ~VulkanDefragmenter();
+
+    VulkanDefragmenter(const VulkanDefragmenter&) = delete;
+    VulkanDefragmenter(VulkanDefragmenter&&) = delete;
+    VulkanDefragmenter& operator=(const VulkanDefragmenter&) = delete;
+    VulkanDefragmenter& operator=(VulkanDefragmenter&&) = delete;
+
+    static constexpr VkDeviceSize DEFAULT_COPY_BUDGET{ 8ULL * 1024 * 1024 };
+    /** Blocks that are used less than this, in percent, are evacuated */
+    static constexpr VkDeviceSize SPARSE_BLOCK_PERCENT{ 50 };
+    /** A new pass is considered every this many frames */
+    static constexpr std::uint64_t PASS_INTERVAL{ 600 };
+
+    [[nodiscard]] std::size_t registerBuffer(VkBuffer buffer, const VulkanAllocation& allocation, VkDeviceSize size, VkBufferUsageFlags usage, RelocationCallback onRelocated);
+    void unregisterBuffer(std::size_t id);
+
+    void beginPass();
+    void recordMoves(VkCommandBuffer commandBuffer);
+
+    [[nodiscard]] bool isPassActive() const;
+    [[nodiscard]] DefragmentationStatistics getStatistics() const;
+
+private:
+    struct MovableBuffer
+    {
+        VkBuffer buffer;
+        VulkanAllocation allocation;
+        VkDeviceSize size;
+        VkBufferUsageFlags usage;
+        RelocationCallback onRelocated;
+    };
+
+    struct RetiredBuffer
+    {
+        VkBuffer buffer;
+        VulkanAllocation allocation;
+        std::uint64_t frame;
+    };
+
+    VulkanDevice& device;
+    VkDeviceSize copyBudgetPerFrame;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::size_t, MovableBuffer> m_buffers;
+    std::size_t m_nextId{ 0 };
+
+    std::vector<std::uint64_t> m_sourceBlockIds;
+    std::deque<RetiredBuffer> m_retired;
+    std::uint64_t m_frame{ 0 };
+    bool m_passActive{ false };
+    VkDeviceSize m_passStartBlockBytes{ 0 };
+    DefragmentationStatistics m_stats;
+
+    void startPass();
+    [[nodiscard]] VkDeviceSize moveBuffers(VkCommandBuffer commandBuffer);
+    [[nodiscard]] std::vector<const VulkanMemoryBlock*> findSourceBlocks() const;
+    void retireBuffers(bool all);
+    void finishPass();
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_DEFRAGMENTER_HPP
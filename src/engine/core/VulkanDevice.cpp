@@ -2,17 +2,26 @@
 
 #include "constants.hpp"
 
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDefragmenter.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "core/VulkanUploadScheduler.hpp"
 #include "exception/EngineException.hpp"
 #include "exception/VulkanException.hpp"
 #include "spdlog/spdlog.h"
 #include <source_location>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace rr
@@ -24,10 +33,27 @@ VulkanDevice::VulkanDevice(VkInstance instance, VkSurfaceKHR surface)
 {
     pickPhyscialDevice();
     createLogicalDevice();
+
+    // NOTE: formats and present modes of a surface are fixed, only its capabilities change on resize
+    m_swapchainSupport = querySwapchainSupport(m_physicalDevice);
+    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+    m_allocator = std::make_unique<VulkanAllocator>(m_device, m_memoryProperties);
+    queryMemoryBudget();
+    m_uploadScheduler = std::make_unique<VulkanUploadScheduler>(*this);
+    m_defragmenter = std::make_unique<VulkanDefragmenter>(*this);
+    m_geometryPool = std::make_unique<VulkanGeometryPool>(*this);
+
+    // NOTE: callbacks are asked in the order they were added, memory released by the owners above may leave whole
+    //       blocks empty which are only given back here
+    static_cast<void>(addBudgetCallback([this](std::uint32_t heapIndex, VkDeviceSize) { return m_allocator->releaseEmptyBlocks(heapIndex); }));
 }
 
 VulkanDevice::~VulkanDevice()
 {
+    m_geometryPool.reset();
+    m_defragmenter.reset();
+    m_uploadScheduler.reset();
+    m_allocator.reset();
     vkDestroyDevice(m_device, nullptr);
 }
 
@@ -48,28 +74,81 @@ VkFormat VulkanDevice::findSupportedFormat(const std::vector<VkFormat>& candidat
     throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::FIND_SUPPORTED_FORMAT);
 }
 
-void VulkanDevice::createImageWithInfo(const VkImageCreateInfo& createInfo, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
+void VulkanDevice::createImageWithInfo(const VkImageCreateInfo& createInfo, VkMemoryPropertyFlags properties, VkImage& image, VulkanAllocation& imageAllocation, MemoryCategory category)
 {
-    if(vkCreateImage(m_device, &createInfo, nullptr, &image) != VK_SUCCESS)
+    VkImageCreateInfo imageInfo{ createInfo };
+    if(static_cast<bool>(imageInfo.usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && imageInfo.sharingMode == VK_SHARING_MODE_EXCLUSIVE && m_queueFamilyIndices.hasDedicatedTransfer())
+    {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(m_uploadQueueFamilies.size());
+        imageInfo.pQueueFamilyIndices = m_uploadQueueFamilies.data();
+    }
+
+    if(vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_IMAGE);
 
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(m_device, image, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memRequirements.size,
-        .memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties)
-    };
+    const AllocationKind kind{ imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL ? AllocationKind::OPTIMAL : AllocationKind::LINEAR };
+    const std::uint32_t memoryTypeIndex{ findMemoryType(memRequirements.memoryTypeBits, properties) };
+    relieveMemoryPressure(m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex, memRequirements.size);
+    imageAllocation = m_allocator->allocate(memRequirements, memoryTypeIndex, kind, category);
 
-    if(vkAllocateMemory(m_device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_MEMORY);
-
-    if(vkBindImageMemory(m_device, image, imageMemory, 0) != VK_SUCCESS)
+    if(vkBindImageMemory(m_device, image, imageAllocation.memory, imageAllocation.offset) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BIND_IMAGE_MEMORY);
 }
 
-void VulkanDevice::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+void VulkanDevice::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VulkanAllocation& bufferAllocation, MemoryCategory category)
+{
+    buffer = createBufferHandle(size, usage);
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
+
+    const std::uint32_t memoryTypeIndex{ findMemoryType(memRequirements.memoryTypeBits, properties) };
+    relieveMemoryPressure(m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex, memRequirements.size);
+    bufferAllocation = m_allocator->allocate(memRequirements, memoryTypeIndex, AllocationKind::LINEAR, category);
+
+    if(vkBindBufferMemory(m_device, buffer, bufferAllocation.memory, bufferAllocation.offset) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BIND_BUFFER_MEMORY);
+}
+
+/**
+ *  Create a buffer with the same memory type and category as <code>current<\code>, but only inside of blocks that
+ *  already exist and are not in <code>excluded<\code>. Used to move buffers without growing the memory footprint.
+ *
+ *  @returns bool - false if no existing block had room, nothing was created in that case
+*/
+bool VulkanDevice::createBufferInExistingBlock(
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    const VulkanAllocation& current,
+    const std::vector<const VulkanMemoryBlock*>& excluded,
+    VkBuffer& buffer,
+    VulkanAllocation& bufferAllocation)
+{
+    VkBuffer newBuffer{ createBufferHandle(size, usage) };
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, newBuffer, &memRequirements);
+
+    auto allocation{ m_allocator->allocateInExistingBlock(memRequirements, current.memoryTypeIndex, AllocationKind::LINEAR, current.category, excluded) };
+    if(!allocation.has_value())
+    {
+        vkDestroyBuffer(m_device, newBuffer, nullptr);
+        return false;
+    }
+
+    if(vkBindBufferMemory(m_device, newBuffer, allocation->memory, allocation->offset) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BIND_BUFFER_MEMORY);
+
+    buffer = newBuffer;
+    bufferAllocation = *allocation;
+    return true;
+}
+
+VkBuffer VulkanDevice::createBufferHandle(VkDeviceSize size, VkBufferUsageFlags usage)
 {
     VkBufferCreateInfo createInfo{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -78,22 +157,105 @@ void VulkanDevice::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkM
         .sharingMode = VK_SHARING_MODE_EXCLUSIVE
     };
 
+    // NOTE: upload targets are shared by the transfer and graphics family so no ownership transfer is needed
+    if(static_cast<bool>(usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) && m_queueFamilyIndices.hasDedicatedTransfer())
+    {
+        createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        createInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(m_uploadQueueFamilies.size());
+        createInfo.pQueueFamilyIndices = m_uploadQueueFamilies.data();
+    }
+
+    VkBuffer buffer{ VK_NULL_HANDLE };
     if(vkCreateBuffer(m_device, &createInfo, nullptr, &buffer) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_BUFFER);
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
+    return buffer;
+}
 
-    VkMemoryAllocateInfo allocInfo{
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memRequirements.size,
-        .memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties)
-    };
+/**
+ *  Surface formats and present modes are cached at device creation, the capabilities are queried again since the
+ *  current extent changes with the window.
+*/
+const SwapchainSupportDetails& VulkanDevice::getSwapchainSupport()
+{
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physicalDevice, surface, &m_swapchainSupport.capabilities);
+
+    return m_swapchainSupport;
+}
+
+/**
+ *  Allocate memory that resources are bound to manually, e.g. when several resources alias the same memory.
+ *
+ *  @param properties - properties the memory needs to have
+ *  @param preferred - additional properties that are used if a memory type with them exists
+*/
+VulkanAllocation VulkanDevice::allocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VkMemoryPropertyFlags preferred, AllocationKind kind, MemoryCategory category)
+{
+    const auto preferredType{ tryFindMemoryType(requirements.memoryTypeBits, properties | preferred) };
+    const std::uint32_t memoryTypeIndex{ preferredType.has_value() ? preferredType.value() : findMemoryType(requirements.memoryTypeBits, properties) };
+
+    relieveMemoryPressure(m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex, requirements.size);
+    return m_allocator->allocate(requirements, memoryTypeIndex, kind, category);
+}
+
+bool VulkanDevice::hasMemoryProperties(const VulkanAllocation& allocation, VkMemoryPropertyFlags properties) const
+{
+    return (m_memoryProperties.memoryTypes[allocation.memoryTypeIndex].propertyFlags & properties) == properties;
+}
+
+void VulkanDevice::destroyImage(VkImage image, VulkanAllocation& imageAllocation)
+{
+    vkDestroyImage(m_device, image, nullptr);
+    m_allocator->free(imageAllocation);
+}
+
+void VulkanDevice::destroyBuffer(VkBuffer buffer, VulkanAllocation& bufferAllocation)
+{
+    vkDestroyBuffer(m_device, buffer, nullptr);
+    m_allocator->free(bufferAllocation);
+}
+
+std::vector<HeapBudget> VulkanDevice::getMemoryBudget() const
+{
+    std::vector<HeapBudget> budgets(m_memoryProperties.memoryHeapCount);
+    for(std::uint32_t i{ 0 }; i < m_memoryProperties.memoryHeapCount; ++i)
+        budgets[i] = estimateHeapBudget(i);
+
+    return budgets;
+}
+
+/**
+ *  Register a callback that is asked to release memory when a heap comes close to its budget. Callbacks are asked
+ *  in the order they were added until enough memory was released.
+ *
+ *  @returns std::size_t - id to remove the callback with
+*/
+std::size_t VulkanDevice::addBudgetCallback(BudgetCallback callback)
+{
+    std::lock_guard lock{ m_budgetMutex };
 
-    if(vkAllocateMemory(m_device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
-        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_MEMORY);
+    m_budgetCallbacks.emplace_back(m_nextBudgetCallbackId, std::move(callback));
 
-    vkBindBufferMemory(m_device, buffer, bufferMemory, 0);
+    return m_nextBudgetCallbackId++;
+}
+
+void VulkanDevice::removeBudgetCallback(std::size_t id)
+{
+    std::lock_guard lock{ m_budgetMutex };
+
+    std::erase_if(m_budgetCallbacks, [id](const auto& entry) { return entry.first == id; });
+}
+
+/**
+ *  Check every heap against its budget. Meant to be called once per frame so that pressure from other
+ *  applications is noticed even when we do not allocate anything.
+*/
+void VulkanDevice::updateMemoryBudget()
+{
+    queryMemoryBudget();
+
+    for(std::uint32_t i{ 0 }; i < m_memoryProperties.memoryHeapCount; ++i)
+        relieveMemoryPressure(i, 0);
 }
 
 void VulkanDevice::pickPhyscialDevice()
@@ -153,14 +315,82 @@ void VulkanDevice::createLogicalDevice()
         .samplerAnisotropy = VK_TRUE
     };
 
+    // NOTE: draw indirect count, mesh shaders and dynamic rendering are optional, the renderer falls back to plain
+    //       draws and render pass objects without them
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR supportedDynamicRenderingFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR
+    };
+    VkPhysicalDeviceMeshShaderFeaturesEXT supportedMeshShaderFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT
+    };
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+    };
+    VkPhysicalDeviceFeatures2 supportedFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &supportedVulkan12Features
+    };
+
+    const bool meshShaderExtensionSupported{ isDeviceExtensionSupported(m_physicalDevice, VK_EXT_MESH_SHADER_EXTENSION_NAME) };
+    if(meshShaderExtensionSupported)
+        supportedVulkan12Features.pNext = &supportedMeshShaderFeatures;
+
+    // NOTE: the instance targets Vulkan 1.2, so dynamic rendering is used through the extension even where it is core
+    const bool dynamicRenderingExtensionSupported{ isDeviceExtensionSupported(m_physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) };
+    if(dynamicRenderingExtensionSupported)
+    {
+        supportedDynamicRenderingFeatures.pNext = supportedVulkan12Features.pNext;
+        supportedVulkan12Features.pNext = &supportedDynamicRenderingFeatures;
+    }
+
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures);
+
+    m_drawIndirectCountSupported = static_cast<bool>(supportedVulkan12Features.drawIndirectCount);
+    m_meshShadersSupported = meshShaderExtensionSupported &&
+        static_cast<bool>(supportedMeshShaderFeatures.taskShader) &&
+        static_cast<bool>(supportedMeshShaderFeatures.meshShader);
+    m_dynamicRenderingSupported = dynamicRenderingExtensionSupported && static_cast<bool>(supportedDynamicRenderingFeatures.dynamicRendering);
+
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+        .taskShader = VK_TRUE,
+        .meshShader = VK_TRUE
+    };
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+        .dynamicRendering = VK_TRUE
+    };
+    VkPhysicalDeviceVulkan12Features vulkan12Features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = m_meshShadersSupported ? &meshShaderFeatures : nullptr,
+        .drawIndirectCount = m_drawIndirectCountSupported ? VK_TRUE : VK_FALSE,
+        .timelineSemaphore = VK_TRUE
+    };
+    if(m_dynamicRenderingSupported)
+    {
+        dynamicRenderingFeatures.pNext = vulkan12Features.pNext;
+        vulkan12Features.pNext = &dynamicRenderingFeatures;
+    }
+
+    // NOTE: memory budget is optional, without it the budget is estimated from the heap sizes
+    std::vector<const char*> enabledExtensions{ deviceExtensions };
+    m_memoryBudgetSupported = isDeviceExtensionSupported(m_physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if(m_memoryBudgetSupported)
+        enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if(m_meshShadersSupported)
+        enabledExtensions.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    if(m_dynamicRenderingSupported)
+        enabledExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+
     VkDeviceCreateInfo createInfo{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = &vulkan12Features,
         .queueCreateInfoCount = static_cast<std::uint32_t>(queueCreateInfos.size()),
         .pQueueCreateInfos = queueCreateInfos.data(),
         .enabledLayerCount = 0,
         .ppEnabledLayerNames = nullptr,
-        .enabledExtensionCount = static_cast<std::uint32_t>(deviceExtensions.size()),
-        .ppEnabledExtensionNames = deviceExtensions.data(),
+        .enabledExtensionCount = static_cast<std::uint32_t>(enabledExtensions.size()),
+        .ppEnabledExtensionNames = enabledExtensions.data(),
         .pEnabledFeatures = &deviceFeatures
     };
 
@@ -173,13 +403,25 @@ void VulkanDevice::createLogicalDevice()
     if(vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DEVICE);
 
-    if(indices.graphicsFamily.has_value() && indices.presentFamily.has_value())
+    if(indices.graphicsFamily.has_value() && indices.presentFamily.has_value() && indices.transferFamily.has_value())
     {
         vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
         vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+        vkGetDeviceQueue(m_device, indices.transferFamily.value(), 0, &m_transferQueue);
     } else
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::QUEUE_FAMILY_INDEX_IS_EMPTY);
 
+    m_queueFamilyIndices = indices;
+    m_uploadQueueFamilies = { indices.graphicsFamily.value(), indices.transferFamily.value() };
+
+    if(m_meshShadersSupported)
+        m_cmdDrawMeshTasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(vkGetDeviceProcAddr(m_device, "vkCmdDrawMeshTasksEXT"));
+    if(m_dynamicRenderingSupported)
+    {
+        m_cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(vkGetDeviceProcAddr(m_device, "vkCmdBeginRenderingKHR"));
+        m_cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(vkGetDeviceProcAddr(m_device, "vkCmdEndRenderingKHR"));
+    }
+
     spdlog::info("Logical device created successfully...");
 }
 
@@ -195,10 +437,27 @@ bool VulkanDevice::isDeviceSuitable(VkPhysicalDevice device) const
         swapchainSuitable = !swapchainSupport.formats.empty() && !swapchainSupport.presentModes.empty();
     }
 
-    VkPhysicalDeviceFeatures supportedFeatures;
-    vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+    };
+    VkPhysicalDeviceFeatures2 supportedFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan12Features
+    };
+
+    if(properties.apiVersion < VK_API_VERSION_1_2)
+        return false;
+
+    vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
 
-    return indices.isComplete() && extensionsSupported && swapchainSuitable && static_cast<bool>(supportedFeatures.samplerAnisotropy);
+    return indices.isComplete() &&
+        extensionsSupported &&
+        swapchainSuitable &&
+        static_cast<bool>(supportedFeatures.features.samplerAnisotropy) &&
+        static_cast<bool>(vulkan12Features.timelineSemaphore);
 }
 
 QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device) const
@@ -214,20 +473,26 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device) cons
     int i{0};
     for(const auto& queueFamily : queueFamilies)
     {
-        if(queueFamily.queueCount > 0 && static_cast<bool>(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+        if(!indices.graphicsFamily.has_value() && queueFamily.queueCount > 0 && static_cast<bool>(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
             indices.graphicsFamily.emplace(i);
 
         VkBool32 presentSupport{ VK_FALSE };
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
-        if(queueFamily.queueCount > 0 && static_cast<bool>(presentSupport))
+        if(!indices.presentFamily.has_value() && queueFamily.queueCount > 0 && static_cast<bool>(presentSupport))
             indices.presentFamily.emplace(i);
 
-        if(indices.isComplete())
-            break;
+        // NOTE: a transfer family without graphics and compute support is usually backed by a dedicated DMA engine
+        constexpr VkQueueFlags GENERAL_PURPOSE{ VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT };
+        if(!indices.transferFamily.has_value() && queueFamily.queueCount > 0 &&
+            static_cast<bool>(queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !static_cast<bool>(queueFamily.queueFlags & GENERAL_PURPOSE))
+            indices.transferFamily.emplace(i);
 
         ++i;
     }
 
+    if(!indices.transferFamily.has_value())
+        indices.transferFamily = indices.graphicsFamily;
+
     return indices;
 }
 
@@ -247,6 +512,123 @@ bool VulkanDevice::checkDeviceExtensionsSupported(VkPhysicalDevice device) const
     return requiredExtensions.empty();
 }
 
+bool VulkanDevice::isDeviceExtensionSupported(VkPhysicalDevice device, const char* extension) const
+{
+    std::uint32_t extensionCount{0};
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    return std::ranges::any_of(availableExtensions, [extension](const auto& properties) {
+        return std::strcmp(properties.extensionName, extension) == 0;
+    });
+}
+
+/**
+ *  Query budget and usage of every memory heap from the driver. The query goes over all heaps and is too expensive
+ *  for every allocation, allocations in between are accounted for by <code>estimateHeapBudget()<\code>.
+*/
+void VulkanDevice::queryMemoryBudget()
+{
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+    };
+    VkPhysicalDeviceMemoryProperties2 memoryProperties{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+        .pNext = &budgetProperties
+    };
+
+    if(m_memoryBudgetSupported)
+        vkGetPhysicalDeviceMemoryProperties2(m_physicalDevice, &memoryProperties);
+
+    std::vector<HeapBudget> budgets(m_memoryProperties.memoryHeapCount);
+    std::vector<VkDeviceSize> allocatorUsage(m_memoryProperties.memoryHeapCount);
+    for(std::uint32_t i{ 0 }; i < m_memoryProperties.memoryHeapCount; ++i)
+    {
+        const auto& heap{ m_memoryProperties.memoryHeaps[i] };
+        allocatorUsage[i] = m_allocator->getHeapUsage(i);
+
+        budgets[i] = {
+            .size = heap.size,
+            .budget = m_memoryBudgetSupported ? budgetProperties.heapBudget[i] : heap.size / 100 * FALLBACK_BUDGET_PERCENT,
+            .usage = m_memoryBudgetSupported ? budgetProperties.heapUsage[i] : allocatorUsage[i],
+            .deviceLocal = static_cast<bool>(heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        };
+    }
+
+    std::lock_guard lock{ m_budgetMutex };
+    m_heapBudgets = std::move(budgets);
+    m_queriedAllocatorUsage = std::move(allocatorUsage);
+}
+
+/**
+ *  Budget of a heap as of the last query, the usage is corrected by what the allocator allocated or freed in that
+ *  heap since then. Changes of other processes only show up with the next query.
+*/
+HeapBudget VulkanDevice::estimateHeapBudget(std::uint32_t heapIndex) const
+{
+    const VkDeviceSize allocatorUsage{ m_allocator->getHeapUsage(heapIndex) };
+
+    std::lock_guard lock{ m_budgetMutex };
+    HeapBudget heap{ m_heapBudgets.at(heapIndex) };
+    const VkDeviceSize queriedUsage{ m_queriedAllocatorUsage[heapIndex] };
+
+    if(allocatorUsage >= queriedUsage)
+        heap.usage += allocatorUsage - queriedUsage;
+    else
+        heap.usage -= std::min(heap.usage, queriedUsage - allocatorUsage);
+
+    return heap;
+}
+
+/**
+ *  Ask the registered budget callbacks to release memory if allocating <code>incomingSize<\code> more bytes would
+ *  push the heap over the pressure threshold.
+*/
+void VulkanDevice::relieveMemoryPressure(std::uint32_t heapIndex, VkDeviceSize incomingSize)
+{
+    const auto heap{ estimateHeapBudget(heapIndex) };
+    const VkDeviceSize expectedUsage{ heap.usage + incomingSize };
+
+    if(expectedUsage <= heap.budget / 100 * BUDGET_PRESSURE_PERCENT)
+        return;
+
+    std::vector<BudgetCallback> callbacks;
+    {
+        std::lock_guard lock{ m_budgetMutex };
+
+        // NOTE: callbacks release memory themselves which must not trigger another round of eviction
+        if(m_evicting || m_budgetCallbacks.empty())
+            return;
+
+        m_evicting = true;
+        for(const auto& entry : m_budgetCallbacks)
+            callbacks.push_back(entry.second);
+    }
+
+    const VkDeviceSize target{ heap.budget / 100 * BUDGET_TARGET_PERCENT };
+    VkDeviceSize bytesToFree{ expectedUsage > target ? expectedUsage - target : 0 };
+    VkDeviceSize released{ 0 };
+
+    for(const auto& callback : callbacks)
+    {
+        if(released >= bytesToFree)
+            break;
+
+        released += callback(heapIndex, bytesToFree - released);
+    }
+
+    {
+        std::lock_guard lock{ m_budgetMutex };
+        m_evicting = false;
+    }
+
+    if(released < bytesToFree)
+        spdlog::warn("Memory heap {} is over budget: {} of {} bytes used, only {} of {} bytes could be released",
+                     heapIndex, heap.usage, heap.budget, released, bytesToFree);
+}
+
 SwapchainSupportDetails VulkanDevice::querySwapchainSupport(VkPhysicalDevice device) const
 {
     SwapchainSupportDetails details;
@@ -275,16 +657,21 @@ SwapchainSupportDetails VulkanDevice::querySwapchainSupport(VkPhysicalDevice dev
 
 std::uint32_t VulkanDevice::findMemoryType(std::uint32_t typeFilter, VkMemoryPropertyFlags properties)
 {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
+    if(auto memoryTypeIndex{ tryFindMemoryType(typeFilter, properties) }; memoryTypeIndex.has_value())
+        return memoryTypeIndex.value();
+
+    throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::NO_SUITABLE_MEMORY_TYPE_FOUND);
+}
 
-    for(std::uint32_t i{0}; i < memProperties.memoryTypeCount; ++i)
+std::optional<std::uint32_t> VulkanDevice::tryFindMemoryType(std::uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+    for(std::uint32_t i{0}; i < m_memoryProperties.memoryTypeCount; ++i)
     {
-        if(static_cast<bool>((typeFilter & (1 << i))) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) //NOLINT
+        if(static_cast<bool>((typeFilter & (1 << i))) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) //NOLINT
             return i;
     }
 
-    throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::NO_SUITABLE_MEMORY_TYPE_FOUND);
+    return std::nullopt;
 }
 
 }
@@ -1,13 +1,18 @@
 #ifndef RRENDERER_ENGINE_CORE_VULKAN_DEVICE_HPP
 #define RRENDERER_ENGINE_CORE_VULKAN_DEVICE_HPP
 
+#include "core/VulkanAllocator.hpp"
 #include "exception/VulkanException.hpp"
 #include "exception/EngineException.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <source_location>
@@ -16,6 +21,10 @@
 namespace rr
 {
 
+class VulkanDefragmenter;
+class VulkanGeometryPool;
+class VulkanUploadScheduler;
+
 struct SwapchainSupportDetails
 {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -27,6 +36,7 @@ struct QueueFamilyIndices
 {
     std::optional<std::uint32_t> graphicsFamily;
     std::optional<std::uint32_t> presentFamily;
+    std::optional<std::uint32_t> transferFamily;
 
     [[nodiscard]] constexpr bool isComplete() const { return graphicsFamily.has_value() && presentFamily.has_value(); }
     [[nodiscard]] constexpr bool areSameQueue() const
@@ -38,7 +48,11 @@ struct QueueFamilyIndices
 
     }
 
-    [[nodiscard]] std::set<std::uint32_t> getUniqueFamilies() const { return { graphicsFamily.value_or(0), presentFamily.value_or(0) }; }
+    [[nodiscard]] bool hasDedicatedTransfer() const { return transferFamily.has_value() && transferFamily != graphicsFamily; }
+    [[nodiscard]] std::set<std::uint32_t> getUniqueFamilies() const
+    {
+        return { graphicsFamily.value_or(0), presentFamily.value_or(0), transferFamily.value_or(graphicsFamily.value_or(0)) };
+    }
     [[nodiscard]] constexpr std::array<std::uint32_t, 2> toAray() const
     {
         if(graphicsFamily.has_value() && presentFamily.has_value())
@@ -48,6 +62,24 @@ struct QueueFamilyIndices
     }
 };
 
+/**
+ *  Budget of a single memory heap. With <code>VK_EXT_memory_budget<\code> the numbers come from the driver and
+ *  include other processes, otherwise the budget is estimated from the heap size and only our own usage is known.
+*/
+struct HeapBudget
+{
+    VkDeviceSize size{ 0 };
+    VkDeviceSize budget{ 0 };
+    VkDeviceSize usage{ 0 };
+    bool deviceLocal{ false };
+};
+
+/**
+ *  Called when a heap gets close to its budget. Gets the heap and the amount of bytes that should be released and
+ *  returns how many bytes were actually released.
+*/
+using BudgetCallback = std::function<VkDeviceSize(std::uint32_t heapIndex, VkDeviceSize bytesToFree)>;
+
 /*
  *  <code>VulkanDevice<\code> is a wrapper around <code>VkDevice<\code>, <code>VkPhysicalDevice<\code> and also
  *  manages the queues.
@@ -69,13 +101,52 @@ public:
     [[nodiscard]] VkDevice getHandle() const { return m_device; }
     [[nodiscard]] VkQueue getGraphicsQueueHandle() const { return m_graphicsQueue; }
     [[nodiscard]] VkQueue getPresentQueueHandle() const { return m_presentQueue; }
+    [[nodiscard]] VkQueue getTransferQueueHandle() const { return m_transferQueue; }
+    [[nodiscard]] const VkPhysicalDeviceProperties& getProperties() const { return m_physicalDeviceProperties; }
 
-    [[nodiscard]] SwapchainSupportDetails getSwapchainSupport() const { return querySwapchainSupport(m_physicalDevice); }
-    [[nodiscard]] QueueFamilyIndices findPhysicalQueueFamilies() const { return findQueueFamilies(m_physicalDevice); }
+    [[nodiscard]] const SwapchainSupportDetails& getSwapchainSupport();
+    [[nodiscard]] const QueueFamilyIndices& findPhysicalQueueFamilies() const { return m_queueFamilyIndices; }
     [[nodiscard]] VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
-    void createImageWithInfo(const VkImageCreateInfo& createInfo, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
-    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+    void createImageWithInfo(const VkImageCreateInfo& createInfo, VkMemoryPropertyFlags properties, VkImage& image, VulkanAllocation& imageAllocation, MemoryCategory category = MemoryCategory::OTHER);
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VulkanAllocation& bufferAllocation, MemoryCategory category = MemoryCategory::OTHER);
+    [[nodiscard]] VulkanAllocation allocateMemory(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VkMemoryPropertyFlags preferred, AllocationKind kind, MemoryCategory category);
+    void freeMemory(VulkanAllocation& allocation) { m_allocator->free(allocation); }
+    [[nodiscard]] bool hasMemoryProperties(const VulkanAllocation& allocation, VkMemoryPropertyFlags properties) const;
+    void destroyImage(VkImage image, VulkanAllocation& imageAllocation);
+    void destroyBuffer(VkBuffer buffer, VulkanAllocation& bufferAllocation);
+    [[nodiscard]] bool createBufferInExistingBlock(
+        VkDeviceSize size,
+        VkBufferUsageFlags usage,
+        const VulkanAllocation& current,
+        const std::vector<const VulkanMemoryBlock*>& excluded,
+        VkBuffer& buffer,
+        VulkanAllocation& bufferAllocation);
+
+    [[nodiscard]] AllocationStatistics getAllocationStatistics() const { return m_allocator->getStatistics(); }
+    /** Budgets as of the last <code>updateMemoryBudget()<\code>, with our own allocations since then added */
+    [[nodiscard]] std::vector<HeapBudget> getMemoryBudget() const;
+    [[nodiscard]] bool hasMemoryBudgetExtension() const { return m_memoryBudgetSupported; }
+    [[nodiscard]] std::uint32_t getHeapIndex(std::uint32_t memoryTypeIndex) const { return m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex; }
+    [[nodiscard]] bool supportsDrawIndirectCount() const { return m_drawIndirectCountSupported; }
+    [[nodiscard]] bool supportsMeshShaders() const { return m_meshShadersSupported; }
+    [[nodiscard]] bool supportsDynamicRendering() const { return m_dynamicRenderingSupported; }
+    /** <code>vkCmdDrawMeshTasksEXT<\code> is an extension command, it has to be loaded from the device */
+    void cmdDrawMeshTasks(VkCommandBuffer cmdBuffer, std::uint32_t groupCountX, std::uint32_t groupCountY, std::uint32_t groupCountZ) const
+    {
+        m_cmdDrawMeshTasks(cmdBuffer, groupCountX, groupCountY, groupCountZ);
+    }
+    /** Dynamic rendering is only core from Vulkan 1.3 on, its commands are loaded from the device like extensions */
+    void cmdBeginRendering(VkCommandBuffer cmdBuffer, const VkRenderingInfo& renderingInfo) const { m_cmdBeginRendering(cmdBuffer, &renderingInfo); }
+    void cmdEndRendering(VkCommandBuffer cmdBuffer) const { m_cmdEndRendering(cmdBuffer); }
+    [[nodiscard]] std::size_t addBudgetCallback(BudgetCallback callback);
+    void removeBudgetCallback(std::size_t id);
+    /** Query the budget of every heap and relieve the pressure on heaps close to it, meant to be called once per frame */
+    void updateMemoryBudget();
+    [[nodiscard]] VulkanAllocator& getAllocator() { return *m_allocator; }
+    [[nodiscard]] VulkanUploadScheduler& getUploadScheduler() { return *m_uploadScheduler; }
+    [[nodiscard]] VulkanDefragmenter& getDefragmenter() { return *m_defragmenter; }
+    [[nodiscard]] VulkanGeometryPool& getGeometryPool() { return *m_geometryPool; }
 
 private:
     VkInstance instance;
@@ -86,6 +157,36 @@ private:
     VkDevice m_device{ VK_NULL_HANDLE };
     VkQueue m_graphicsQueue{ VK_NULL_HANDLE };
     VkQueue m_presentQueue{ VK_NULL_HANDLE };
+    VkQueue m_transferQueue{ VK_NULL_HANDLE };
+    QueueFamilyIndices m_queueFamilyIndices;
+    SwapchainSupportDetails m_swapchainSupport{};
+    std::array<std::uint32_t, 2> m_uploadQueueFamilies{};
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+    bool m_memoryBudgetSupported{ false };
+    bool m_drawIndirectCountSupported{ false };
+    bool m_meshShadersSupported{ false };
+    bool m_dynamicRenderingSupported{ false };
+    PFN_vkCmdDrawMeshTasksEXT m_cmdDrawMeshTasks{ nullptr };
+    PFN_vkCmdBeginRenderingKHR m_cmdBeginRendering{ nullptr };
+    PFN_vkCmdEndRenderingKHR m_cmdEndRendering{ nullptr };
+    std::unique_ptr<VulkanAllocator> m_allocator;
+    std::unique_ptr<VulkanUploadScheduler> m_uploadScheduler;
+    std::unique_ptr<VulkanDefragmenter> m_defragmenter;
+    std::unique_ptr<VulkanGeometryPool> m_geometryPool;
+
+    mutable std::mutex m_budgetMutex;
+    /** Last queried budget of every heap and the bytes the allocator held in it at that time */
+    std::vector<HeapBudget> m_heapBudgets;
+    std::vector<VkDeviceSize> m_queriedAllocatorUsage;
+    std::vector<std::pair<std::size_t, BudgetCallback>> m_budgetCallbacks;
+    std::size_t m_nextBudgetCallbackId{ 0 };
+    bool m_evicting{ false };
+
+    /** Eviction starts above the pressure threshold and tries to get back down to the target, in percent of the budget */
+    static constexpr VkDeviceSize BUDGET_PRESSURE_PERCENT{ 90 };
+    static constexpr VkDeviceSize BUDGET_TARGET_PERCENT{ 80 };
+    /** Budget assumed for a heap when <code>VK_EXT_memory_budget<\code> is not available, in percent of its size */
+    static constexpr VkDeviceSize FALLBACK_BUDGET_PERCENT{ 80 };
 
     const std::vector<const char*> deviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
@@ -95,8 +196,14 @@ private:
     bool isDeviceSuitable(VkPhysicalDevice device) const;
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) const;
     bool checkDeviceExtensionsSupported(VkPhysicalDevice device) const;
+    bool isDeviceExtensionSupported(VkPhysicalDevice device, const char* extension) const;
+    void queryMemoryBudget();
+    [[nodiscard]] HeapBudget estimateHeapBudget(std::uint32_t heapIndex) const;
+    void relieveMemoryPressure(std::uint32_t heapIndex, VkDeviceSize incomingSize);
     SwapchainSupportDetails querySwapchainSupport(VkPhysicalDevice device) const;
     std::uint32_t findMemoryType(std::uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    std::optional<std::uint32_t> tryFindMemoryType(std::uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    VkBuffer createBufferHandle(VkDeviceSize size, VkBufferUsageFlags usage);
 };
 
 } // !rr
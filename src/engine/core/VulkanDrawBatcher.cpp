@@ -0,0 +1,144 @@
+#include "VulkanDrawBatcher.hpp"
+
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "core/VulkanMesh.hpp"
+#include "core/VulkanPipeline.hpp"
+#include "mesh/InstanceData.hpp"
+#include "scene/RenderQueue.hpp"
+#include "utility/Hasher.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace rr
+{
+
+namespace
+{
+
+/** A frame binds few distinct pipelines and meshes, a linear search beats hashing at that size */
+template<typename T>
+std::uint32_t denseId(std::vector<T>& ids, const T& value)
+{
+    const auto it{ std::ranges::find(ids, value) };
+    if(it != ids.end())
+        return static_cast<std::uint32_t>(it - ids.begin());
+
+    ids.push_back(value);
+    return static_cast<std::uint32_t>(ids.size() - 1);
+}
+
+} // !namespace
+
+void VulkanDrawBatcher::submit(VulkanPipeline& pipeline, const VulkanMesh& mesh, const InstanceData& instance, std::size_t lod, const DrawOrder& order)
+{
+    const auto pipelineId{ denseId<const VulkanPipeline*>(m_pipelineIds, &pipeline) };
+    const auto meshId{ denseId(m_meshIds, MeshLevel{ .mesh = &mesh, .lod = lod }) };
+
+    m_queue.push(SortKey::make(order, pipelineId, meshId), static_cast<std::uint32_t>(m_submissions.size()));
+    m_submissions.push_back({ .pipeline = &pipeline, .mesh = &mesh, .lod = lod });
+    m_instances.push_back(instance);
+}
+
+std::size_t VulkanDrawBatcher::record(VkCommandBuffer cmdBuffer, VulkanFrameAllocator& frameAllocator, GeometryBindState& boundGeometry)
+{
+    const std::size_t drawCount{ prepare(frameAllocator) };
+    recordDraws(cmdBuffer, 0, drawCount, boundGeometry);
+
+    return drawCount;
+}
+
+/**
+ *  Submissions that share pipeline, mesh and level of detail only end up next to each other if their sort keys only
+ *  differ in depth, e.g. translucent draws are interleaved by depth and therefore drawn in smaller runs.
+*/
+std::size_t VulkanDrawBatcher::prepare(VulkanFrameAllocator& frameAllocator)
+{
+    m_draws.clear();
+    m_drawInstances = {};
+    if(m_submissions.empty())
+        return 0;
+
+    m_queue.sort();
+    const auto items{ m_queue.items() };
+
+    // NOTE: instances are written in sorted order straight into the frame, so every run is a contiguous range of one
+    //       instance buffer bind and only needs its first instance
+    m_drawInstances = frameAllocator.allocateVertices(sizeof(InstanceData) * items.size());
+    auto* const instanceData{ static_cast<InstanceData*>(m_drawInstances.data) };
+    for(std::size_t i{ 0 }; i < items.size(); ++i)
+        std::memcpy(instanceData + i, &m_instances[items[i].index], sizeof(InstanceData));
+
+    for(std::size_t first{ 0 }; first < items.size();)
+    {
+        const auto& state{ m_submissions[items[first].index] };
+
+        std::size_t last{ first + 1 };
+        while(last < items.size() && m_submissions[items[last].index] == state)
+            ++last;
+
+        m_draws.push_back({ .state = state, .firstInstance = static_cast<std::uint32_t>(first), .instanceCount = static_cast<std::uint32_t>(last - first) });
+        first = last;
+    }
+
+    m_submissions.clear();
+    m_instances.clear();
+    m_queue.clear();
+    m_pipelineIds.clear();
+    m_meshIds.clear();
+
+    return m_draws.size();
+}
+
+void VulkanDrawBatcher::recordDraws(VkCommandBuffer cmdBuffer, std::size_t first, std::size_t last, GeometryBindState& boundGeometry) const
+{
+    assert(first <= last && last <= m_draws.size() && "Draw range out of bounds");
+
+    if(first == last)
+        return;
+
+    vkCmdBindVertexBuffers(cmdBuffer, INSTANCE_BINDING, 1, &m_drawInstances.buffer, &m_drawInstances.offset);
+
+    const VulkanPipeline* boundPipeline{ nullptr };
+    for(const auto& draw : std::span{ m_draws }.subspan(first, last - first))
+    {
+        if(draw.state.pipeline != boundPipeline)
+        {
+            draw.state.pipeline->bind(cmdBuffer);
+            boundPipeline = draw.state.pipeline;
+        }
+
+        draw.state.mesh->bind(cmdBuffer, boundGeometry);
+        draw.state.mesh->drawInstanceRange(cmdBuffer, draw.firstInstance, draw.instanceCount, draw.state.lod);
+    }
+}
+
+std::uint64_t VulkanDrawBatcher::hashDraws(std::size_t first, std::size_t last) const
+{
+    assert(first <= last && last <= m_draws.size() && "Draw range out of bounds");
+
+    Hasher hasher{};
+    hasher.add(m_drawInstances.buffer).add(m_drawInstances.offset);
+    for(const auto& draw : std::span{ m_draws }.subspan(first, last - first))
+    {
+        const auto& mesh{ *draw.state.mesh };
+        hasher.add(draw.state.pipeline).add(draw.state.mesh).add(draw.state.lod).add(draw.firstInstance).add(draw.instanceCount);
+
+        // NOTE: a mesh that was uploaded again may live in another block of the geometry pool
+        hasher.add(mesh.getVertexBufferHandle()).add(mesh.getFirstVertex());
+        if(mesh.isIndexed())
+            hasher.add(mesh.getIndexBufferHandle()).add(mesh.getFirstIndex()).add(mesh.getIndexType());
+    }
+
+    return hasher.value();
+}
+
+} // !rr
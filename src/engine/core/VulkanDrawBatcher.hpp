@@ -0,0 +1,101 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_DRAW_BATCHER_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_DRAW_BATCHER_HPP
+
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "core/VulkanMesh.hpp"
+#include "core/VulkanPipeline.hpp"
+#include "mesh/InstanceData.hpp"
+#include "scene/RenderQueue.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>VulkanDrawBatcher<\code> turns individual draw submissions into instanced draws. Objects are submitted one by
+ *  one during a frame, every submission gets a <code>SortKey<\code> from its <code>DrawOrder<\code>, pipeline, mesh
+ *  and level of detail. <code>record()<\code> sorts them in a <code>RenderQueue<\code>, streams the instances into
+ *  the frame allocator in sorted order and records a single instanced draw per run of submissions that share
+ *  pipeline, mesh and level of detail. Pipelines, geometry and the instance buffer are only bound when they change.
+ *
+ *  Submitted pipelines have to use the <code>InstancedVertex<\code> layout and must not need any descriptor that
+ *  differs between draws, everything per object has to live in <code>InstanceData<\code>.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanDrawBatcher
+{
+public:
+    VulkanDrawBatcher() = default;
+    ~VulkanDrawBatcher() = default;
+
+    VulkanDrawBatcher(const VulkanDrawBatcher&) = delete;
+    VulkanDrawBatcher(VulkanDrawBatcher&&) = delete;
+    VulkanDrawBatcher& operator=(const VulkanDrawBatcher&) = delete;
+    VulkanDrawBatcher& operator=(VulkanDrawBatcher&&) = delete;
+
+    void submit(VulkanPipeline& pipeline, const VulkanMesh& mesh, const InstanceData& instance, std::size_t lod = 0, const DrawOrder& order = {});
+
+    /** Record all submissions since the last call and forget them, returns the number of draws recorded */
+    std::size_t record(VkCommandBuffer cmdBuffer, VulkanFrameAllocator& frameAllocator, GeometryBindState& boundGeometry);
+
+    /** Sort all submissions since the last call into draws and stream their instances, then forget them. Returns the
+     *  number of draws, which stay available to <code>recordDraws()<\code> until the next call */
+    std::size_t prepare(VulkanFrameAllocator& frameAllocator);
+    /** Record the prepared draws <code>[first, last)<\code>. Only reads the prepared draws, so disjoint ranges can be
+     *  recorded into different command buffers from different threads at the same time */
+    void recordDraws(VkCommandBuffer cmdBuffer, std::size_t first, std::size_t last, GeometryBindState& boundGeometry) const;
+    /** Hash of everything <code>recordDraws()<\code> would record for <code>[first, last)<\code>, equal hashes record
+     *  equal commands. Pipelines are hashed by address, recreating one requires dropping commands recorded with it */
+    [[nodiscard]] std::uint64_t hashDraws(std::size_t first, std::size_t last) const;
+
+    [[nodiscard]] std::size_t submissionCount() const { return m_submissions.size(); }
+    [[nodiscard]] std::size_t drawCount() const { return m_draws.size(); }
+
+private:
+    struct Submission
+    {
+        VulkanPipeline* pipeline;
+        const VulkanMesh* mesh;
+        std::size_t lod;
+
+        bool operator==(const Submission&) const = default;
+    };
+
+    struct MeshLevel
+    {
+        const VulkanMesh* mesh;
+        std::size_t lod;
+
+        bool operator==(const MeshLevel&) const = default;
+    };
+
+    struct Draw
+    {
+        Submission state;
+        std::uint32_t firstInstance;
+        std::uint32_t instanceCount;
+    };
+
+    std::vector<Submission> m_submissions;
+    std::vector<InstanceData> m_instances;
+    RenderQueue m_queue;
+
+    std::vector<Draw> m_draws;
+    FrameAllocation m_drawInstances;
+
+    // NOTE: sort keys only have a few bits per state, so everything bound gets a dense id per frame
+    std::vector<const VulkanPipeline*> m_pipelineIds;
+    std::vector<MeshLevel> m_meshIds;
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_DRAW_BATCHER_HPP
@@ -0,0 +1,156 @@
+#include "VulkanFrameAllocator.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "utility/FreeListAllocator.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace rr
+{
+
+VulkanFrameAllocator::VulkanFrameAllocator(VulkanDevice& device, std::uint32_t framesInFlight, VkDeviceSize frameCapacity)
+    : device(device)
+    , m_framesInFlight(framesInFlight)
+    , m_uniformAlignment(std::max<VkDeviceSize>(device.getProperties().limits.minUniformBufferOffsetAlignment, 1))
+{
+    // NOTE: every frame region starts at an offset that is valid for all allocation kinds
+    const VkDeviceSize regionAlignment{ std::max(m_uniformAlignment, VERTEX_ALIGNMENT) };
+    m_frameCapacity = FreeListAllocator::alignUp(frameCapacity, regionAlignment);
+
+    // NOTE: the tail padding keeps the descriptor range of the last uniform allocation inside the buffer
+    device.createBuffer(
+        m_frameCapacity * m_framesInFlight + MAX_UNIFORM_RANGE,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        m_buffer,
+        m_allocation,
+        MemoryCategory::STAGING);
+
+    createDescriptorSet();
+
+    spdlog::info("Frame allocator created with {} frame(s) of {} bytes", m_framesInFlight, m_frameCapacity);
+}
+
+VulkanFrameAllocator::~VulkanFrameAllocator()
+{
+    vkDestroyDescriptorPool(device.getHandle(), m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device.getHandle(), m_descriptorSetLayout, nullptr);
+    device.destroyBuffer(m_buffer, m_allocation);
+}
+
+/**
+ *  Start handing out memory from the region of <code>frameIndex<\code>. Everything that was allocated the last time
+ *  this frame was recorded is overwritten afterwards.
+*/
+void VulkanFrameAllocator::beginFrame(std::size_t frameIndex)
+{
+    assert(frameIndex < m_framesInFlight && "Frame index out of range");
+
+    m_frameBegin = m_frameCapacity * frameIndex;
+    m_offset = m_frameBegin;
+}
+
+FrameAllocation VulkanFrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    const VkDeviceSize offset{ FreeListAllocator::alignUp(m_offset, alignment) };
+
+    if(offset + size > m_frameBegin + m_frameCapacity)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::FRAME_ALLOCATOR_EXHAUSTED);
+
+    m_offset = offset + size;
+    m_peakUsedBytes = std::max(m_peakUsedBytes, usedBytes());
+
+    return {
+        .buffer = m_buffer,
+        .offset = offset,
+        .size = size,
+        .data = static_cast<std::byte*>(m_allocation.mappedData) + offset
+    };
+}
+
+FrameAllocation VulkanFrameAllocator::allocateUniform(VkDeviceSize size)
+{
+    assert(size <= MAX_UNIFORM_RANGE && "Uniform data does not fit into the dynamic uniform range");
+
+    return allocate(size, m_uniformAlignment);
+}
+
+void VulkanFrameAllocator::createDescriptorSet()
+{
+    // NOTE: meshlet culling reads the per draw data in compute and task shaders as well
+    VkShaderStageFlags stageFlags{ VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT };
+    if(device.supportsMeshShaders())
+        stageFlags |= VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+
+    VkDescriptorSetLayoutBinding binding{
+        .binding = 0,
+        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        .descriptorCount = 1,
+        .stageFlags = stageFlags
+    };
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = 1,
+        .pBindings = &binding
+    };
+
+    if(vkCreateDescriptorSetLayout(device.getHandle(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DESCRIPTOR_SET_LAYOUT);
+
+    VkDescriptorPoolSize poolSize{
+        .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        .descriptorCount = 1
+    };
+
+    VkDescriptorPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize
+    };
+
+    if(vkCreateDescriptorPool(device.getHandle(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DESCRIPTOR_POOL);
+
+    VkDescriptorSetAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = m_descriptorPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &m_descriptorSetLayout
+    };
+
+    if(vkAllocateDescriptorSets(device.getHandle(), &allocInfo, &m_descriptorSet) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_DESCRIPTOR_SETS);
+
+    // NOTE: the descriptor covers the start of the buffer, the dynamic offset moves it to the actual allocation
+    VkDescriptorBufferInfo bufferInfo{
+        .buffer = m_buffer,
+        .offset = 0,
+        .range = MAX_UNIFORM_RANGE
+    };
+
+    VkWriteDescriptorSet write{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = m_descriptorSet,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        .pBufferInfo = &bufferInfo
+    };
+
+    vkUpdateDescriptorSets(device.getHandle(), 1, &write, 0, nullptr);
+}
+
+} // !rr
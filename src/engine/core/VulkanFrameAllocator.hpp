@@ -0,0 +1,121 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_FRAME_ALLOCATOR_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_FRAME_ALLOCATOR_HPP
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace rr
+{
+
+/**
+ *  Sub-range of the frame buffer that is valid until the same frame in flight comes around again.
+*/
+struct FrameAllocation
+{
+    VkBuffer buffer{ VK_NULL_HANDLE };
+    VkDeviceSize offset{ 0 };
+    VkDeviceSize size{ 0 };
+    void* data{ nullptr };
+
+    /** Offset to pass to <code>vkCmdBindDescriptorSets<\code> for the dynamic uniform binding */
+    [[nodiscard]] std::uint32_t dynamicOffset() const { return static_cast<std::uint32_t>(offset); }
+
+    /** Part of this allocation, e.g. to bind a range of the instances that were streamed together */
+    [[nodiscard]] FrameAllocation slice(VkDeviceSize sliceOffset, VkDeviceSize sliceSize) const
+    {
+        return { .buffer = buffer, .offset = offset + sliceOffset, .size = sliceSize, .data = static_cast<std::byte*>(data) + sliceOffset };
+    }
+};
+
+/**
+ *  <code>VulkanFrameAllocator<\code> is a linear allocator for data that only lives for a single frame, e.g. per draw
+ *  uniforms or streamed vertices. One persistently mapped buffer is split into a region per frame in flight and
+ *  allocations just bump an offset inside the region of the current frame. The region is reset in
+ *  <code>beginFrame()<\code>, which must only be called after the fence of that frame signaled.
+ *
+ *  Uniform allocations are read through a single <code>VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC<\code> descriptor
+ *  that covers the whole buffer, so every draw only needs a different dynamic offset.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanFrameAllocator
+{
+public:
+    VulkanFrameAllocator(VulkanDevice& device, std::uint32_t framesInFlight, VkDeviceSize frameCapacity = DEFAULT_FRAME_CAPACITY);
+    ~VulkanFrameAllocator();
+
+    VulkanFrameAllocator(const VulkanFrameAllocator&) = delete;
+    VulkanFrameAllocator(VulkanFrameAllocator&&) = delete;
+    VulkanFrameAllocator& operator=(const VulkanFrameAllocator&) = delete;
+    VulkanFrameAllocator& operator=(VulkanFrameAllocator&&) = delete;
+
+    static constexpr VkDeviceSize DEFAULT_FRAME_CAPACITY{ 4ULL * 1024 * 1024 };
+    static constexpr VkDeviceSize MAX_UNIFORM_RANGE{ 256 };
+    static constexpr VkDeviceSize VERTEX_ALIGNMENT{ 16 };
+
+    void beginFrame(std::size_t frameIndex);
+
+    [[nodiscard]] FrameAllocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+    [[nodiscard]] FrameAllocation allocateUniform(VkDeviceSize size);
+    [[nodiscard]] FrameAllocation allocateVertices(VkDeviceSize size) { return allocate(size, VERTEX_ALIGNMENT); }
+
+    template<typename T>
+    [[nodiscard]] FrameAllocation pushUniform(const T& data)
+    {
+        static_assert(sizeof(T) <= MAX_UNIFORM_RANGE, "Uniform data does not fit into the dynamic uniform range");
+
+        auto allocation{ allocateUniform(sizeof(T)) };
+        std::memcpy(allocation.data, &data, sizeof(T));
+
+        return allocation;
+    }
+
+    /** Copy e.g. per instance attributes into the frame, the allocation can be bound as a vertex buffer */
+    template<typename T>
+    [[nodiscard]] FrameAllocation pushVertices(std::span<const T> data)
+    {
+        auto allocation{ allocateVertices(data.size_bytes()) };
+        std::memcpy(allocation.data, data.data(), data.size_bytes());
+
+        return allocation;
+    }
+
+    [[nodiscard]] VkBuffer getBufferHandle() const { return m_buffer; }
+    [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayoutHandle() const { return m_descriptorSetLayout; }
+    [[nodiscard]] VkDescriptorSet getDescriptorSetHandle() const { return m_descriptorSet; }
+
+    [[nodiscard]] VkDeviceSize frameCapacity() const { return m_frameCapacity; }
+    [[nodiscard]] VkDeviceSize usedBytes() const { return m_offset - m_frameBegin; }
+    [[nodiscard]] VkDeviceSize peakUsedBytes() const { return m_peakUsedBytes; }
+
+private:
+    VulkanDevice& device;
+
+    VkBuffer m_buffer{ VK_NULL_HANDLE };
+    VulkanAllocation m_allocation;
+    std::uint32_t m_framesInFlight;
+    VkDeviceSize m_frameCapacity;
+    VkDeviceSize m_uniformAlignment;
+
+    VkDeviceSize m_frameBegin{ 0 };
+    VkDeviceSize m_offset{ 0 };
+    VkDeviceSize m_peakUsedBytes{ 0 };
+
+    VkDescriptorSetLayout m_descriptorSetLayout{ VK_NULL_HANDLE };
+    VkDescriptorPool m_descriptorPool{ VK_NULL_HANDLE };
+    VkDescriptorSet m_descriptorSet{ VK_NULL_HANDLE };
+
+    void createDescriptorSet();
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_FRAME_ALLOCATOR_HPP
@@ -0,0 +1,79 @@
+#include "VulkanFrameContext.hpp"
+
+#include "core/VulkanCommandPool.hpp"
+#include "core/VulkanDevice.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rr
+{
+
+VulkanFrameContext::VulkanFrameContext(VulkanDevice& device, std::uint32_t framesInFlight)
+    : device(device)
+{
+    m_frames.resize(framesInFlight);
+    for(auto& frame : m_frames)
+    {
+        frame.pool = std::make_unique<VulkanCommandPool>(device, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        frame.persistentPool = std::make_unique<VulkanCommandPool>(device, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    }
+}
+
+void VulkanFrameContext::beginFrame(std::size_t frameIndex)
+{
+    assert(frameIndex < m_frames.size() && "Frame index out of range");
+
+    m_currentFrame = frameIndex;
+    auto& frame{ m_frames[frameIndex] };
+
+    // NOTE: a pool nothing was recorded from since its last reset has nothing to give back
+    if(frame.primary.usedCount == 0 && frame.secondary.usedCount == 0)
+        return;
+
+    frame.pool->reset();
+    frame.primary.usedCount = 0;
+    frame.secondary.usedCount = 0;
+}
+
+VkCommandBuffer VulkanFrameContext::acquire(VkCommandBufferLevel level)
+{
+    auto& frame{ m_frames[m_currentFrame] };
+    auto& recycler{ level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? frame.primary : frame.secondary };
+
+    if(recycler.usedCount == recycler.buffers.size())
+        recycler.buffers.push_back(allocate(frame.pool->getHandle(), level));
+
+    return recycler.buffers[recycler.usedCount++];
+}
+
+VkCommandBuffer VulkanFrameContext::allocatePersistent(VkCommandBufferLevel level)
+{
+    return allocate(m_frames[m_currentFrame].persistentPool->getHandle(), level);
+}
+
+VkCommandBuffer VulkanFrameContext::allocate(VkCommandPool pool, VkCommandBufferLevel level) const
+{
+    VkCommandBufferAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = pool,
+        .level = level,
+        .commandBufferCount = 1
+    };
+
+    VkCommandBuffer cmdBuffer{ VK_NULL_HANDLE };
+    if(vkAllocateCommandBuffers(device.getHandle(), &allocInfo, &cmdBuffer) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_COMMAND_BUFFERS);
+
+    return cmdBuffer;
+}
+
+} // !rr
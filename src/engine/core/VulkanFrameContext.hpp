@@ -0,0 +1,79 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_FRAME_CONTEXT_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_FRAME_CONTEXT_HPP
+
+#include "core/VulkanCommandPool.hpp"
+#include "core/VulkanDevice.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>VulkanFrameContext<\code> hands out the command buffers a frame records into. Every frame in flight owns a
+ *  transient command pool, which is reset as a whole in <code>beginFrame()<\code> instead of resetting or freeing
+ *  single command buffers. The command buffers of a pool are kept as plain handles and recycled, once a frame
+ *  acquired as many as it will need, acquiring does not allocate anymore.
+ *
+ *  Command buffers that are recorded once and executed in many frames come from a second pool per frame, which allows
+ *  resetting single command buffers and is never reset as a whole.
+ *
+ *  A frame context must only be used by one thread at a time, threads that record in parallel need their own.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanFrameContext
+{
+public:
+    VulkanFrameContext(VulkanDevice& device, std::uint32_t framesInFlight);
+    ~VulkanFrameContext() = default;
+
+    VulkanFrameContext(const VulkanFrameContext&) = delete;
+    VulkanFrameContext(VulkanFrameContext&&) = delete;
+    VulkanFrameContext& operator=(const VulkanFrameContext&) = delete;
+    VulkanFrameContext& operator=(VulkanFrameContext&&) = delete;
+
+    /** Reset the pool of <code>frameIndex<\code>, must only be called after the fence of that frame signaled */
+    void beginFrame(std::size_t frameIndex);
+    /** A command buffer of the current frame in the initial state, valid until the next <code>beginFrame()<\code>
+     *  of the same frame */
+    [[nodiscard]] VkCommandBuffer acquire(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    /** A command buffer of the current frame that is not touched by <code>beginFrame()<\code>, it lives as long as
+     *  the frame context and is reset whenever it is begun again */
+    [[nodiscard]] VkCommandBuffer allocatePersistent(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    [[nodiscard]] std::size_t getCurrentFrame() const { return m_currentFrame; }
+
+private:
+    struct Recycler
+    {
+        /** Destroying the pool frees its command buffers, they are never freed one by one */
+        std::vector<VkCommandBuffer> buffers;
+        std::size_t usedCount{ 0 };
+    };
+
+    struct Frame
+    {
+        std::unique_ptr<VulkanCommandPool> pool;
+        std::unique_ptr<VulkanCommandPool> persistentPool;
+        Recycler primary;
+        Recycler secondary;
+    };
+
+    VulkanDevice& device;
+
+    std::vector<Frame> m_frames;
+    std::size_t m_currentFrame{ 0 };
+
+    [[nodiscard]] VkCommandBuffer allocate(VkCommandPool pool, VkCommandBufferLevel level) const;
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_FRAME_CONTEXT_HPP
@@ -0,0 +1,385 @@
+#include "VulkanGeometryPool.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanSwapchain.hpp"
+#include "core/VulkanUploadScheduler.hpp"
+#include "utility/FreeListAllocator.hpp"
+
+#include "spdlog/spdlog.h"
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rr
+{
+
+VulkanGeometryPool::VulkanGeometryPool(VulkanDevice& device, VkDeviceSize vertexBlockSize, VkDeviceSize indexBlockSize, VkDeviceSize copyBudgetPerFrame)
+    : device(device)
+    , copyBudgetPerFrame(copyBudgetPerFrame)
+    // NOTE: storage usage lets mesh shaders fetch vertices and indices themselves, transfer source lets compaction copy ranges between blocks
+    , m_vertexBlocks{ .blockSize = vertexBlockSize, .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, .blocks = {}, .sources = {} }
+    , m_indexBlocks{ .blockSize = indexBlockSize, .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, .blocks = {}, .sources = {} }
+{}
+
+VulkanGeometryPool::~VulkanGeometryPool()
+{
+    for(auto* const list : { &m_vertexBlocks, &m_indexBlocks })
+    {
+        for(auto& block : list->blocks)
+        {
+            if(block != nullptr)
+                destroyBlock(*block);
+        }
+    }
+}
+
+/**
+ *  Ranges are taken from the first block with room, only if none has room a new block is created. Blocks that are
+ *  evacuated by a compaction pass are only used if no other block has room.
+*/
+GeometryAllocation VulkanGeometryPool::upload(GeometryKind kind, const void* data, VkDeviceSize size, VkDeviceSize elementSize, GeometryRelocationCallback onRelocated)
+{
+    assert(size > 0 && elementSize > 0 && "Cannot allocate empty geometry");
+    assert(size % elementSize == 0 && "Geometry has to consist of whole elements");
+
+    GeometryAllocation result{ .block = 0, .offset = 0, .size = size, .uploadValue = 0 };
+    {
+        std::scoped_lock lock{ m_mutex };
+        auto& list{ blocksOf(kind) };
+
+        auto offset{ allocateRange(list, size, elementSize, false, result.block) };
+        if(!offset.has_value())
+            offset = allocateRange(list, size, elementSize, true, result.block);
+
+        if(!offset.has_value())
+        {
+            result.block = createBlock(list, std::max(list.blockSize, size));
+            offset = list.blocks[result.block]->ranges.allocate(size, elementSize);
+            assert(offset.has_value() && "A new block always has room for the data it was created for");
+        }
+
+        result.offset = offset.value();
+
+        // NOTE: the range must not be moved before the upload into it is known
+        list.blocks[result.block]->live.emplace(result.offset, Range{
+            .size = size,
+            .elementSize = elementSize,
+            .uploadValue = std::numeric_limits<std::uint64_t>::max(),
+            .onRelocated = std::move(onRelocated)
+        });
+    }
+
+    // NOTE: the copy is only recorded here, it is submitted with the next flush of the upload scheduler
+    result.uploadValue = device.getUploadScheduler().uploadToBuffer(getBufferHandle(kind, result.block), result.offset, data, size);
+
+    std::scoped_lock lock{ m_mutex };
+    blocksOf(kind).blocks[result.block]->live.at(result.offset).uploadValue = result.uploadValue;
+
+    return result;
+}
+
+/**
+ *  Release a range. Like destroying a buffer, this must only happen once no frame in flight reads the range anymore.
+*/
+void VulkanGeometryPool::free(GeometryKind kind, const GeometryAllocation& allocation)
+{
+    std::scoped_lock lock{ m_mutex };
+    auto& list{ blocksOf(kind) };
+
+    assert(allocation.block < list.blocks.size() && list.blocks[allocation.block] != nullptr && "Allocation does not belong to this pool");
+
+    list.blocks[allocation.block]->live.erase(allocation.offset);
+    releaseRange(list, allocation.block, allocation.offset);
+}
+
+void VulkanGeometryPool::pin(GeometryKind kind, const GeometryAllocation& allocation)
+{
+    std::scoped_lock lock{ m_mutex };
+    auto& list{ blocksOf(kind) };
+
+    assert(allocation.block < list.blocks.size() && list.blocks[allocation.block] != nullptr && "Allocation does not belong to this pool");
+
+    const auto range{ list.blocks[allocation.block]->live.find(allocation.offset) };
+    assert(range != list.blocks[allocation.block]->live.end() && "Allocation does not belong to this pool");
+
+    range->second.onRelocated = nullptr;
+
+    // NOTE: the block cannot become empty anymore, so a running pass stops evacuating it
+    std::erase(list.sources, allocation.block);
+}
+
+/**
+ *  Start a compaction pass right away instead of waiting for the next interval.
+*/
+void VulkanGeometryPool::beginCompaction()
+{
+    std::scoped_lock lock{ m_mutex };
+
+    if(!m_passActive)
+        startPass();
+}
+
+/**
+ *  Record the moves for this frame into <code>commandBuffer<\code>. Has to be called after the fence of the frame
+ *  signaled and before anything that draws geometry of the pool is recorded.
+*/
+void VulkanGeometryPool::recordMoves(VkCommandBuffer commandBuffer)
+{
+    std::scoped_lock lock{ m_mutex };
+
+    ++m_frame;
+    retireRanges();
+
+    if(!m_passActive && m_frame % PASS_INTERVAL == 0)
+        startPass();
+
+    if(!m_passActive)
+        return;
+
+    VkDeviceSize moved{ moveRanges(commandBuffer, GeometryKind::VERTEX, copyBudgetPerFrame) };
+    moved += moveRanges(commandBuffer, GeometryKind::INDEX, moved < copyBudgetPerFrame ? copyBudgetPerFrame - moved : 0);
+
+    if(moved > 0)
+    {
+        VkPipelineStageFlags dstStages{ VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT };
+        if(device.supportsMeshShaders())
+            dstStages |= VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT;
+
+        VkMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+        };
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    // NOTE: evacuated blocks stop being sources once they are released, which happens with their last moved range
+    if(m_vertexBlocks.sources.empty() && m_indexBlocks.sources.empty() && m_retired.empty())
+    {
+        m_passActive = false;
+        spdlog::info("geometry pool: compaction pass finished");
+    }
+}
+
+bool VulkanGeometryPool::isCompacting() const
+{
+    std::scoped_lock lock{ m_mutex };
+
+    return m_passActive;
+}
+
+VkBuffer VulkanGeometryPool::getBufferHandle(GeometryKind kind, std::uint32_t block) const
+{
+    std::scoped_lock lock{ m_mutex };
+    const auto& list{ blocksOf(kind) };
+
+    assert(block < list.blocks.size() && list.blocks[block] != nullptr && "Block does not exist");
+
+    return list.blocks[block]->buffer;
+}
+
+std::size_t VulkanGeometryPool::blockCount(GeometryKind kind) const
+{
+    std::scoped_lock lock{ m_mutex };
+
+    return static_cast<std::size_t>(std::ranges::count_if(blocksOf(kind).blocks, [](const auto& block) { return block != nullptr; }));
+}
+
+VkDeviceSize VulkanGeometryPool::usedBytes(GeometryKind kind) const
+{
+    std::scoped_lock lock{ m_mutex };
+
+    VkDeviceSize result{ 0 };
+    for(const auto& block : blocksOf(kind).blocks)
+    {
+        if(block != nullptr)
+            result += block->ranges.usedSize();
+    }
+
+    return result;
+}
+
+/**
+ *  First fit over the blocks of <code>list<\code>, either over the ones that are evacuated or over all others.
+ *
+ *  @param block - index of the block the range was allocated from
+*/
+std::optional<std::uint64_t> VulkanGeometryPool::allocateRange(BlockList& list, VkDeviceSize size, VkDeviceSize elementSize, bool fromSources, std::uint32_t& block)
+{
+    for(std::size_t i{ 0 }; i < list.blocks.size(); ++i)
+    {
+        const auto index{ static_cast<std::uint32_t>(i) };
+        if(list.blocks[i] == nullptr || (std::ranges::find(list.sources, index) != list.sources.end()) != fromSources)
+            continue;
+
+        const auto offset{ list.blocks[i]->ranges.allocate(size, elementSize) };
+        if(offset.has_value())
+        {
+            block = index;
+            return offset;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void VulkanGeometryPool::releaseRange(BlockList& list, std::uint32_t block, VkDeviceSize offset)
+{
+    auto& entry{ list.blocks[block] };
+    entry->ranges.free(offset);
+
+    if(entry->ranges.empty() && block > 0)
+    {
+        destroyBlock(*entry);
+        entry.reset();
+
+        // NOTE: the slot can be taken by a new block, which must not be evacuated
+        std::erase(list.sources, block);
+    }
+}
+
+std::uint32_t VulkanGeometryPool::createBlock(BlockList& list, VkDeviceSize size)
+{
+    auto block{ std::make_unique<Block>(Block{ .buffer = VK_NULL_HANDLE, .allocation = {}, .ranges = FreeListAllocator{ size } }) };
+    device.createBuffer(size, list.usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, block->buffer, block->allocation, MemoryCategory::MESH);
+
+    spdlog::info("geometry pool: created {} block of {} bytes", &list == &m_vertexBlocks ? "vertex" : "index", size);
+
+    const auto slot{ std::ranges::find_if(list.blocks, [](const auto& candidate) { return candidate == nullptr; }) };
+    if(slot != list.blocks.end())
+    {
+        *slot = std::move(block);
+        return static_cast<std::uint32_t>(slot - list.blocks.begin());
+    }
+
+    list.blocks.push_back(std::move(block));
+    return static_cast<std::uint32_t>(list.blocks.size() - 1);
+}
+
+void VulkanGeometryPool::destroyBlock(Block& block)
+{
+    device.destroyBuffer(block.buffer, block.allocation);
+    block.buffer = VK_NULL_HANDLE;
+}
+
+/**
+ *  Pick the blocks to evacuate. Per kind the sparse blocks become sources, but the fullest block always stays as a
+ *  destination. The first block is never released and blocks with ranges that cannot be moved would not become
+ *  empty, so neither of them is evacuated.
+*/
+void VulkanGeometryPool::startPass()
+{
+    std::size_t sourceCount{ 0 };
+    for(auto* const list : { &m_vertexBlocks, &m_indexBlocks })
+    {
+        list->sources.clear();
+
+        const auto fullest{ std::ranges::max_element(list->blocks, std::less{}, [](const auto& block) { return block != nullptr ? block->ranges.usedSize() : 0; }) };
+        for(std::size_t i{ 1 }; i < list->blocks.size(); ++i)
+        {
+            const auto& block{ list->blocks[i] };
+            if(block == nullptr || list->blocks.begin() + static_cast<std::ptrdiff_t>(i) == fullest)
+                continue;
+
+            const bool sparse{ block->ranges.usedSize() * 100 < block->ranges.size() * SPARSE_BLOCK_PERCENT };
+            const bool movable{ std::ranges::all_of(block->live, [](const auto& range) { return static_cast<bool>(range.second.onRelocated); }) };
+            if(sparse && movable)
+                list->sources.push_back(static_cast<std::uint32_t>(i));
+        }
+
+        sourceCount += list->sources.size();
+    }
+
+    if(sourceCount == 0)
+        return;
+
+    m_passActive = true;
+
+    spdlog::info("geometry pool: compaction pass started, evacuating {} block(s)", sourceCount);
+}
+
+/**
+ *  Move the ranges out of the source blocks of <code>kind<\code> into the other blocks until <code>budget<\code>
+ *  is used up. The owners learn about the new ranges right away, the old ones are released once no frame in flight
+ *  can read them anymore. Ranges whose upload did not complete yet are moved in a later frame, but a block with a
+ *  range that cannot be moved or placed anywhere else stops being a source.
+ *
+ *  @returns VkDeviceSize - amount of bytes that were copied
+*/
+VkDeviceSize VulkanGeometryPool::moveRanges(VkCommandBuffer commandBuffer, GeometryKind kind, VkDeviceSize budget)
+{
+    auto& list{ blocksOf(kind) };
+    const auto& scheduler{ device.getUploadScheduler() };
+    VkDeviceSize moved{ 0 };
+    std::vector<std::uint32_t> stuck;
+
+    for(const auto sourceIndex : list.sources)
+    {
+        auto& source{ *list.blocks[sourceIndex] };
+        for(auto it{ source.live.begin() }; it != source.live.end() && moved < budget;)
+        {
+            auto& [offset, range]{ *it };
+
+            if(!scheduler.isComplete(range.uploadValue))
+            {
+                ++it;
+                continue;
+            }
+
+            // NOTE: ranges without a callback end up here when they are pinned or allocated from a source block
+            std::uint32_t target{ 0 };
+            const auto newOffset{ range.onRelocated ? allocateRange(list, range.size, range.elementSize, false, target) : std::nullopt };
+            if(!newOffset.has_value())
+            {
+                stuck.push_back(sourceIndex);
+                break;
+            }
+
+            auto& destination{ *list.blocks[target] };
+            const VkBufferCopy region{
+                .srcOffset = offset,
+                .dstOffset = newOffset.value(),
+                .size = range.size
+            };
+            vkCmdCopyBuffer(commandBuffer, source.buffer, destination.buffer, 1, &region);
+
+            m_retired.push_back({ .kind = kind, .block = sourceIndex, .offset = offset, .frame = m_frame });
+            range.onRelocated({ .block = target, .offset = newOffset.value(), .size = range.size, .uploadValue = range.uploadValue });
+            moved += range.size;
+
+            destination.live.emplace(newOffset.value(), std::move(range));
+            it = source.live.erase(it);
+        }
+    }
+
+    std::erase_if(list.sources, [&stuck](std::uint32_t index) { return std::ranges::find(stuck, index) != stuck.end(); });
+
+    return moved;
+}
+
+/**
+ *  Release the ranges that were moved away from once no frame in flight can use them anymore.
+*/
+void VulkanGeometryPool::retireRanges()
+{
+    while(!m_retired.empty() && m_retired.front().frame + VulkanSwapchain::MAX_FRAMES_IN_FLIGHT <= m_frame)
+    {
+        const auto retired{ m_retired.front() };
+        m_retired.pop_front();
+
+        releaseRange(blocksOf(retired.kind), retired.block, retired.offset);
+    }
+}
+
+} // !rr
@@ -0,0 +1,172 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_GEOMETRY_POOL_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_GEOMETRY_POOL_HPP
+
+#include "core/VulkanAllocator.hpp"
+#include "utility/FreeListAllocator.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace rr
+{
+
+class VulkanDevice;
+
+enum class GeometryKind : std::uint8_t
+{
+    VERTEX,
+    INDEX
+};
+
+/**
+ *  Range of a geometry pool block. <code>offset<\code> is a multiple of the element size it was allocated with, so it
+ *  can be turned into a first vertex or first index.
+*/
+struct GeometryAllocation
+{
+    std::uint32_t block{ 0 };
+    VkDeviceSize offset{ 0 };
+    VkDeviceSize size{ 0 };
+    /** Timeline value of the upload scheduler after which the data is resident */
+    std::uint64_t uploadValue{ 0 };
+};
+
+/** Called while recording a frame when a range was moved, every command recorded afterwards has to use the new one */
+using GeometryRelocationCallback = std::function<void(const GeometryAllocation& allocation)>;
+
+/**
+ *  Buffers currently bound in a command buffer. Meshes sharing the same pool blocks only bind them once.
+*/
+struct GeometryBindState
+{
+    VkBuffer vertexBuffer{ VK_NULL_HANDLE };
+    VkBuffer indexBuffer{ VK_NULL_HANDLE };
+    VkIndexType indexType{ VK_INDEX_TYPE_MAX_ENUM };
+};
+
+/**
+ *  <code>VulkanGeometryPool<\code> sub-allocates the vertex and index data of all static meshes out of a few large
+ *  device local buffers. Meshes only keep their offsets and draw with <code>firstVertex<\code>,
+ *  <code>vertexOffset<\code> and <code>firstIndex<\code>, so any number of meshes in the same block share a single
+ *  vertex and index buffer bind.
+ *
+ *  Blocks are created on demand, data that does not fit into a regular block gets a block of its own. Blocks that
+ *  become empty are released again, except for the first one of each kind. Ranges can be allocated from any thread.
+ *
+ *  Freed ranges leave holes behind that keep mostly empty blocks alive. Every now and then a compaction pass moves
+ *  the ranges out of such blocks into the others, so the emptied blocks can be released. Only ranges whose owner
+ *  passed a relocation callback are moved. Like defragmentation, moves are GPU copies recorded at the start of a frame
+ *  and capped to a copy budget per frame, the old range stays allocated until no frame in flight can read it anymore.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanGeometryPool
+{
+public:
+    explicit VulkanGeometryPool(VulkanDevice& device, VkDeviceSize vertexBlockSize = DEFAULT_VERTEX_BLOCK_SIZE, VkDeviceSize indexBlockSize = DEFAULT_INDEX_BLOCK_SIZE, VkDeviceSize copyBudgetPerFrame = DEFAULT_COPY_BUDGET);
+    ~VulkanGeometryPool();
+
+    VulkanGeometryPool(const VulkanGeometryPool&) = delete;
+    VulkanGeometryPool(VulkanGeometryPool&&) = delete;
+    VulkanGeometryPool& operator=(const VulkanGeometryPool&) = delete;
+    VulkanGeometryPool& operator=(VulkanGeometryPool&&) = delete;
+
+    static constexpr VkDeviceSize DEFAULT_VERTEX_BLOCK_SIZE{ 64ULL * 1024 * 1024 };
+    static constexpr VkDeviceSize DEFAULT_INDEX_BLOCK_SIZE{ 32ULL * 1024 * 1024 };
+    static constexpr VkDeviceSize DEFAULT_COPY_BUDGET{ 8ULL * 1024 * 1024 };
+    /** Blocks that are used less than this, in percent, are evacuated */
+    static constexpr VkDeviceSize SPARSE_BLOCK_PERCENT{ 50 };
+    /** A new compaction pass is considered every this many frames */
+    static constexpr std::uint64_t PASS_INTERVAL{ 600 };
+
+    /**
+     *  Allocate a range aligned to <code>elementSize<\code> and schedule the upload of <code>data<\code> into it.
+     *  Without <code>onRelocated<\code> the range stays where it is until it is freed.
+    */
+    [[nodiscard]] GeometryAllocation upload(GeometryKind kind, const void* data, VkDeviceSize size, VkDeviceSize elementSize, GeometryRelocationCallback onRelocated = {});
+    void free(GeometryKind kind, const GeometryAllocation& allocation);
+    /** Never move the range again, for users that copied its offset somewhere the relocation callback cannot reach */
+    void pin(GeometryKind kind, const GeometryAllocation& allocation);
+
+    void beginCompaction();
+    void recordMoves(VkCommandBuffer commandBuffer);
+    [[nodiscard]] bool isCompacting() const;
+
+    [[nodiscard]] VkBuffer getBufferHandle(GeometryKind kind, std::uint32_t block) const;
+    [[nodiscard]] std::size_t blockCount(GeometryKind kind) const;
+    [[nodiscard]] VkDeviceSize usedBytes(GeometryKind kind) const;
+
+private:
+    struct Range
+    {
+        VkDeviceSize size;
+        VkDeviceSize elementSize;
+        /** Ranges are only moved once their upload completed */
+        std::uint64_t uploadValue;
+        GeometryRelocationCallback onRelocated;
+    };
+
+    struct Block
+    {
+        VkBuffer buffer{ VK_NULL_HANDLE };
+        VulkanAllocation allocation;
+        FreeListAllocator ranges;
+        /** offset -> live range, ranges that were moved away from are only kept in <code>ranges<\code> */
+        std::map<VkDeviceSize, Range> live;
+    };
+
+    struct BlockList
+    {
+        VkDeviceSize blockSize;
+        VkBufferUsageFlags usage;
+        /** Released blocks leave an empty slot behind, so block indices of live allocations stay valid */
+        std::vector<std::unique_ptr<Block>> blocks;
+        /** Blocks that are evacuated by the current compaction pass */
+        std::vector<std::uint32_t> sources;
+    };
+
+    struct RetiredRange
+    {
+        GeometryKind kind;
+        std::uint32_t block;
+        VkDeviceSize offset;
+        std::uint64_t frame;
+    };
+
+    VulkanDevice& device;
+    VkDeviceSize copyBudgetPerFrame;
+
+    mutable std::mutex m_mutex;
+    BlockList m_vertexBlocks;
+    BlockList m_indexBlocks;
+
+    std::deque<RetiredRange> m_retired;
+    std::uint64_t m_frame{ 0 };
+    bool m_passActive{ false };
+
+    [[nodiscard]] BlockList& blocksOf(GeometryKind kind) { return kind == GeometryKind::VERTEX ? m_vertexBlocks : m_indexBlocks; }
+    [[nodiscard]] const BlockList& blocksOf(GeometryKind kind) const { return kind == GeometryKind::VERTEX ? m_vertexBlocks : m_indexBlocks; }
+
+    [[nodiscard]] std::optional<std::uint64_t> allocateRange(BlockList& list, VkDeviceSize size, VkDeviceSize elementSize, bool fromSources, std::uint32_t& block);
+    void releaseRange(BlockList& list, std::uint32_t block, VkDeviceSize offset);
+    [[nodiscard]] std::uint32_t createBlock(BlockList& list, VkDeviceSize size);
+    void destroyBlock(Block& block);
+
+    void startPass();
+    [[nodiscard]] VkDeviceSize moveRanges(VkCommandBuffer commandBuffer, GeometryKind kind, VkDeviceSize budget);
+    void retireRanges();
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_GEOMETRY_POOL_HPP
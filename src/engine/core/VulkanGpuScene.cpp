@@ -0,0 +1,298 @@
+#include "VulkanGpuScene.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "core/VulkanMesh.hpp"
+#include "core/VulkanPipeline.hpp"
+#include "core/VulkanPipelineLayout.hpp"
+#include "core/VulkanUploadScheduler.hpp"
+#include "mesh/InstanceData.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rr
+{
+
+static_assert(sizeof(GpuObject) == 80 && offsetof(GpuObject, indexCount) == 64, "Objects have to follow the std430 layout of the culling shader");
+static_assert(sizeof(GpuCullData) <= VulkanFrameAllocator::MAX_UNIFORM_RANGE, "Culling data does not fit into the dynamic uniform range");
+
+VulkanGpuScene::VulkanGpuScene(VulkanDevice& device, VkDescriptorSetLayout frameSetLayout, std::uint32_t framesInFlight, std::uint32_t maxObjects)
+    : device(device)
+    , maxObjects(maxObjects)
+{
+    assert(device.supportsDrawIndirectCount() && "GPU driven rendering needs drawIndirectCount");
+
+    m_frames.resize(framesInFlight);
+    createBuffers();
+    createDescriptorSets(framesInFlight);
+
+    m_pipelineLayout = std::make_unique<VulkanPipelineLayout>(device.getHandle(), std::vector{ frameSetLayout, m_descriptorSetLayout });
+    m_cullPipeline = std::make_unique<VulkanPipeline>(device.getHandle(), m_pipelineLayout->getHandle(), CULL_COMP_SHADER_PATH);
+
+    spdlog::info("GPU scene created for up to {} object(s)", maxObjects);
+}
+
+VulkanGpuScene::~VulkanGpuScene()
+{
+    for(auto& frame : m_frames)
+    {
+        device.destroyBuffer(frame.commandBuffer, frame.commandAllocation);
+        device.destroyBuffer(frame.countBuffer, frame.countAllocation);
+        device.destroyBuffer(frame.instanceBuffer, frame.instanceAllocation);
+    }
+    device.destroyBuffer(m_objectBuffer, m_objectAllocation);
+
+    m_cullPipeline.reset();
+    m_pipelineLayout.reset();
+    vkDestroyDescriptorPool(device.getHandle(), m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device.getHandle(), m_descriptorSetLayout, nullptr);
+}
+
+std::uint32_t VulkanGpuScene::add(const VulkanMesh& mesh, const InstanceData& instance, std::size_t lod)
+{
+    assert(m_objects.size() < maxObjects && "GPU scene is full");
+    assert(mesh.isIndexed() && "GPU scenes only draw indexed meshes");
+    assert((m_geometry == nullptr
+            || (mesh.getVertexBufferHandle() == m_geometry->getVertexBufferHandle() && mesh.getIndexBufferHandle() == m_geometry->getIndexBufferHandle() && mesh.getIndexType() == m_geometry->getIndexType()))
+           && "All meshes of a GPU scene have to share their geometry buffers");
+
+    if(m_geometry == nullptr)
+        m_geometry = &mesh;
+
+    // NOTE: the offsets are baked into the object buffer, so the geometry pool must not move the mesh anymore
+    mesh.pinGeometry();
+
+    const auto lods{ mesh.getLods() };
+    const auto& range{ lods[std::min(lod, lods.size() - 1)] };
+    const auto& bounds{ mesh.getBounds() };
+    m_objects.push_back({
+        .boundingSphere = { bounds.center.x, bounds.center.y, bounds.center.z, bounds.radius },
+        .instance = instance,
+        .indexCount = range.indexCount,
+        .firstIndex = mesh.getFirstIndex() + range.firstIndex,
+        .vertexOffset = static_cast<std::int32_t>(mesh.getFirstVertex()),
+        .padding = 0
+    });
+
+    return static_cast<std::uint32_t>(m_objects.size() - 1);
+}
+
+void VulkanGpuScene::upload()
+{
+    if(m_uploadedCount == m_objects.size())
+        return;
+
+    // NOTE: objects are never changed after they were added, so only the new tail has to be copied
+    const auto pending{ std::span{ m_objects }.subspan(m_uploadedCount) };
+    m_uploadValue = device.getUploadScheduler().uploadToBuffer(m_objectBuffer, sizeof(GpuObject) * m_uploadedCount, pending.data(), pending.size_bytes());
+    m_uploadedCount = static_cast<std::uint32_t>(m_objects.size());
+}
+
+void VulkanGpuScene::cull(VkCommandBuffer cmdBuffer, VkDescriptorSet frameSet, std::uint32_t dynamicOffset, std::size_t frameIndex)
+{
+    assert(frameIndex < m_frames.size() && "Frame index out of range");
+
+    m_currentFrame = frameIndex;
+    const auto& frame{ m_frames[frameIndex] };
+
+    vkCmdFillBuffer(cmdBuffer, frame.countBuffer, 0, VK_WHOLE_SIZE, 0);
+
+    VkBufferMemoryBarrier countBarrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = frame.countBuffer,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &countBarrier, 0, nullptr);
+
+    if(m_uploadedCount > 0)
+    {
+        m_cullPipeline->bind(cmdBuffer);
+
+        const std::array sets{ frameSet, frame.descriptorSet };
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout->getHandle(), 0, static_cast<std::uint32_t>(sets.size()), sets.data(), 1, &dynamicOffset);
+        vkCmdDispatch(cmdBuffer, (m_uploadedCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+    }
+
+    // NOTE: commands and the count are consumed by the indirect draw, the instances by the vertex input of the draws
+    std::array<VkBufferMemoryBarrier, 3> barriers{};
+    const std::array<VkBuffer, 3> buffers{ frame.commandBuffer, frame.countBuffer, frame.instanceBuffer };
+    for(std::size_t i{ 0 }; i < barriers.size(); ++i)
+    {
+        barriers[i] = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = buffers[i] == frame.instanceBuffer ? VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT : VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffers[i],
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         static_cast<std::uint32_t>(barriers.size()),
+                         barriers.data(),
+                         0,
+                         nullptr);
+}
+
+void VulkanGpuScene::draw(VkCommandBuffer cmdBuffer, GeometryBindState& boundGeometry) const
+{
+    if(m_uploadedCount == 0)
+        return;
+
+    const auto& frame{ m_frames[m_currentFrame] };
+
+    m_geometry->bind(cmdBuffer, boundGeometry);
+    const VkDeviceSize instanceOffset{ 0 };
+    vkCmdBindVertexBuffers(cmdBuffer, INSTANCE_BINDING, 1, &frame.instanceBuffer, &instanceOffset);
+
+    vkCmdDrawIndexedIndirectCount(cmdBuffer, frame.commandBuffer, 0, frame.countBuffer, 0, m_uploadedCount, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+/**
+ *  Every frame in flight writes its own commands, count and instances, the objects are shared. None of the buffers is
+ *  ever relocated, so the descriptor sets are written once.
+*/
+void VulkanGpuScene::createDescriptorSets(std::uint32_t framesInFlight)
+{
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for(std::uint32_t i{ 0 }; i < BINDING_COUNT; ++i)
+    {
+        bindings[i] = {
+            .binding = i,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        };
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = static_cast<std::uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+
+    if(vkCreateDescriptorSetLayout(device.getHandle(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DESCRIPTOR_SET_LAYOUT);
+
+    VkDescriptorPoolSize poolSize{
+        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = BINDING_COUNT * framesInFlight
+    };
+
+    VkDescriptorPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = framesInFlight,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize
+    };
+
+    if(vkCreateDescriptorPool(device.getHandle(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DESCRIPTOR_POOL);
+
+    const std::vector<VkDescriptorSetLayout> setLayouts(framesInFlight, m_descriptorSetLayout);
+    std::vector<VkDescriptorSet> sets(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = m_descriptorPool,
+        .descriptorSetCount = framesInFlight,
+        .pSetLayouts = setLayouts.data()
+    };
+
+    if(vkAllocateDescriptorSets(device.getHandle(), &allocInfo, sets.data()) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_DESCRIPTOR_SETS);
+
+    for(std::uint32_t i{ 0 }; i < framesInFlight; ++i)
+    {
+        auto& frame{ m_frames[i] };
+        frame.descriptorSet = sets[i];
+
+        const std::array<VkDescriptorBufferInfo, BINDING_COUNT> bufferInfos{ {
+            { .buffer = m_objectBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = frame.commandBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = frame.countBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = frame.instanceBuffer, .offset = 0, .range = VK_WHOLE_SIZE }
+        } };
+
+        std::array<VkWriteDescriptorSet, BINDING_COUNT> writes{};
+        for(std::uint32_t binding{ 0 }; binding < BINDING_COUNT; ++binding)
+        {
+            writes[binding] = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = frame.descriptorSet,
+                .dstBinding = binding,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .pBufferInfo = &bufferInfos[binding]
+            };
+        }
+
+        vkUpdateDescriptorSets(device.getHandle(), BINDING_COUNT, writes.data(), 0, nullptr);
+    }
+}
+
+/**
+ *  Sized for <code>maxObjects<\code> up front, so adding objects never reallocates a buffer a frame in flight reads.
+*/
+void VulkanGpuScene::createBuffers()
+{
+    device.createBuffer(
+        sizeof(GpuObject) * maxObjects,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_objectBuffer,
+        m_objectAllocation,
+        MemoryCategory::MESH);
+
+    for(auto& frame : m_frames)
+    {
+        device.createBuffer(
+            sizeof(VkDrawIndexedIndirectCommand) * maxObjects,
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            frame.commandBuffer,
+            frame.commandAllocation);
+        device.createBuffer(
+            sizeof(std::uint32_t),
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            frame.countBuffer,
+            frame.countAllocation);
+        device.createBuffer(
+            sizeof(InstanceData) * maxObjects,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            frame.instanceBuffer,
+            frame.instanceAllocation);
+    }
+}
+
+} // !rr
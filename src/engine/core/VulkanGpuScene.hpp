@@ -0,0 +1,140 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_GPU_SCENE_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_GPU_SCENE_HPP
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanMesh.hpp"
+#include "core/VulkanPipeline.hpp"
+#include "core/VulkanPipelineLayout.hpp"
+#include "mesh/InstanceData.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/ext/vector_float4.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Object of a <code>VulkanGpuScene<\code> as the culling shader reads it, laid out according to std430.
+*/
+struct GpuObject
+{
+    /** Model space bounding sphere, center in xyz and radius in w */
+    glm::vec4 boundingSphere;
+    InstanceData instance;
+    std::uint32_t indexCount;
+    std::uint32_t firstIndex;
+    std::int32_t vertexOffset;
+    std::uint32_t padding;
+};
+
+/**
+ *  Per frame data of the culling shader, read through the dynamic uniform of the frame allocator.
+*/
+struct GpuCullData
+{
+    std::array<glm::vec4, 6> frustumPlanes;
+    std::uint32_t objectCount;
+};
+
+/**
+ *  <code>VulkanGpuScene<\code> draws static objects without touching them on the CPU per frame. All objects live in a
+ *  device local storage buffer, a compute shader culls them against the frustum and compacts the visible ones into
+ *  indexed indirect commands, their instance data and a draw count. The frame is then drawn with a single
+ *  <code>vkCmdDrawIndexedIndirectCount<\code>, every command picks its instance through <code>firstInstance<\code>,
+ *  so any pipeline of the <code>InstancedVertex<\code> layout draws the scene.
+ *
+ *  All meshes of a scene have to be indexed with the same index type and live in the same geometry pool blocks, since
+ *  the whole scene is drawn after a single vertex and index buffer bind. Needs <code>drawIndirectCount<\code>.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanGpuScene
+{
+public:
+    VulkanGpuScene(VulkanDevice& device, VkDescriptorSetLayout frameSetLayout, std::uint32_t framesInFlight, std::uint32_t maxObjects = DEFAULT_MAX_OBJECTS);
+    ~VulkanGpuScene();
+
+    VulkanGpuScene(const VulkanGpuScene&) = delete;
+    VulkanGpuScene(VulkanGpuScene&&) = delete;
+    VulkanGpuScene& operator=(const VulkanGpuScene&) = delete;
+    VulkanGpuScene& operator=(VulkanGpuScene&&) = delete;
+
+    static constexpr std::uint32_t DEFAULT_MAX_OBJECTS{ 1U << 16U };
+    /** Objects per workgroup of the culling shader, has to match the shader */
+    static constexpr std::uint32_t CULL_WORKGROUP_SIZE{ 64 };
+    static constexpr std::string_view CULL_COMP_SHADER_PATH{ "./shaders/object_cull.comp.spv" };
+
+    /** Add a static object, it is only seen by the GPU after the next <code>upload()<\code> */
+    std::uint32_t add(const VulkanMesh& mesh, const InstanceData& instance, std::size_t lod = 0);
+    /** Schedule the upload of all objects added since the last upload */
+    void upload();
+
+    [[nodiscard]] std::uint32_t getObjectCount() const { return m_uploadedCount; }
+    /** Timeline value of the upload scheduler after which all uploaded objects are resident */
+    [[nodiscard]] std::uint64_t getUploadValue() const { return m_uploadValue; }
+
+    /** Cull all uploaded objects, <code>GpuCullData<\code> has to be at <code>dynamicOffset<\code>. Must be recorded
+     *  after the fence of <code>frameIndex<\code> signaled and outside of a render pass */
+    void cull(VkCommandBuffer cmdBuffer, VkDescriptorSet frameSet, std::uint32_t dynamicOffset, std::size_t frameIndex);
+    /** Draw the visible objects of the last <code>cull()<\code>, a pipeline of the instanced layout has to be bound */
+    void draw(VkCommandBuffer cmdBuffer, GeometryBindState& boundGeometry) const;
+
+private:
+    enum Binding : std::uint32_t
+    {
+        OBJECTS,
+        COMMANDS,
+        COUNT,
+        INSTANCES,
+        BINDING_COUNT
+    };
+
+    struct FrameResources
+    {
+        VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
+        VkBuffer commandBuffer{ VK_NULL_HANDLE };
+        VulkanAllocation commandAllocation;
+        VkBuffer countBuffer{ VK_NULL_HANDLE };
+        VulkanAllocation countAllocation;
+        VkBuffer instanceBuffer{ VK_NULL_HANDLE };
+        VulkanAllocation instanceAllocation;
+    };
+
+    VulkanDevice& device;
+    std::uint32_t maxObjects;
+
+    std::vector<GpuObject> m_objects;
+    std::uint32_t m_uploadedCount{ 0 };
+    std::uint64_t m_uploadValue{ 0 };
+    /** Any mesh of the scene, they all share its geometry buffers */
+    const VulkanMesh* m_geometry{ nullptr };
+
+    VkBuffer m_objectBuffer{ VK_NULL_HANDLE };
+    VulkanAllocation m_objectAllocation;
+
+    VkDescriptorSetLayout m_descriptorSetLayout{ VK_NULL_HANDLE };
+    VkDescriptorPool m_descriptorPool{ VK_NULL_HANDLE };
+    std::unique_ptr<VulkanPipelineLayout> m_pipelineLayout;
+    std::unique_ptr<VulkanPipeline> m_cullPipeline;
+    std::vector<FrameResources> m_frames;
+    std::size_t m_currentFrame{ 0 };
+
+    void createDescriptorSets(std::uint32_t framesInFlight);
+    void createBuffers();
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_GPU_SCENE_HPP
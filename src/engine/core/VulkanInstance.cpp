@@ -62,7 +62,7 @@ VulkanInstance::VulkanInstance()
         .pApplicationName = "RRenderer Application",
         .pEngineName = "RRenderer",
         .engineVersion = VK_MAKE_VERSION(0, 0, 1),
-        .apiVersion = VK_API_VERSION_1_0
+        .apiVersion = VK_API_VERSION_1_2
     };
 
     auto extensions{ getRequiredExtensions() };
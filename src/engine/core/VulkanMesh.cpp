@@ -1,93 +1,291 @@
 #include "VulkanMesh.hpp"
 
+#include "core/VulkanDefragmenter.hpp"
 #include "core/VulkanDevice.hpp"
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "core/VulkanUploadScheduler.hpp"
+#include "mesh/InstanceData.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/MeshLod.hpp"
+#include "mesh/Meshlet.hpp"
 
 #include <array>
 #include <cstddef>
-#include <cstring>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace rr
 {
 
-VulkanMesh::VulkanMesh(VulkanDevice& device, const std::vector<Vertex>& vertices)
+namespace
+{
+
+constexpr VkDeviceSize indexSize(VkIndexType indexType)
+{
+    return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+} // !namespace
+
+VulkanMesh::VulkanMesh(VulkanDevice& device, std::span<const std::byte> vertexData, std::uint32_t vertexCount, std::span<const std::uint32_t> indices, std::span<const MeshLod> lods)
     : device(device)
-    , m_vertexCount(static_cast<std::uint32_t>(vertices.size()))
+    , m_vertexCount(vertexCount)
+    , m_indexCount(static_cast<std::uint32_t>(indices.size()))
 {
     assert(m_vertexCount >= 3 && "At least 3 vertices are needed to create a vertex buffer");
 
-    VkDeviceSize bufferSize{ sizeof(vertices[0]) * m_vertexCount };
+    setLods(lods);
+    uploadVertices(vertexData);
 
-    device.createBuffer(
-        bufferSize,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        m_vertexBuffer,
-        m_vertexBufferMemory);
+    if(m_indexCount == 0)
+        return;
+
+    // NOTE: 16 bit indices halve the index data and its fetch bandwidth whenever the vertex count allows it
+    if(m_vertexCount <= MAX_16_BIT_VERTEX_COUNT)
+    {
+        std::vector<std::uint16_t> shortIndices(indices.begin(), indices.end());
+        uploadIndices(shortIndices.data(), VK_INDEX_TYPE_UINT16);
+    }
+    else
+    {
+        uploadIndices(indices.data(), VK_INDEX_TYPE_UINT32);
+    }
+}
 
-    void* data{ nullptr };
-    vkMapMemory(device.getHandle(), m_vertexBufferMemory, 0, bufferSize, 0, &data);
-    std::memcpy(data, vertices.data(), bufferSize);
-    vkUnmapMemory(device.getHandle(), m_vertexBufferMemory);
+VulkanMesh::VulkanMesh(VulkanDevice& device, std::span<const std::byte> vertexData, std::uint32_t vertexCount, std::span<const std::byte> indexData, VkIndexType indexType, std::span<const MeshLod> lods)
+    : device(device)
+    , m_vertexCount(vertexCount)
+    , m_indexCount(static_cast<std::uint32_t>(indexData.size() / indexSize(indexType)))
+{
+    assert(m_vertexCount >= 3 && "At least 3 vertices are needed to create a vertex buffer");
+    assert((indexType == VK_INDEX_TYPE_UINT16 || indexType == VK_INDEX_TYPE_UINT32) && "Only 16 and 32 bit indices are supported");
+
+    setLods(lods);
+
+    // NOTE: the upload scheduler copies straight from here into staging memory, nothing is buffered in between
+    uploadVertices(vertexData);
+
+    if(m_indexCount > 0)
+        uploadIndices(indexData.data(), indexType);
 }
 
 VulkanMesh::~VulkanMesh()
 {
-    vkDestroyBuffer(device.getHandle(), m_vertexBuffer, nullptr);
-    vkFreeMemory(device.getHandle(), m_vertexBufferMemory, nullptr);
+    auto& pool{ device.getGeometryPool() };
+    pool.free(GeometryKind::VERTEX, m_vertexAllocation);
+    if(isIndexed())
+        pool.free(GeometryKind::INDEX, m_indexAllocation);
+
+    for(auto* const buffer : { &m_meshletBuffer, &m_meshletBoundsBuffer, &m_meshletVertexBuffer, &m_meshletTriangleBuffer })
+        destroyDeviceBuffer(*buffer);
 }
 
 void VulkanMesh::bind(VkCommandBuffer cmdBuffer) const
 {
-    std::array<VkBuffer, 1> buffers{ m_vertexBuffer };
-    std::array<VkDeviceSize, 1> offsets{ 0 };
+    GeometryBindState state{};
+    bind(cmdBuffer, state);
+}
+
+void VulkanMesh::bind(VkCommandBuffer cmdBuffer, GeometryBindState& state) const
+{
+    auto& pool{ device.getGeometryPool() };
+
+    const VkBuffer vertexBuffer{ pool.getBufferHandle(GeometryKind::VERTEX, m_vertexAllocation.block) };
+    if(vertexBuffer != state.vertexBuffer)
+    {
+        const VkDeviceSize offset{ 0 };
+        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &vertexBuffer, &offset);
+        state.vertexBuffer = vertexBuffer;
+    }
+
+    if(!isIndexed())
+        return;
+
+    const VkBuffer indexBuffer{ pool.getBufferHandle(GeometryKind::INDEX, m_indexAllocation.block) };
+    if(indexBuffer != state.indexBuffer || m_indexType != state.indexType)
+    {
+        vkCmdBindIndexBuffer(cmdBuffer, indexBuffer, 0, m_indexType);
+        state.indexBuffer = indexBuffer;
+        state.indexType = m_indexType;
+    }
+}
+
+void VulkanMesh::draw(VkCommandBuffer cmdBuffer, std::size_t lod) const
+{
+    recordDraw(cmdBuffer, lod, 0, 1);
+}
+
+void VulkanMesh::drawInstances(VkCommandBuffer cmdBuffer, const FrameAllocation& instances, std::size_t lod) const
+{
+    assert(instances.size % sizeof(InstanceData) == 0 && "Allocation does not hold whole instances");
+
+    if(instances.size == 0)
+        return;
+
+    vkCmdBindVertexBuffers(cmdBuffer, INSTANCE_BINDING, 1, &instances.buffer, &instances.offset);
+    recordDraw(cmdBuffer, lod, 0, static_cast<std::uint32_t>(instances.size / sizeof(InstanceData)));
+}
+
+void VulkanMesh::drawInstanceRange(VkCommandBuffer cmdBuffer, std::uint32_t firstInstance, std::uint32_t instanceCount, std::size_t lod) const
+{
+    if(instanceCount == 0)
+        return;
+
+    recordDraw(cmdBuffer, lod, firstInstance, instanceCount);
+}
+
+void VulkanMesh::recordDraw(VkCommandBuffer cmdBuffer, std::size_t lod, std::uint32_t firstInstance, std::uint32_t instanceCount) const
+{
+    if(isIndexed())
+    {
+        const auto& range{ m_lods[std::min(lod, m_lods.size() - 1)] };
+        vkCmdDrawIndexed(cmdBuffer, range.indexCount, instanceCount, m_firstIndex + range.firstIndex, static_cast<std::int32_t>(m_firstVertex), firstInstance);
+    }
+    else
+    {
+        vkCmdDraw(cmdBuffer, m_vertexCount, instanceCount, m_firstVertex, firstInstance);
+    }
+}
+
+VkBuffer VulkanMesh::getVertexBufferHandle() const
+{
+    return device.getGeometryPool().getBufferHandle(GeometryKind::VERTEX, m_vertexAllocation.block);
+}
+
+VkBuffer VulkanMesh::getIndexBufferHandle() const
+{
+    assert(isIndexed() && "Mesh has no indices");
+
+    return device.getGeometryPool().getBufferHandle(GeometryKind::INDEX, m_indexAllocation.block);
+}
 
-    vkCmdBindVertexBuffers(cmdBuffer, 0, 1, buffers.data(), offsets.data());
+void VulkanMesh::pinGeometry() const
+{
+    auto& pool{ device.getGeometryPool() };
+    pool.pin(GeometryKind::VERTEX, m_vertexAllocation);
+    if(isIndexed())
+        pool.pin(GeometryKind::INDEX, m_indexAllocation);
 }
 
-void VulkanMesh::draw(VkCommandBuffer cmdBuffer) const
+void VulkanMesh::setMeshlets(const MeshletData& meshlets)
 {
-    vkCmdDraw(cmdBuffer, m_vertexCount, 1, 0, 0);
+    assert(isIndexed() && "Meshlets index into the index buffer of the mesh");
+    assert(meshlets.meshlets.size() == meshlets.bounds.size() && "Every meshlet needs bounds");
+
+    for(auto* const buffer : { &m_meshletBuffer, &m_meshletBoundsBuffer, &m_meshletVertexBuffer, &m_meshletTriangleBuffer })
+        destroyDeviceBuffer(*buffer);
+
+    m_meshletCount = static_cast<std::uint32_t>(meshlets.meshlets.size());
+    if(m_meshletCount == 0)
+        return;
+
+    // NOTE: shaders read the local indices as 32 bit words, so the buffer is padded to whole words
+    std::vector<std::uint8_t> triangles(meshlets.triangles);
+    triangles.resize((triangles.size() + 3) & ~std::size_t{ 3 }, 0);
+
+    m_meshletBuffer = createDeviceBuffer(meshlets.meshlets.data(), sizeof(Meshlet) * meshlets.meshlets.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_meshletBoundsBuffer = createDeviceBuffer(meshlets.bounds.data(), sizeof(MeshletBounds) * meshlets.bounds.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    // NOTE: mesh shaders add the first vertex of the draw, so the vertices can be moved without touching the meshlets
+    m_meshletVertexBuffer = createDeviceBuffer(meshlets.vertices.data(), sizeof(std::uint32_t) * meshlets.vertices.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    m_meshletTriangleBuffer = createDeviceBuffer(triangles.data(), triangles.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 }
 
-std::vector<VkVertexInputBindingDescription> Vertex::getBindingDescriptions()
+MeshletBuffers VulkanMesh::getMeshletBuffers() const
 {
-    std::vector<VkVertexInputBindingDescription> bindingDescriptions{
-        {
-            .binding = 0,
-            .stride = sizeof(Vertex),
-            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
-        }
+    assert(hasMeshlets() && "Mesh has no meshlets");
+
+    return {
+        .meshlets = m_meshletBuffer->buffer,
+        .bounds = m_meshletBoundsBuffer->buffer,
+        .vertices = m_meshletVertexBuffer->buffer,
+        .triangles = m_meshletTriangleBuffer->buffer
     };
+}
+
+void VulkanMesh::setLods(std::span<const MeshLod> lods)
+{
+    if(m_indexCount == 0)
+        return;
 
-    return bindingDescriptions;
+    m_lods.assign(lods.begin(), lods.end());
+    if(m_lods.empty())
+        m_lods.push_back({ .firstIndex = 0, .indexCount = m_indexCount, .error = 0.f });
+
+    assert(std::ranges::all_of(m_lods, [this](const MeshLod& lod) { return lod.firstIndex + lod.indexCount <= m_indexCount; }) && "Levels of detail have to lie inside of the index buffer");
+}
+
+void VulkanMesh::uploadVertices(std::span<const std::byte> vertexData)
+{
+    // NOTE: ranges are aligned to the vertex size, so the offset is a whole number of vertices
+    const VkDeviceSize stride{ vertexData.size() / m_vertexCount };
+    m_vertexAllocation = device.getGeometryPool().upload(GeometryKind::VERTEX, vertexData.data(), vertexData.size(), stride, [this, stride](const GeometryAllocation& allocation) {
+        m_vertexAllocation = allocation;
+        m_firstVertex = static_cast<std::uint32_t>(allocation.offset / stride);
+    });
+    m_firstVertex = static_cast<std::uint32_t>(m_vertexAllocation.offset / stride);
+    m_uploadValue = std::max(m_uploadValue, m_vertexAllocation.uploadValue);
+}
+
+void VulkanMesh::uploadIndices(const void* data, VkIndexType indexType)
+{
+    m_indexType = indexType;
+    m_indexAllocation = device.getGeometryPool().upload(GeometryKind::INDEX, data, indexSize(indexType) * m_indexCount, indexSize(indexType), [this](const GeometryAllocation& allocation) {
+        m_indexAllocation = allocation;
+        m_firstIndex = static_cast<std::uint32_t>(allocation.offset / indexSize(m_indexType));
+    });
+    m_firstIndex = static_cast<std::uint32_t>(m_indexAllocation.offset / indexSize(indexType));
+    m_uploadValue = std::max(m_uploadValue, m_indexAllocation.uploadValue);
+}
+
+void VulkanMesh::destroyDeviceBuffer(std::unique_ptr<DeviceBuffer>& buffer)
+{
+    if(buffer == nullptr)
+        return;
+
+    device.getDefragmenter().unregisterBuffer(buffer->relocationId);
+    device.destroyBuffer(buffer->buffer, buffer->allocation);
+    buffer.reset();
 }
 
 /**
- * For each attribute in the vertex buffer add a entry to the attribute description
+ *  Create a device local buffer, schedule the upload of <code>data<\code> into it and let the defragmenter move it.
 */
-std::vector<VkVertexInputAttributeDescription> Vertex::getAttributeDescriptions()
-{
-    std::vector<VkVertexInputAttributeDescription> attributeDescription{
-        {
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = offsetof(Vertex, position)
-        },
-        {
-            .location = 1,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, color)
-        }
-    };
+std::unique_ptr<VulkanMesh::DeviceBuffer> VulkanMesh::createDeviceBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage)
+{
+    auto result{ std::make_unique<DeviceBuffer>() };
+
+    // NOTE: transfer source so the defragmenter can move the buffer
+    const VkBufferUsageFlags bufferUsage{ usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+
+    device.createBuffer(
+        size,
+        bufferUsage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        result->buffer,
+        result->allocation,
+        MemoryCategory::MESH);
+
+    // NOTE: the copy is only recorded here, it is submitted with the next flush of the upload scheduler
+    m_uploadValue = std::max(m_uploadValue, device.getUploadScheduler().uploadToBuffer(result->buffer, 0, data, size));
+
+    result->relocationId = device.getDefragmenter().registerBuffer(
+        result->buffer,
+        result->allocation,
+        size,
+        bufferUsage,
+        [target = result.get()](VkBuffer buffer, const VulkanAllocation& allocation) {
+            target->buffer = buffer;
+            target->allocation = allocation;
+        });
 
-    return attributeDescription;
+    return result;
 }
 
 }; // !rr
@@ -1,34 +1,57 @@
 #ifndef RRENDERER_ENGINE_CORE_VULKAN_MESH_HPP
 #define RRENDERER_ENGINE_CORE_VULKAN_MESH_HPP
 
+#include "core/VulkanAllocator.hpp"
 #include "core/VulkanDevice.hpp"
-
-#define GLM_FORCE_RADIANS
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
-#include "glm/ext/vector_float2.hpp"
-#include "glm/ext/vector_float3.hpp"
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanGeometryPool.hpp"
+#include "mesh/InstanceData.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/MeshLod.hpp"
+#include "mesh/Meshlet.hpp"
+#include "mesh/VertexLayout.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace rr
 {
 
-struct Vertex
+/** Storage buffers holding the meshlets of a mesh, handles may change when the defragmenter moves a buffer */
+struct MeshletBuffers
 {
-    glm::vec2 position;
-    glm::vec3 color;
-
-    static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
-    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+    VkBuffer meshlets{ VK_NULL_HANDLE };
+    VkBuffer bounds{ VK_NULL_HANDLE };
+    VkBuffer vertices{ VK_NULL_HANDLE };
+    VkBuffer triangles{ VK_NULL_HANDLE };
 };
 
+/**
+ *  <code>VulkanMesh<\code> is a static mesh whose vertex and index data lives in the geometry pool of the device.
+ *  Draws offset into the shared pool buffers, so meshes in the same pool blocks can be drawn after a single bind.
+ *  Compaction of the pool may move the data of a mesh, so buffers and offsets have to be queried for every frame.
+*/
 class VulkanMesh
 {
 public:
-    VulkanMesh(VulkanDevice& device, const std::vector<Vertex>& vertices);
+    /**
+     *  Vertices may be of any <code>VertexType<\code>, the pipeline drawing the mesh has to use the same layout.
+     *  Without <code>lods<\code> all indices form a single level of detail.
+    */
+    template<VertexType V>
+    VulkanMesh(VulkanDevice& device, const std::vector<V>& vertices, const std::vector<std::uint32_t>& indices = {}, std::span<const MeshLod> lods = {})
+        : VulkanMesh(device, std::as_bytes(std::span{ vertices }), static_cast<std::uint32_t>(vertices.size()), std::span{ indices }, lods)
+    {}
+    /**
+     *  Upload already packed vertex and index data, e.g. straight out of a mapped mesh file. The data only has to
+     *  stay valid for the duration of the constructor. An empty <code>indexData<\code> creates a non indexed mesh.
+    */
+    VulkanMesh(VulkanDevice& device, std::span<const std::byte> vertexData, std::uint32_t vertexCount, std::span<const std::byte> indexData, VkIndexType indexType, std::span<const MeshLod> lods = {});
     ~VulkanMesh();
 
     VulkanMesh(const VulkanMesh&) = delete;
@@ -37,14 +60,82 @@ public:
     VulkanMesh& operator=(VulkanMesh&&) = delete;
 
     void bind(VkCommandBuffer cmdBuffer) const;
-    void draw(VkCommandBuffer cmdBuffer) const;
+    /** Only binds the pool buffers of this mesh if <code>state<\code> says they are not bound yet */
+    void bind(VkCommandBuffer cmdBuffer, GeometryBindState& state) const;
+    /** Levels past the coarsest one draw the coarsest one, non indexed meshes only have a single level */
+    void draw(VkCommandBuffer cmdBuffer, std::size_t lod = 0) const;
+    /** Draw one instance per <code>InstanceData<\code> in <code>instances<\code> with a single draw call, the bound
+     *  pipeline has to use the <code>InstancedVertex<\code> layout */
+    void drawInstances(VkCommandBuffer cmdBuffer, const FrameAllocation& instances, std::size_t lod = 0) const;
+    /** Draw <code>instanceCount<\code> instances starting at <code>firstInstance<\code> of the instance buffer that
+     *  is already bound, so consecutive draws can share one instance buffer bind */
+    void drawInstanceRange(VkCommandBuffer cmdBuffer, std::uint32_t firstInstance, std::uint32_t instanceCount, std::size_t lod = 0) const;
+
+    [[nodiscard]] bool isIndexed() const { return m_indexCount > 0; }
+    [[nodiscard]] VkIndexType getIndexType() const { return m_indexType; }
+    [[nodiscard]] std::span<const MeshLod> getLods() const { return m_lods; }
+    /** Model space bounds for culling, computed when the mesh is loaded */
+    [[nodiscard]] const MeshBounds& getBounds() const { return m_bounds; }
+    void setBounds(const MeshBounds& bounds) { m_bounds = bounds; }
+
+    /** Upload meshlets of the finest level of detail for culling and mesh shading. Replaces earlier meshlets, so it
+     *  must not be called while a frame in flight still reads them */
+    void setMeshlets(const MeshletData& meshlets);
+    [[nodiscard]] bool hasMeshlets() const { return m_meshletCount > 0; }
+    [[nodiscard]] std::uint32_t getMeshletCount() const { return m_meshletCount; }
+    [[nodiscard]] MeshletBuffers getMeshletBuffers() const;
+    /** Pool block holding the vertices, it is also a storage buffer so mesh shaders can fetch vertices themselves */
+    [[nodiscard]] VkBuffer getVertexBufferHandle() const;
+    /** Pool block holding the indices, only valid for indexed meshes */
+    [[nodiscard]] VkBuffer getIndexBufferHandle() const;
+    /** Position of the first vertex in the vertex block, the <code>vertexOffset<\code> of indexed draws */
+    [[nodiscard]] std::uint32_t getFirstVertex() const { return m_firstVertex; }
+    /** Position of the first index in the index block, levels of detail are relative to it */
+    [[nodiscard]] std::uint32_t getFirstIndex() const { return m_firstIndex; }
+    /** Keep vertices and indices where they are, for users that copy the first vertex or index into GPU buffers. By
+     *  default the geometry pool may move them, which changes the buffer handles and positions above */
+    void pinGeometry() const;
+
+    /** Timeline value of the upload scheduler after which the vertex data is resident */
+    [[nodiscard]] std::uint64_t getUploadValue() const { return m_uploadValue; }
 
 private:
+    /** Heap allocated so the relocation callback of the defragmenter can keep pointing at it */
+    struct DeviceBuffer
+    {
+        VkBuffer buffer{ VK_NULL_HANDLE };
+        VulkanAllocation allocation;
+        std::size_t relocationId{ 0 };
+    };
+
     VulkanDevice& device;
 
-    VkBuffer m_vertexBuffer{ VK_NULL_HANDLE };
-    VkDeviceMemory m_vertexBufferMemory{ VK_NULL_HANDLE };
+    GeometryAllocation m_vertexAllocation;
+    GeometryAllocation m_indexAllocation;
+    std::uint32_t m_firstVertex{ 0 };
+    std::uint32_t m_firstIndex{ 0 };
     std::uint32_t m_vertexCount;
+    std::uint32_t m_indexCount;
+    VkIndexType m_indexType{ VK_INDEX_TYPE_UINT32 };
+    std::vector<MeshLod> m_lods;
+    MeshBounds m_bounds{};
+    std::uint64_t m_uploadValue{ 0 };
+
+    std::unique_ptr<DeviceBuffer> m_meshletBuffer;
+    std::unique_ptr<DeviceBuffer> m_meshletBoundsBuffer;
+    std::unique_ptr<DeviceBuffer> m_meshletVertexBuffer;
+    std::unique_ptr<DeviceBuffer> m_meshletTriangleBuffer;
+    std::uint32_t m_meshletCount{ 0 };
+
+    VulkanMesh(VulkanDevice& device, std::span<const std::byte> vertexData, std::uint32_t vertexCount, std::span<const std::uint32_t> indices, std::span<const MeshLod> lods);
+
+    void setLods(std::span<const MeshLod> lods);
+    void recordDraw(VkCommandBuffer cmdBuffer, std::size_t lod, std::uint32_t firstInstance, std::uint32_t instanceCount) const;
+    void uploadVertices(std::span<const std::byte> vertexData);
+    void uploadIndices(const void* data, VkIndexType indexType);
+    void destroyDeviceBuffer(std::unique_ptr<DeviceBuffer>& buffer);
+
+    [[nodiscard]] std::unique_ptr<DeviceBuffer> createDeviceBuffer(const void* data, VkDeviceSize size, VkBufferUsageFlags usage);
 };
 
 } // !rr
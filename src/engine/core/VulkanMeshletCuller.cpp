@@ -0,0 +1,287 @@
+#include "VulkanMeshletCuller.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanFrameAllocator.hpp"
+#include "core/VulkanMesh.hpp"
+#include "core/VulkanPipeline.hpp"
+#include "core/VulkanPipelineLayout.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rr
+{
+
+static_assert(offsetof(MeshletDrawData, cull) == 32, "Culling data has to follow the std140 layout of DrawData");
+static_assert(sizeof(MeshletDrawData) <= VulkanFrameAllocator::MAX_UNIFORM_RANGE, "Meshlet draw data does not fit into the dynamic uniform range");
+
+VulkanMeshletCuller::VulkanMeshletCuller(VulkanDevice& device, const VulkanMesh& mesh, MeshletMode mode, VkDescriptorSetLayout frameSetLayout, std::uint32_t framesInFlight, std::uint32_t maxDraws)
+    : device(device)
+    , mesh(mesh)
+    , mode(mode)
+    , maxDraws(maxDraws)
+{
+    assert(mode != MeshletMode::DISABLED && "Culler is only needed when meshlets are drawn");
+    assert(mesh.hasMeshlets() && "Mesh has no meshlets to cull");
+    assert((mode != MeshletMode::COMPUTE || device.supportsDrawIndirectCount()) && "Compute culling needs drawIndirectCount");
+    assert((mode != MeshletMode::MESH_SHADER || device.supportsMeshShaders()) && "Mesh shaders are not supported by the device");
+
+    createDescriptorSets(framesInFlight);
+    m_pipelineLayout = std::make_unique<VulkanPipelineLayout>(device.getHandle(), std::vector{ frameSetLayout, m_descriptorSetLayout });
+
+    if(mode == MeshletMode::COMPUTE)
+    {
+        m_cullPipeline = std::make_unique<VulkanPipeline>(device.getHandle(), m_pipelineLayout->getHandle(), CULL_COMP_SHADER_PATH);
+        createFrameBuffers();
+    }
+
+    spdlog::info("Meshlet culler created for {} meshlet(s) and up to {} draw(s) per frame", mesh.getMeshletCount(), maxDraws);
+}
+
+VulkanMeshletCuller::~VulkanMeshletCuller()
+{
+    for(auto& frame : m_frames)
+    {
+        if(frame.commandBuffer != VK_NULL_HANDLE)
+            device.destroyBuffer(frame.commandBuffer, frame.commandAllocation);
+        if(frame.countBuffer != VK_NULL_HANDLE)
+            device.destroyBuffer(frame.countBuffer, frame.countAllocation);
+    }
+
+    m_cullPipeline.reset();
+    m_pipelineLayout.reset();
+    vkDestroyDescriptorPool(device.getHandle(), m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device.getHandle(), m_descriptorSetLayout, nullptr);
+}
+
+/**
+ *  Point the descriptors of <code>frameIndex<\code> at the current buffers of the mesh and reset the draw counts.
+ *  Must only be called after the fence of that frame signaled and outside of a render pass.
+*/
+void VulkanMeshletCuller::beginFrame(VkCommandBuffer cmdBuffer, std::size_t frameIndex)
+{
+    assert(frameIndex < m_frames.size() && "Frame index out of range");
+
+    m_currentFrame = frameIndex;
+    const auto& frame{ m_frames[frameIndex] };
+
+    // NOTE: the defragmenter may have moved any of the buffers since this set was written the last time
+    const auto meshlets{ mesh.getMeshletBuffers() };
+    const std::array<VkDescriptorBufferInfo, BINDING_COUNT> bufferInfos{ {
+        { .buffer = meshlets.meshlets, .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = meshlets.bounds, .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = meshlets.vertices, .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = meshlets.triangles, .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = mesh.getVertexBufferHandle(), .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = frame.commandBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = frame.countBuffer, .offset = 0, .range = VK_WHOLE_SIZE }
+    } };
+
+    // NOTE: the indirect buffers only exist for compute culling, the mesh shading stages never access them
+    const std::uint32_t writeCount{ mode == MeshletMode::COMPUTE ? BINDING_COUNT : COMMANDS };
+    std::array<VkWriteDescriptorSet, BINDING_COUNT> writes{};
+    for(std::uint32_t i{ 0 }; i < writeCount; ++i)
+    {
+        writes[i] = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = frame.descriptorSet,
+            .dstBinding = i,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &bufferInfos[i]
+        };
+    }
+
+    vkUpdateDescriptorSets(device.getHandle(), writeCount, writes.data(), 0, nullptr);
+
+    if(mode != MeshletMode::COMPUTE)
+        return;
+
+    vkCmdFillBuffer(cmdBuffer, frame.countBuffer, 0, VK_WHOLE_SIZE, 0);
+
+    VkBufferMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = frame.countBuffer,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+/**
+ *  Cull the meshlets of one draw, its <code>MeshletDrawData<\code> has to be at <code>dynamicOffset<\code> and its
+ *  <code>drawIndex<\code> has to match the one in there.
+*/
+void VulkanMeshletCuller::cull(VkCommandBuffer cmdBuffer, VkDescriptorSet frameSet, std::uint32_t dynamicOffset, std::uint32_t drawIndex)
+{
+    assert(mode == MeshletMode::COMPUTE && "Only compute culling runs a pre-pass");
+    assert(drawIndex < maxDraws && "Draw index out of range");
+
+    m_cullPipeline->bind(cmdBuffer);
+
+    const std::array sets{ frameSet, m_frames[m_currentFrame].descriptorSet };
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout->getHandle(), 0, static_cast<std::uint32_t>(sets.size()), sets.data(), 1, &dynamicOffset);
+
+    const std::uint32_t groupCount{ (mesh.getMeshletCount() + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE };
+    vkCmdDispatch(cmdBuffer, groupCount, 1, 1);
+}
+
+/** Make the commands written by all <code>cull()<\code> calls of this frame visible to indirect draws */
+void VulkanMeshletCuller::endCulling(VkCommandBuffer cmdBuffer)
+{
+    if(mode != MeshletMode::COMPUTE)
+        return;
+
+    const auto& frame{ m_frames[m_currentFrame] };
+    std::array<VkBufferMemoryBarrier, 2> barriers{};
+    for(std::size_t i{ 0 }; i < barriers.size(); ++i)
+    {
+        barriers[i] = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = i == 0 ? frame.commandBuffer : frame.countBuffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 0, nullptr, static_cast<std::uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+}
+
+/**
+ *  Draw the visible meshlets of <code>drawIndex<\code>. The mesh and a graphics pipeline for its vertices have to be
+ *  bound, just like for a regular draw of the mesh.
+*/
+void VulkanMeshletCuller::drawIndirect(VkCommandBuffer cmdBuffer, std::uint32_t drawIndex) const
+{
+    assert(mode == MeshletMode::COMPUTE && "Indirect draws are written by compute culling");
+    assert(drawIndex < maxDraws && "Draw index out of range");
+
+    const auto& frame{ m_frames[m_currentFrame] };
+    const VkDeviceSize commandOffset{ sizeof(VkDrawIndexedIndirectCommand) * mesh.getMeshletCount() * drawIndex };
+
+    vkCmdDrawIndexedIndirectCount(
+        cmdBuffer,
+        frame.commandBuffer,
+        commandOffset,
+        frame.countBuffer,
+        sizeof(std::uint32_t) * drawIndex,
+        mesh.getMeshletCount(),
+        sizeof(VkDrawIndexedIndirectCommand));
+}
+
+/** Cull and draw all meshlets of a draw in the task and mesh shaders of the bound pipeline */
+void VulkanMeshletCuller::drawMeshTasks(VkCommandBuffer cmdBuffer, VkDescriptorSet frameSet, std::uint32_t dynamicOffset) const
+{
+    assert(mode == MeshletMode::MESH_SHADER && "Mesh tasks are only drawn with mesh shaders");
+
+    const std::array sets{ frameSet, m_frames[m_currentFrame].descriptorSet };
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout->getHandle(), 0, static_cast<std::uint32_t>(sets.size()), sets.data(), 1, &dynamicOffset);
+
+    const std::uint32_t groupCount{ (mesh.getMeshletCount() + TASK_WORKGROUP_SIZE - 1) / TASK_WORKGROUP_SIZE };
+    device.cmdDrawMeshTasks(cmdBuffer, groupCount, 1, 1);
+}
+
+void VulkanMeshletCuller::createDescriptorSets(std::uint32_t framesInFlight)
+{
+    VkShaderStageFlags stageFlags{ VK_SHADER_STAGE_COMPUTE_BIT };
+    if(mode == MeshletMode::MESH_SHADER)
+        stageFlags = VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for(std::uint32_t i{ 0 }; i < BINDING_COUNT; ++i)
+    {
+        bindings[i] = {
+            .binding = i,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = stageFlags
+        };
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = static_cast<std::uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+
+    if(vkCreateDescriptorSetLayout(device.getHandle(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DESCRIPTOR_SET_LAYOUT);
+
+    VkDescriptorPoolSize poolSize{
+        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = BINDING_COUNT * framesInFlight
+    };
+
+    VkDescriptorPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = framesInFlight,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize
+    };
+
+    if(vkCreateDescriptorPool(device.getHandle(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_DESCRIPTOR_POOL);
+
+    const std::vector<VkDescriptorSetLayout> setLayouts(framesInFlight, m_descriptorSetLayout);
+    std::vector<VkDescriptorSet> sets(framesInFlight);
+    VkDescriptorSetAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = m_descriptorPool,
+        .descriptorSetCount = framesInFlight,
+        .pSetLayouts = setLayouts.data()
+    };
+
+    if(vkAllocateDescriptorSets(device.getHandle(), &allocInfo, sets.data()) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_DESCRIPTOR_SETS);
+
+    m_frames.resize(framesInFlight);
+    for(std::uint32_t i{ 0 }; i < framesInFlight; ++i)
+        m_frames[i].descriptorSet = sets[i];
+}
+
+/**
+ *  Every draw gets room for a command per meshlet, so no draw can overflow into the commands of another one.
+*/
+void VulkanMeshletCuller::createFrameBuffers()
+{
+    const VkDeviceSize commandSize{ sizeof(VkDrawIndexedIndirectCommand) * mesh.getMeshletCount() * maxDraws };
+    const VkDeviceSize countSize{ sizeof(std::uint32_t) * maxDraws };
+
+    for(auto& frame : m_frames)
+    {
+        device.createBuffer(
+            commandSize,
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            frame.commandBuffer,
+            frame.commandAllocation);
+        device.createBuffer(
+            countSize,
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            frame.countBuffer,
+            frame.countAllocation);
+    }
+}
+
+} // !rr
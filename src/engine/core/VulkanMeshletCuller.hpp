@@ -0,0 +1,125 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_MESHLET_CULLER_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_MESHLET_CULLER_HPP
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanMesh.hpp"
+#include "core/VulkanPipeline.hpp"
+#include "core/VulkanPipelineLayout.hpp"
+#include "mesh/Meshlet.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace rr
+{
+
+enum class MeshletMode : std::uint8_t
+{
+    /** Whole levels of detail are drawn without meshlets */
+    DISABLED,
+    /** A compute pre-pass culls meshlets and writes indirect draws, needs <code>drawIndirectCount<\code> */
+    COMPUTE,
+    /** Task shaders cull meshlets and mesh shaders emit them, needs <code>VK_EXT_mesh_shader<\code> */
+    MESH_SHADER
+};
+
+/**
+ *  Per draw data of draws that cull meshlets. Shaders that only declare <code>DrawData<\code> read the prefix of it.
+*/
+struct MeshletDrawData
+{
+    DrawData draw;
+    MeshletCullData cull;
+};
+
+/**
+ *  <code>VulkanMeshletCuller<\code> culls the meshlets of a mesh on the GPU before they are rasterized.
+ *
+ *  In <code>MeshletMode::COMPUTE<\code> a compute shader tests every meshlet of a draw and appends an indexed
+ *  indirect command for each visible one, the draw then consumes them with <code>vkCmdDrawIndexedIndirectCount<\code>.
+ *  In <code>MeshletMode::MESH_SHADER<\code> the same test runs in a task shader, which launches mesh shader workgroups
+ *  only for the visible meshlets. Both read the meshlet buffers of the mesh through set 1 and the
+ *  <code>MeshletDrawData<\code> of a draw through the dynamic uniform of the frame allocator in set 0.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanMeshletCuller
+{
+public:
+    VulkanMeshletCuller(VulkanDevice& device, const VulkanMesh& mesh, MeshletMode mode, VkDescriptorSetLayout frameSetLayout, std::uint32_t framesInFlight, std::uint32_t maxDraws = DEFAULT_MAX_DRAWS);
+    ~VulkanMeshletCuller();
+
+    VulkanMeshletCuller(const VulkanMeshletCuller&) = delete;
+    VulkanMeshletCuller(VulkanMeshletCuller&&) = delete;
+    VulkanMeshletCuller& operator=(const VulkanMeshletCuller&) = delete;
+    VulkanMeshletCuller& operator=(VulkanMeshletCuller&&) = delete;
+
+    static constexpr std::uint32_t DEFAULT_MAX_DRAWS{ 16 };
+    /** Meshlets per workgroup of the culling compute shader and of the task shader, has to match the shaders */
+    static constexpr std::uint32_t CULL_WORKGROUP_SIZE{ 64 };
+    static constexpr std::uint32_t TASK_WORKGROUP_SIZE{ 32 };
+    static constexpr std::string_view CULL_COMP_SHADER_PATH{ "./shaders/meshlet_cull.comp.spv" };
+    static constexpr std::string_view MESHLET_TASK_SHADER_PATH{ "./shaders/meshlet.task.spv" };
+    static constexpr std::string_view MESHLET_MESH_SHADER_PATH{ "./shaders/meshlet.mesh.spv" };
+
+    [[nodiscard]] MeshletMode getMode() const { return mode; }
+    [[nodiscard]] std::uint32_t getMaxDraws() const { return maxDraws; }
+    /** Layout of set 0 and set 1, graphics pipelines drawing with <code>drawMeshTasks()<\code> have to use it */
+    [[nodiscard]] VkPipelineLayout getPipelineLayoutHandle() const { return m_pipelineLayout->getHandle(); }
+
+    void beginFrame(VkCommandBuffer cmdBuffer, std::size_t frameIndex);
+    void cull(VkCommandBuffer cmdBuffer, VkDescriptorSet frameSet, std::uint32_t dynamicOffset, std::uint32_t drawIndex);
+    void endCulling(VkCommandBuffer cmdBuffer);
+
+    void drawIndirect(VkCommandBuffer cmdBuffer, std::uint32_t drawIndex) const;
+    void drawMeshTasks(VkCommandBuffer cmdBuffer, VkDescriptorSet frameSet, std::uint32_t dynamicOffset) const;
+
+private:
+    enum Binding : std::uint32_t
+    {
+        MESHLETS,
+        BOUNDS,
+        MESHLET_VERTICES,
+        MESHLET_TRIANGLES,
+        VERTICES,
+        COMMANDS,
+        COUNTS,
+        BINDING_COUNT
+    };
+
+    struct FrameResources
+    {
+        VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
+        VkBuffer commandBuffer{ VK_NULL_HANDLE };
+        VulkanAllocation commandAllocation;
+        VkBuffer countBuffer{ VK_NULL_HANDLE };
+        VulkanAllocation countAllocation;
+    };
+
+    VulkanDevice& device;
+    const VulkanMesh& mesh;
+    MeshletMode mode;
+    std::uint32_t maxDraws;
+
+    VkDescriptorSetLayout m_descriptorSetLayout{ VK_NULL_HANDLE };
+    VkDescriptorPool m_descriptorPool{ VK_NULL_HANDLE };
+    std::unique_ptr<VulkanPipelineLayout> m_pipelineLayout;
+    std::unique_ptr<VulkanPipeline> m_cullPipeline;
+    std::vector<FrameResources> m_frames;
+    std::size_t m_currentFrame{ 0 };
+
+    void createDescriptorSets(std::uint32_t framesInFlight);
+    void createFrameBuffers();
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_MESHLET_CULLER_HPP
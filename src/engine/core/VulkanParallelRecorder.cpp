@@ -0,0 +1,285 @@
+#include "VulkanParallelRecorder.hpp"
+
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanFrameContext.hpp"
+#include "utility/Hasher.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rr
+{
+
+VulkanParallelRecorder::VulkanParallelRecorder(VulkanDevice& device, std::uint32_t framesInFlight, std::size_t threadCount)
+    : m_threadPool(threadCount)
+{
+    m_contexts.reserve(m_threadPool.threadCount() + 1);
+    for(std::size_t i{ 0 }; i < m_threadPool.threadCount() + 1; ++i)
+        m_contexts.push_back(std::make_unique<VulkanFrameContext>(device, framesInFlight));
+    m_caches.resize(framesInFlight);
+
+    spdlog::info("parallel recorder created with {} worker(s) and {} command pool(s) per frame", m_threadPool.threadCount(), m_contexts.size());
+}
+
+void VulkanParallelRecorder::beginFrame(std::size_t frameIndex, VkRenderPass renderPass, VkFramebuffer framebuffer)
+{
+    assert(frameIndex < m_caches.size() && "Frame index out of range");
+    assert(m_recorded.empty() && "Secondary command buffers of the last frame were never executed");
+
+    m_currentFrame = frameIndex;
+    for(auto& context : m_contexts)
+        context->beginFrame(frameIndex);
+
+    m_colorFormat = VK_FORMAT_UNDEFINED;
+    m_renderingInheritance = {};
+    m_inheritance = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .renderPass = renderPass,
+        .subpass = 0,
+        .framebuffer = framebuffer
+    };
+}
+
+void VulkanParallelRecorder::beginFrame(std::size_t frameIndex, VkFormat colorFormat, VkFormat depthFormat)
+{
+    beginFrame(frameIndex, VK_NULL_HANDLE, VK_NULL_HANDLE);
+
+    // NOTE: the flags have to match those of vkCmdBeginRendering, apart from the secondary command buffer contents
+    m_colorFormat = colorFormat;
+    m_renderingInheritance = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .flags = 0,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &m_colorFormat,
+        .depthAttachmentFormat = depthFormat,
+        .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+    };
+    m_inheritance.pNext = &m_renderingInheritance;
+}
+
+/**
+ *  The chunks are split like <code>ThreadPool::parallelFor()<\code> would, but every chunk knows its index and with
+ *  it the context it records with. A single chunk is recorded on the calling thread, handing it to a worker would only
+ *  add latency.
+*/
+void VulkanParallelRecorder::recordParallel(std::size_t count, std::size_t minChunkSize, const ChunkRecorder& recorder)
+{
+    if(count == 0)
+        return;
+
+    const std::size_t chunkCount{ std::max<std::size_t>(1, std::min(threadCount(), count / std::max<std::size_t>(minChunkSize, 1))) };
+    const std::size_t chunkSize{ (count + chunkCount - 1) / chunkCount };
+
+    if(chunkCount == 1)
+    {
+        const VkCommandBuffer cmdBuffer{ begin(0) };
+        recorder(cmdBuffer, 0, count);
+        end(cmdBuffer, 0);
+        m_recorded.push_back(cmdBuffer);
+
+        return;
+    }
+
+    std::vector<VkCommandBuffer> chunkBuffers(chunkCount, VK_NULL_HANDLE);
+    std::vector<std::future<void>> pending;
+    pending.reserve(chunkCount);
+    for(std::size_t chunk{ 0 }; chunk < chunkCount; ++chunk)
+    {
+        const std::size_t first{ chunk * chunkSize };
+        const std::size_t last{ std::min(first + chunkSize, count) };
+        if(first >= last)
+            break;
+
+        pending.push_back(m_threadPool.submit([this, &recorder, &cmdBuffer = chunkBuffers[chunk], contextIndex = chunk + 1, first, last] {
+            cmdBuffer = begin(contextIndex);
+            recorder(cmdBuffer, first, last);
+            end(cmdBuffer, contextIndex);
+        }));
+    }
+
+    // NOTE: every chunk has to finish before an exception of one of them is rethrown, they all write into this frame
+    for(auto& future : pending)
+        future.wait();
+    for(auto& future : pending)
+        future.get();
+
+    for(const VkCommandBuffer cmdBuffer : chunkBuffers)
+    {
+        if(cmdBuffer != VK_NULL_HANDLE)
+            m_recorded.push_back(cmdBuffer);
+    }
+}
+
+void VulkanParallelRecorder::record(const std::function<void(VkCommandBuffer cmdBuffer)>& recorder)
+{
+    const VkCommandBuffer cmdBuffer{ begin(0) };
+    recorder(cmdBuffer);
+    end(cmdBuffer, 0);
+    m_recorded.push_back(cmdBuffer);
+}
+
+/**
+ *  Chunks are assigned to contexts like in <code>recordParallel()<\code>, except that a single chunk also records
+ *  with the context of chunk 0. A cached command buffer is therefore always recorded with the context it came from.
+*/
+void VulkanParallelRecorder::recordParallelCached(std::uint32_t site, std::size_t count, std::size_t minChunkSize, const ChunkHasher& hasher, const ChunkRecorder& recorder)
+{
+    if(count == 0)
+        return;
+
+    const std::size_t chunkCount{ std::max<std::size_t>(1, std::min(threadCount(), count / std::max<std::size_t>(minChunkSize, 1))) };
+    const std::size_t chunkSize{ (count + chunkCount - 1) / chunkCount };
+
+    // NOTE: entries are looked up up front, the map must not be modified while the workers use it
+    std::vector<CacheEntry*> entries;
+    std::vector<std::future<bool>> pending;
+    for(std::size_t chunk{ 0 }; chunk * chunkSize < count; ++chunk)
+        entries.push_back(&findEntry(site, chunk, chunk + 1));
+
+    const auto recordChunk{ [this, &hasher, &recorder, &entries, chunkSize, count](std::size_t chunk) {
+        const std::size_t first{ chunk * chunkSize };
+        const std::size_t last{ std::min(first + chunkSize, count) };
+
+        // NOTE: the same chunk index covers a different range whenever the item count changes
+        const std::uint64_t hash{ Hasher{}.add(hasher(first, last)).add(first).add(last).value() };
+        return recordEntry(*entries[chunk], hash, chunk + 1, [&recorder, first, last](VkCommandBuffer cmdBuffer) { recorder(cmdBuffer, first, last); });
+    } };
+
+    std::size_t recordedCount{ 0 };
+    if(entries.size() == 1)
+    {
+        recordedCount += static_cast<std::size_t>(recordChunk(0));
+    }
+    else
+    {
+        pending.reserve(entries.size());
+        for(std::size_t chunk{ 0 }; chunk < entries.size(); ++chunk)
+            pending.push_back(m_threadPool.submit([&recordChunk, chunk] { return recordChunk(chunk); }));
+
+        for(auto& future : pending)
+            future.wait();
+        for(auto& future : pending)
+            recordedCount += static_cast<std::size_t>(future.get());
+    }
+
+    m_cacheStatistics.missCount += recordedCount;
+    m_cacheStatistics.hitCount += entries.size() - recordedCount;
+    for(const CacheEntry* entry : entries)
+        m_recorded.push_back(entry->cmdBuffer);
+}
+
+void VulkanParallelRecorder::recordCached(std::uint32_t site, std::uint64_t hash, const std::function<void(VkCommandBuffer cmdBuffer)>& recorder)
+{
+    auto& entry{ findEntry(site, 0, 0) };
+    if(recordEntry(entry, hash, 0, recorder))
+        ++m_cacheStatistics.missCount;
+    else
+        ++m_cacheStatistics.hitCount;
+
+    m_recorded.push_back(entry.cmdBuffer);
+}
+
+void VulkanParallelRecorder::invalidate()
+{
+    for(auto& cache : m_caches)
+    {
+        for(auto& [key, entry] : cache)
+            entry.valid = false;
+    }
+}
+
+void VulkanParallelRecorder::execute(VkCommandBuffer primary)
+{
+    if(!m_recorded.empty())
+        vkCmdExecuteCommands(primary, static_cast<std::uint32_t>(m_recorded.size()), m_recorded.data());
+
+    m_recorded.clear();
+}
+
+VkCommandBuffer VulkanParallelRecorder::begin(std::size_t contextIndex)
+{
+    const VkCommandBuffer cmdBuffer{ m_contexts[contextIndex]->acquire(VK_COMMAND_BUFFER_LEVEL_SECONDARY) };
+
+    VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+        .pInheritanceInfo = &m_inheritance
+    };
+
+    if(vkBeginCommandBuffer(cmdBuffer, &beginInfo) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BEGIN_RECORD_COMMAND_BUFFER, contextIndex);
+
+    return cmdBuffer;
+}
+
+/**
+ *  Cached command buffers inherit the render pass without a framebuffer and are not one time submits, they are
+ *  executed again in later frames of the same frame in flight.
+*/
+bool VulkanParallelRecorder::recordEntry(CacheEntry& entry, std::uint64_t hash, std::size_t contextIndex, const std::function<void(VkCommandBuffer cmdBuffer)>& recorder) const
+{
+    // NOTE: the render pass or attachment formats are part of the inheritance, a cached command buffer is only
+    //       compatible with its own
+    const std::uint64_t inheritedHash{ Hasher{}
+                                           .add(hash)
+                                           .add(m_inheritance.renderPass)
+                                           .add(m_colorFormat)
+                                           .add(m_renderingInheritance.depthAttachmentFormat)
+                                           .value() };
+    if(entry.valid && entry.hash == inheritedHash)
+        return false;
+
+    entry.valid = false;
+
+    VkCommandBufferInheritanceInfo inheritance{ m_inheritance };
+    inheritance.framebuffer = VK_NULL_HANDLE;
+    VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+        .pInheritanceInfo = &inheritance
+    };
+
+    if(vkBeginCommandBuffer(entry.cmdBuffer, &beginInfo) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BEGIN_RECORD_COMMAND_BUFFER, contextIndex);
+
+    recorder(entry.cmdBuffer);
+    end(entry.cmdBuffer, contextIndex);
+
+    entry.hash = inheritedHash;
+    entry.valid = true;
+
+    return true;
+}
+
+VulkanParallelRecorder::CacheEntry& VulkanParallelRecorder::findEntry(std::uint32_t site, std::size_t chunk, std::size_t contextIndex)
+{
+    auto& entry{ m_caches[m_currentFrame][(std::uint64_t{ site } << 32U) | chunk] };
+    if(entry.cmdBuffer == VK_NULL_HANDLE)
+        entry.cmdBuffer = m_contexts[contextIndex]->allocatePersistent(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    return entry;
+}
+
+void VulkanParallelRecorder::end(VkCommandBuffer cmdBuffer, std::size_t contextIndex)
+{
+    if(vkEndCommandBuffer(cmdBuffer) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::END_RECORD_COMMAND_BUFFER, contextIndex);
+}
+
+} // !rr
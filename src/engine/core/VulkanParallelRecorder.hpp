@@ -0,0 +1,120 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_PARALLEL_RECORDER_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_PARALLEL_RECORDER_HPP
+
+#include "core/VulkanDevice.hpp"
+#include "core/VulkanFrameContext.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>VulkanParallelRecorder<\code> records the contents of a render pass into secondary command buffers, split
+ *  into chunks that are recorded on the worker threads of a <code>ThreadPool<\code> at the same time.
+ *
+ *  Command pools must not be used by two threads at once, so there is a <code>VulkanFrameContext<\code> per worker
+ *  plus one for the calling thread, and every chunk of a <code>recordParallel()<\code> call records with a context of
+ *  its own.
+ *
+ *  Secondary command buffers inherit no state but the render pass, or the attachment formats with dynamic rendering,
+ *  every chunk has to bind its pipelines, buffers and dynamic state itself.
+ *
+ *  Content that rarely changes can be recorded into cached command buffers instead. Every frame in flight keeps the
+ *  command buffer and hash of each chunk of a cached call site, a chunk whose hash did not change since that frame
+ *  recorded it the last time is executed again without being recorded. Cached command buffers inherit no framebuffer,
+ *  so they stay valid for every swapchain image.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanParallelRecorder
+{
+public:
+    /** Records items <code>[begin, end)<\code> of a <code>recordParallel()<\code> call */
+    using ChunkRecorder = std::function<void(VkCommandBuffer cmdBuffer, std::size_t begin, std::size_t end)>;
+    /** Hash of everything the commands of items <code>[begin, end)<\code> depend on, called from the worker threads */
+    using ChunkHasher = std::function<std::uint64_t(std::size_t begin, std::size_t end)>;
+
+    struct CacheStatistics
+    {
+        std::size_t hitCount;
+        std::size_t missCount;
+    };
+
+    VulkanParallelRecorder(VulkanDevice& device, std::uint32_t framesInFlight, std::size_t threadCount = ThreadPool::defaultThreadCount());
+    ~VulkanParallelRecorder() = default;
+
+    VulkanParallelRecorder(const VulkanParallelRecorder&) = delete;
+    VulkanParallelRecorder(VulkanParallelRecorder&&) = delete;
+    VulkanParallelRecorder& operator=(const VulkanParallelRecorder&) = delete;
+    VulkanParallelRecorder& operator=(VulkanParallelRecorder&&) = delete;
+
+    /** Reset the pools of <code>frameIndex<\code>, must only be called after the fence of that frame signaled */
+    void beginFrame(std::size_t frameIndex, VkRenderPass renderPass, VkFramebuffer framebuffer);
+    /** Like the other <code>beginFrame()<\code>, but for dynamic rendering into attachments of the given formats */
+    void beginFrame(std::size_t frameIndex, VkFormat colorFormat, VkFormat depthFormat);
+
+    /** Split <code>count<\code> items into chunks of at least <code>minChunkSize<\code> and record every chunk into
+     *  its own secondary command buffer, in parallel when there is more than one chunk */
+    void recordParallel(std::size_t count, std::size_t minChunkSize, const ChunkRecorder& recorder);
+    /** Record a single secondary command buffer on the calling thread */
+    void record(const std::function<void(VkCommandBuffer cmdBuffer)>& recorder);
+
+    /** Like <code>recordParallel()<\code>, but chunks whose hash did not change since this frame in flight recorded
+     *  <code>site<\code> the last time are reused. Every call site of a frame needs its own <code>site<\code> */
+    void recordParallelCached(std::uint32_t site, std::size_t count, std::size_t minChunkSize, const ChunkHasher& hasher, const ChunkRecorder& recorder);
+    /** Like <code>record()<\code>, but reused as long as <code>hash<\code> does not change */
+    void recordCached(std::uint32_t site, std::uint64_t hash, const std::function<void(VkCommandBuffer cmdBuffer)>& recorder);
+    /** Drop every cached command buffer, e.g. after resources they reference without hashing them were recreated */
+    void invalidate();
+
+    /** Execute everything recorded since <code>beginFrame()<\code> in the order it was recorded in, the render pass
+     *  has to be begun with <code>VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS<\code> or dynamic rendering with
+     *  <code>VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT<\code> */
+    void execute(VkCommandBuffer primary);
+
+    [[nodiscard]] std::size_t threadCount() const { return m_threadPool.threadCount(); }
+    [[nodiscard]] CacheStatistics getCacheStatistics() const { return m_cacheStatistics; }
+
+private:
+    struct CacheEntry
+    {
+        VkCommandBuffer cmdBuffer{ VK_NULL_HANDLE };
+        std::uint64_t hash{ 0 };
+        bool valid{ false };
+    };
+
+    ThreadPool m_threadPool;
+    /** Context 0 belongs to the calling thread and context i + 1 to chunk i */
+    std::vector<std::unique_ptr<VulkanFrameContext>> m_contexts;
+    VkCommandBufferInheritanceInfo m_inheritance{};
+    /** Chained to <code>m_inheritance<\code> when rendering dynamically */
+    VkCommandBufferInheritanceRenderingInfo m_renderingInheritance{};
+    VkFormat m_colorFormat{ VK_FORMAT_UNDEFINED };
+    std::vector<VkCommandBuffer> m_recorded;
+
+    /** Per frame in flight, keyed by call site in the upper and chunk in the lower 32 bits */
+    std::vector<std::unordered_map<std::uint64_t, CacheEntry>> m_caches;
+    std::size_t m_currentFrame{ 0 };
+    CacheStatistics m_cacheStatistics{ .hitCount = 0, .missCount = 0 };
+
+    [[nodiscard]] VkCommandBuffer begin(std::size_t contextIndex);
+    /** Re-record <code>entry<\code> unless its hash is still <code>hash<\code>, returns whether it was recorded */
+    bool recordEntry(CacheEntry& entry, std::uint64_t hash, std::size_t contextIndex, const std::function<void(VkCommandBuffer cmdBuffer)>& recorder) const;
+    CacheEntry& findEntry(std::uint32_t site, std::size_t chunk, std::size_t contextIndex);
+    /** <code>contextIndex<\code> only identifies the failing command buffer in the exception */
+    static void end(VkCommandBuffer cmdBuffer, std::size_t contextIndex);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_PARALLEL_RECORDER_HPP
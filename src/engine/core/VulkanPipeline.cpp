@@ -1,9 +1,9 @@
 #include "VulkanPipeline.hpp"
 
-#include "VulkanMesh.hpp"
 #include "exception/EngineException.hpp"
 #include "exception/FileIOException.hpp"
 #include "exception/VulkanException.hpp"
+#include "mesh/Vertex.hpp"
 #include "spdlog/spdlog.h"
 #include <source_location>
 #include <vulkan/vulkan_core.h>
@@ -14,55 +14,65 @@
 #include <filesystem>
 #include <fstream>
 #include <ios>
+#include <span>
 #include <vector>
 
 namespace rr
 {
 
 VulkanPipeline::VulkanPipeline(VkDevice device, const PipelineConfigInfo& configInfo, const std::filesystem::path& vertFilepath, const std::filesystem::path& fragFilepath)
+    : VulkanPipeline(device, configInfo, std::array{ ShaderStageInfo{ VK_SHADER_STAGE_VERTEX_BIT, vertFilepath }, ShaderStageInfo{ VK_SHADER_STAGE_FRAGMENT_BIT, fragFilepath } })
+{}
+
+VulkanPipeline::VulkanPipeline(VkDevice device, const PipelineConfigInfo& configInfo, std::span<const ShaderStageInfo> stages)
     : device(device)
 {
     assert(configInfo.pipelineLayout != VK_NULL_HANDLE && "Cannot create graphics pipeline: no pipeline layout provided");
-    assert(configInfo.renderPass != VK_NULL_HANDLE && "Cannot create graphics pipeline: no renderPass provided");
-
-    createShaderModule(readFile(vertFilepath), &m_vertShaderModule);
-    createShaderModule(readFile(fragFilepath), &m_fragShaderModule);
-
-    std::array<VkPipelineShaderStageCreateInfo,2 > shaderStages{
-        {
-            {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-                .flags = 0,
-                .stage = VK_SHADER_STAGE_VERTEX_BIT,
-                .module = m_vertShaderModule,
-                .pName = "main"
-            },
-            {
-                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-                .flags = 0,
-                .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-                .module = m_fragShaderModule,
-                .pName = "main"
-            }
-        }
-    };
+    assert((configInfo.renderPass != VK_NULL_HANDLE || configInfo.colorAttachmentFormat != VK_FORMAT_UNDEFINED) && "Cannot create graphics pipeline: neither renderPass nor attachment formats provided");
+
+    std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+    shaderStages.reserve(stages.size());
+    bool hasVertexStage{ false };
+    for(const auto& stage : stages)
+    {
+        m_shaderModules.push_back(createShaderModule(readFile(stage.path)));
+        shaderStages.push_back({
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .flags = 0,
+            .stage = stage.stage,
+            .module = m_shaderModules.back(),
+            .pName = "main"
+        });
+
+        hasVertexStage = hasVertexStage || stage.stage == VK_SHADER_STAGE_VERTEX_BIT;
+    }
 
-    auto bindingDescriptions = Vertex::getBindingDescriptions();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount = static_cast<std::uint32_t>(bindingDescriptions.size()),
-        .pVertexBindingDescriptions = bindingDescriptions.data(),
-        .vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributeDescriptions.size()),
-        .pVertexAttributeDescriptions = attributeDescriptions.data()
+        .vertexBindingDescriptionCount = static_cast<std::uint32_t>(configInfo.bindingDescriptions.size()),
+        .pVertexBindingDescriptions = configInfo.bindingDescriptions.data(),
+        .vertexAttributeDescriptionCount = static_cast<std::uint32_t>(configInfo.attributeDescriptions.size()),
+        .pVertexAttributeDescriptions = configInfo.attributeDescriptions.data()
+    };
+
+    // NOTE: mesh shading pipelines generate their primitives themselves and must not specify vertex input state
+    // NOTE: only chained without a render pass, the pipeline is then compatible with any attachments of these formats
+    const VkPipelineRenderingCreateInfo renderingInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &configInfo.colorAttachmentFormat,
+        .depthAttachmentFormat = configInfo.depthAttachmentFormat,
+        .stencilAttachmentFormat = VK_FORMAT_UNDEFINED
     };
 
     VkGraphicsPipelineCreateInfo pipelineInfo{
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .stageCount = 2,
+        .pNext = configInfo.renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr,
+        .stageCount = static_cast<std::uint32_t>(shaderStages.size()),
         .pStages = shaderStages.data(),
-        .pVertexInputState = &vertexInputInfo,
-        .pInputAssemblyState = &configInfo.inputAssemblyInfo,
+        .pVertexInputState = hasVertexStage ? &vertexInputInfo : nullptr,
+        .pInputAssemblyState = hasVertexStage ? &configInfo.inputAssemblyInfo : nullptr,
         .pViewportState = &configInfo.viewportInfo,
         .pRasterizationState = &configInfo.rasterizationInfo,
         .pMultisampleState = &configInfo.multisampleInfo,
@@ -82,16 +92,45 @@ VulkanPipeline::VulkanPipeline(VkDevice device, const PipelineConfigInfo& config
     spdlog::info("Created graphics pipeline successfully...");
 }
 
+VulkanPipeline::VulkanPipeline(VkDevice device, VkPipelineLayout pipelineLayout, const std::filesystem::path& compFilepath)
+    : device(device)
+    , m_bindPoint(VK_PIPELINE_BIND_POINT_COMPUTE)
+{
+    assert(pipelineLayout != VK_NULL_HANDLE && "Cannot create compute pipeline: no pipeline layout provided");
+
+    m_shaderModules.push_back(createShaderModule(readFile(compFilepath)));
+
+    VkComputePipelineCreateInfo pipelineInfo{
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .flags = 0,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = m_shaderModules.back(),
+            .pName = "main"
+        },
+        .layout = pipelineLayout,
+        .basePipelineHandle = VK_NULL_HANDLE,
+        .basePipelineIndex = -1
+    };
+
+    if(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_COMPUTE_PIPELINE);
+
+    spdlog::info("Created compute pipeline successfully...");
+}
+
 VulkanPipeline::~VulkanPipeline()
 {
-    vkDestroyShaderModule(device, m_vertShaderModule, nullptr);
-    vkDestroyShaderModule(device, m_fragShaderModule, nullptr);
+    for(const auto shaderModule : m_shaderModules)
+        vkDestroyShaderModule(device, shaderModule, nullptr);
 
     vkDestroyPipeline(device, m_pipeline, nullptr);
 }
 
 void VulkanPipeline::defaultPipelineConfigInfo(PipelineConfigInfo& configInfo)
 {
+    configInfo.setVertexLayout<Vertex>();
     configInfo.inputAssemblyInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
         .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
@@ -168,10 +207,10 @@ void VulkanPipeline::defaultPipelineConfigInfo(PipelineConfigInfo& configInfo)
 
 void VulkanPipeline::bind(VkCommandBuffer cmdBuffer)
 {
-    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindPipeline(cmdBuffer, m_bindPoint, m_pipeline);
 }
 
-void VulkanPipeline::createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule)
+VkShaderModule VulkanPipeline::createShaderModule(const std::vector<char>& code)
 {
     VkShaderModuleCreateInfo createInfo{
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
@@ -179,8 +218,11 @@ void VulkanPipeline::createShaderModule(const std::vector<char>& code, VkShaderM
         .pCode = reinterpret_cast<const std::uint32_t*>(code.data())
     };
 
-    if(vkCreateShaderModule(device, &createInfo, nullptr, shaderModule) != VK_SUCCESS)
+    VkShaderModule shaderModule{ VK_NULL_HANDLE };
+    if(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
         throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_SHADER_MODULE);
+
+    return shaderModule;
 }
 
 std::vector<char> VulkanPipeline::readFile(const std::filesystem::path& filepath)
@@ -1,10 +1,13 @@
 #ifndef RRENDERER_ENGINE_CORE_VULKAN_PIPELINE_HPP
 #define RRENDERER_ENGINE_CORE_VULKAN_PIPELINE_HPP
 
+#include "mesh/VertexLayout.hpp"
+
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
 #include <filesystem>
+#include <span>
 #include <vector>
 
 namespace rr
@@ -20,6 +23,16 @@ struct PipelineConfigInfo
     PipelineConfigInfo(const PipelineConfigInfo&) = delete;
     PipelineConfigInfo& operator=(const PipelineConfigInfo&) = delete;
 
+    /** Point the vertex input state at the compile time descriptions of <code>V<\code> */
+    template<VertexType V>
+    void setVertexLayout()
+    {
+        bindingDescriptions = VERTEX_BINDING_DESCRIPTIONS<V>;
+        attributeDescriptions = VERTEX_ATTRIBUTE_DESCRIPTIONS<V>;
+    }
+
+    std::span<const VkVertexInputBindingDescription> bindingDescriptions;
+    std::span<const VkVertexInputAttributeDescription> attributeDescriptions;
     VkPipelineViewportStateCreateInfo viewportInfo{};
     VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo{};
     VkPipelineRasterizationStateCreateInfo rasterizationInfo{};
@@ -32,12 +45,25 @@ struct PipelineConfigInfo
     VkPipelineLayout pipelineLayout{ nullptr };
     VkRenderPass renderPass{ nullptr };
     std::uint32_t subpass{ 0 };
+    /** Without a <code>renderPass<\code> the pipeline is created for dynamic rendering into attachments of these formats */
+    VkFormat colorAttachmentFormat{ VK_FORMAT_UNDEFINED };
+    VkFormat depthAttachmentFormat{ VK_FORMAT_UNDEFINED };
+};
+
+struct ShaderStageInfo
+{
+    VkShaderStageFlagBits stage;
+    std::filesystem::path path;
 };
 
 class VulkanPipeline
 {
 public:
     VulkanPipeline(VkDevice device, const PipelineConfigInfo& configInfo, const std::filesystem::path& vertFilepath, const std::filesystem::path& fragFilepath);
+    /** Graphics pipeline of arbitrary stages, without a vertex stage the vertex input and input assembly are ignored */
+    VulkanPipeline(VkDevice device, const PipelineConfigInfo& configInfo, std::span<const ShaderStageInfo> stages);
+    /** Compute pipeline */
+    VulkanPipeline(VkDevice device, VkPipelineLayout pipelineLayout, const std::filesystem::path& compFilepath);
     ~VulkanPipeline();
 
     VulkanPipeline(const VulkanPipeline&) = delete;
@@ -53,10 +79,10 @@ private:
     VkDevice device;
 
     VkPipeline m_pipeline{ VK_NULL_HANDLE };
-    VkShaderModule m_vertShaderModule{ VK_NULL_HANDLE };
-    VkShaderModule m_fragShaderModule{ VK_NULL_HANDLE };
+    VkPipelineBindPoint m_bindPoint{ VK_PIPELINE_BIND_POINT_GRAPHICS };
+    std::vector<VkShaderModule> m_shaderModules;
 
-    void createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule);
+    [[nodiscard]] VkShaderModule createShaderModule(const std::vector<char>& code);
 
     // TODO: move to dedicated file io class
     static std::vector<char> readFile(const std::filesystem::path& filepath);
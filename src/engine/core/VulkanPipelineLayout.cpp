@@ -5,24 +5,21 @@
 #include <source_location>
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace rr
 {
 
-VulkanPipelineLayout::VulkanPipelineLayout(VkDevice device)
+VulkanPipelineLayout::VulkanPipelineLayout(VkDevice device, const std::vector<VkDescriptorSetLayout>& setLayouts)
     : device(device)
 {
-    VkPushConstantRange pushConstantRange{
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-        .offset = 0,
-        .size = sizeof(SimplePushConstantData)
-    };
-
     VkPipelineLayoutCreateInfo createInfo{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = 0,
-        .pSetLayouts = nullptr,
-        .pushConstantRangeCount = 1,
-        .pPushConstantRanges = &pushConstantRange
+        .setLayoutCount = static_cast<std::uint32_t>(setLayouts.size()),
+        .pSetLayouts = setLayouts.data(),
+        .pushConstantRangeCount = 0,
+        .pPushConstantRanges = nullptr
     };
 
     if(vkCreatePipelineLayout(device, &createInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
@@ -8,12 +8,18 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
+#include <vector>
+
 namespace rr
 {
 
 constexpr std::size_t ALIGN_OF_VEC3{ 16 };
 
-struct SimplePushConstantData
+/**
+ *  Per draw data read through the dynamic uniform binding of the frame allocator, laid out according to std140.
+*/
+struct DrawData
 {
     glm::vec2 offset;
     alignas(ALIGN_OF_VEC3) glm::vec3 color;
@@ -22,7 +28,7 @@ struct SimplePushConstantData
 class VulkanPipelineLayout
 {
 public:
-    explicit VulkanPipelineLayout(VkDevice device);
+    VulkanPipelineLayout(VkDevice device, const std::vector<VkDescriptorSetLayout>& setLayouts);
     ~VulkanPipelineLayout();
 
     VulkanPipelineLayout(const VulkanPipelineLayout&) = delete;
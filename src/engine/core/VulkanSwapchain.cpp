@@ -1,6 +1,7 @@
 #include "VulkanSwapchain.hpp"
 
 #include "core/VulkanDevice.hpp"
+#include "core/VulkanTransientAttachments.hpp"
 
 #include "exception/EngineException.hpp"
 #include "exception/VulkanException.hpp"
@@ -11,33 +12,31 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <limits>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace rr
 {
 
-VulkanSwapchain::VulkanSwapchain(VulkanDevice& device, VkSurfaceKHR surface, VkExtent2D windowExtent)
+VulkanSwapchain::VulkanSwapchain(VulkanDevice& device, VkSurfaceKHR surface, VkExtent2D windowExtent, bool dynamicRendering)
     : device(device)
     , surface(surface)
     , windowExtent(windowExtent)
+    , m_dynamicRendering(dynamicRendering)
 {
     createVulkanSwapchain();
 }
 
-VulkanSwapchain::VulkanSwapchain(VulkanDevice& device, VkSurfaceKHR surface, VkExtent2D windowExtent, std::shared_ptr<VulkanSwapchain> previous)
-    : device(device)
-    , surface(surface)
-    , windowExtent{ windowExtent }
-{
-    createVulkanSwapchain(previous);
-}
-
 VulkanSwapchain::~VulkanSwapchain()
 {
+    releaseRetiredResources(true);
+
     auto count = imageCount();
 
     for(auto* const imageView : m_swapchainImageViews)
@@ -50,16 +49,11 @@ VulkanSwapchain::~VulkanSwapchain()
         m_swapchain = nullptr;
     }
 
-    for(std::size_t i{0}; i < m_depthImages.size(); ++i)
-    {
-        vkDestroyImageView(device.getHandle(), m_depthImageViews[i], nullptr);
-        vkDestroyImage(device.getHandle(), m_depthImages[i], nullptr);
-        vkFreeMemory(device.getHandle(), m_depthImagesMemory[i], nullptr);
-    }
-
     for(auto* const framebuffe : m_swapchainFramebuffers)
         vkDestroyFramebuffer(device.getHandle(), framebuffe, nullptr);
 
+    m_transientAttachments.reset();
+
     vkDestroyRenderPass(device.getHandle(), m_renderPass, nullptr);
 
     for(std::size_t i{0}; i < count; ++i)
@@ -77,23 +71,43 @@ VulkanSwapchain::~VulkanSwapchain()
 VkResult VulkanSwapchain::acquireNextImage(std::uint32_t* imageIndex)
 {
     vkWaitForFences(device.getHandle(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+    releaseRetiredResources(false);
 
     return vkAcquireNextImageKHR(device.getHandle(), m_swapchain, std::numeric_limits<std::uint64_t>::max(), m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, imageIndex);
 }
 
-VkResult VulkanSwapchain::submitCommandBuffer(const VkCommandBuffer* commandBuffer, const std::uint32_t* imageIndex)
+VkResult VulkanSwapchain::submitCommandBuffer(const VkCommandBuffer* commandBuffer, const std::uint32_t* imageIndex, VkSemaphore uploadSemaphore, std::uint64_t uploadValue)
 {
     if(m_imagesInFlight[*imageIndex] != VK_NULL_HANDLE)
         vkWaitForFences(device.getHandle(), 1, &m_imagesInFlight[*imageIndex], VK_TRUE, std::numeric_limits<std::uint64_t>::max());
 
     m_imagesInFlight[*imageIndex] = m_inFlightFences[m_currentFrame];
 
-    std::array<VkSemaphore, 1> waitSemaphores{ m_imageAvailableSemaphores[m_currentFrame] };
-    std::array<VkPipelineStageFlags, 1> waitStages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    // NOTE: the timeline wait on the upload semaphore is optional, the binary semaphore ignores its wait value. Uploaded
+    //       buffers are also read by compute shaders, e.g. the objects culled by the GPU scene and the meshlets culled
+    //       by the meshlet culler, and by task and mesh shaders, which may only be waited on if they are enabled
+    VkPipelineStageFlags uploadStages{
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+    };
+    if(device.supportsMeshShaders())
+        uploadStages |= VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT;
+
+    std::array<VkSemaphore, 2> waitSemaphores{ m_imageAvailableSemaphores[m_currentFrame], uploadSemaphore };
+    std::array<VkPipelineStageFlags, 2> waitStages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, uploadStages };
+    std::array<std::uint64_t, 2> waitValues{ 0, uploadValue };
+    const std::uint32_t waitSemaphoreCount{ uploadSemaphore == VK_NULL_HANDLE ? 1U : 2U };
     std::array<VkSemaphore, 1> signalSemaphore{ m_renderFinishedSemaphores[*imageIndex] };
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = waitSemaphoreCount,
+        .pWaitSemaphoreValues = waitValues.data()
+    };
     VkSubmitInfo submitInfo{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount = static_cast<std::uint32_t>(waitSemaphores.size()),
+        .pNext = &timelineInfo,
+        .waitSemaphoreCount = waitSemaphoreCount,
         .pWaitSemaphores = waitSemaphores.data(),
         .pWaitDstStageMask = waitStages.data(),
         .commandBufferCount = 1,
@@ -119,34 +133,203 @@ VkResult VulkanSwapchain::submitCommandBuffer(const VkCommandBuffer* commandBuff
     auto result{ vkQueuePresentKHR(device.getPresentQueueHandle(), &presentInfo) };
 
     m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    ++m_submittedFrames;
 
     return result;
 }
 
 VkFramebuffer VulkanSwapchain::getFramebufferHandle(std::size_t index) const
 {
-    if(index >= m_swapchainFramebuffers.size())
+    assert(!m_dynamicRendering && "Dynamic rendering does not use framebuffers");
+
+    if(index >= imageCount())
         throw std::out_of_range("The element that was tried to access does not exist");
 
-    return m_swapchainFramebuffers[index];
+    return m_swapchainFramebuffers[m_currentFrame * imageCount() + index];
+}
+
+/**
+ *  The render pass path gets its layout transitions and the dependency on the last use of the attachments from the
+ *  render pass, with dynamic rendering they are recorded as barriers. The contents of both attachments are discarded,
+ *  so they are transitioned from <code>VK_IMAGE_LAYOUT_UNDEFINED<\code>.
+*/
+void VulkanSwapchain::beginRendering(VkCommandBuffer cmdBuffer, std::size_t imageIndex, const VkClearColorValue& clearColor, VkRenderingFlags flags) const
+{
+    assert(m_dynamicRendering && "Swapchain was created for render passes");
+
+    // NOTE: both aspects of a combined depth stencil format have to be transitioned together
+    VkImageAspectFlags depthAspect{ VK_IMAGE_ASPECT_DEPTH_BIT };
+    if(m_depthFormat != VK_FORMAT_D32_SFLOAT)
+        depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+
+    const std::array barriers{
+        VkImageMemoryBarrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = m_swapchainImages.at(imageIndex),
+            .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+        },
+        VkImageMemoryBarrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = m_transientAttachments->getImage(m_currentFrame, DEPTH_ATTACHMENT),
+            .subresourceRange = { .aspectMask = depthAspect, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+        }
+    };
+
+    // NOTE: the wait on the image available semaphore happens in the color attachment output stage, which the color
+    //       transition has to wait for as well
+    const VkPipelineStageFlags stages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT };
+    vkCmdPipelineBarrier(cmdBuffer, stages, stages, 0, 0, nullptr, 0, nullptr, static_cast<std::uint32_t>(barriers.size()), barriers.data());
+
+    const VkRenderingAttachmentInfo colorAttachment{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = m_swapchainImageViews.at(imageIndex),
+        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .clearValue = { .color = clearColor }
+    };
+    const VkRenderingAttachmentInfo depthAttachment{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = m_transientAttachments->getView(m_currentFrame, DEPTH_ATTACHMENT),
+        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .clearValue = { .depthStencil = { 1.f, 0 } }
+    };
+    const VkRenderingInfo renderingInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+        .flags = flags,
+        .renderArea = {
+            .offset = { 0, 0 },
+            .extent = m_swapchainImageExtent
+        },
+        .layerCount = 1,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colorAttachment,
+        .pDepthAttachment = &depthAttachment,
+        .pStencilAttachment = nullptr
+    };
+
+    device.cmdBeginRendering(cmdBuffer, renderingInfo);
+}
+
+void VulkanSwapchain::endRendering(VkCommandBuffer cmdBuffer, std::size_t imageIndex) const
+{
+    assert(m_dynamicRendering && "Swapchain was created for render passes");
+
+    device.cmdEndRendering(cmdBuffer);
+
+    const VkImageMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = 0,
+        .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = m_swapchainImages.at(imageIndex),
+        .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 }
+    };
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+/**
+ *  Recreate the swapchain for a new window extent without waiting for the device. Only resources invalidated by the
+ *  new swapchain are rebuilt, the render pass is kept as long as the surface format stays the same and depth buffers
+ *  as long as the extent does. With dynamic rendering there is no render pass or framebuffer to rebuild at all.
+ *  Replaced resources are retired and destroyed once no frame in flight uses them.
+ *
+ *  @returns bool - true if the surface format changed and pipelines created for it have to be recreated
+*/
+bool VulkanSwapchain::recreate(VkExtent2D newWindowExtent)
+{
+    windowExtent = newWindowExtent;
+
+    const VkFormat previousFormat{ m_swapchainImageFormat };
+    const VkExtent2D previousExtent{ m_swapchainImageExtent };
+
+    RetiredResources retired{
+        .swapchain = m_swapchain,
+        .imageViews = std::move(m_swapchainImageViews),
+        .framebuffers = std::move(m_swapchainFramebuffers),
+        .renderFinishedSemaphores = std::move(m_renderFinishedSemaphores),
+        .renderPass = VK_NULL_HANDLE,
+        .transientAttachments = nullptr,
+        .frame = m_submittedFrames
+    };
+    m_swapchainImageViews.clear();
+    m_swapchainFramebuffers.clear();
+    m_renderFinishedSemaphores.clear();
+
+    createSwapchain(retired.swapchain);
+    createImageViews();
+
+    const bool formatChanged{ m_swapchainImageFormat != previousFormat };
+    if(formatChanged && !m_dynamicRendering)
+    {
+        retired.renderPass = m_renderPass;
+        createRenderPass();
+    }
+
+    if(m_swapchainImageExtent.width != previousExtent.width || m_swapchainImageExtent.height != previousExtent.height)
+    {
+        retired.transientAttachments = std::move(m_transientAttachments);
+        createDepthResources();
+    }
+
+    if(!m_dynamicRendering)
+        createFramebuffers();
+    createRenderFinishedSemaphores();
+    m_imagesInFlight.assign(imageCount(), VK_NULL_HANDLE);
+
+    m_retired.push_back(std::move(retired));
+
+    // NOTE: without frames being submitted nothing is released, so fall back to a stall if resizes pile up
+    if(m_retired.size() > MAX_RETIRED_SWAPCHAINS)
+    {
+        vkDeviceWaitIdle(device.getHandle());
+        releaseRetiredResources(true);
+    }
+
+    return formatChanged;
 }
 
-void VulkanSwapchain::createVulkanSwapchain(std::shared_ptr<VulkanSwapchain> previous)
+void VulkanSwapchain::createVulkanSwapchain()
 {
-    createSwapchain(previous);
+    m_depthFormat = findDepthFormat();
+
+    createSwapchain(VK_NULL_HANDLE);
     createImageViews();
-    createRenderPass();
+    if(!m_dynamicRendering)
+        createRenderPass();
     createDepthResources();
-    createFramebuffers();
+    if(!m_dynamicRendering)
+        createFramebuffers();
+    createRenderFinishedSemaphores();
     createSyncObjects();
 }
 
 /**
  *  Set up the swapchain with format, extent and used queues.
 */
-void VulkanSwapchain::createSwapchain(std::shared_ptr<VulkanSwapchain> previous)
+void VulkanSwapchain::createSwapchain(VkSwapchainKHR oldSwapchain)
 {
-    SwapchainSupportDetails swapchainSupport{ device.getSwapchainSupport() };
+    const SwapchainSupportDetails& swapchainSupport{ device.getSwapchainSupport() };
 
     VkSurfaceFormatKHR surfaceFormat{ chooseSwapSurfaceFormat(swapchainSupport.formats) };
     VkPresentModeKHR presentMode{ chooseSwapPresentMode(swapchainSupport.presentModes) };
@@ -173,10 +356,10 @@ void VulkanSwapchain::createSwapchain(std::shared_ptr<VulkanSwapchain> previous)
         .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .presentMode = presentMode,
         .clipped = VK_TRUE,
-        .oldSwapchain = previous == nullptr ? VK_NULL_HANDLE : previous->getHandle()
+        .oldSwapchain = oldSwapchain
     };
 
-    QueueFamilyIndices indices{ device.findPhysicalQueueFamilies() };
+    const QueueFamilyIndices& indices{ device.findPhysicalQueueFamilies() };
     if(!indices.areSameQueue())
     {
         auto queueFamilyIndices{ indices.toAray() };
@@ -230,7 +413,7 @@ void VulkanSwapchain::createImageViews()
 void VulkanSwapchain::createRenderPass()
 {
     VkAttachmentDescription depthAttachment{
-        .format = findDepthFormat(),
+        .format = m_depthFormat,
         .samples = VK_SAMPLE_COUNT_1_BIT,
         .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
         .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
@@ -293,93 +476,81 @@ void VulkanSwapchain::createRenderPass()
 }
 
 /**
- *  Set up the depth images, image views and their memory on the device.
+ *  Set up the depth buffers. Only one per frame in flight is needed since they are never read after a frame.
 */
 void VulkanSwapchain::createDepthResources()
 {
-    VkFormat depthFormat{ findDepthFormat() };
-    VkExtent2D swapchainExtent{ m_swapchainImageExtent };
+    const std::vector<TransientAttachmentInfo> attachments{
+        {
+            .format = m_depthFormat,
+            .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            .aspect = VK_IMAGE_ASPECT_DEPTH_BIT,
+            .category = MemoryCategory::DEPTH,
+            .firstPass = 0,
+            .lastPass = 0
+        }
+    };
 
-    m_depthImages.resize(imageCount());
-    m_depthImagesMemory.resize(imageCount());
-    m_depthImageViews.resize(imageCount());
+    m_transientAttachments = std::make_unique<VulkanTransientAttachments>(device, attachments, MAX_FRAMES_IN_FLIGHT, m_swapchainImageExtent);
+}
 
-    for(std::size_t i{0}; i < imageCount(); ++i)
+/**
+ *  Set up the framebuffers which are use by the swapchain to display frames. There is one for every combination of
+ *  swapchain image and frame in flight, since the depth buffer belongs to the frame and not to the image.
+*/
+void VulkanSwapchain::createFramebuffers()
+{
+    m_swapchainFramebuffers.resize(MAX_FRAMES_IN_FLIGHT * imageCount());
+
+    for(std::size_t frame{0}; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
     {
-        VkImageCreateInfo imageCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-            .flags = 0,
-            .imageType = VK_IMAGE_TYPE_2D,
-            .format = depthFormat,
-            .extent = {
+        for(std::size_t i{0}; i < imageCount(); ++i)
+        {
+            std::array<VkImageView, 2> attachments{ m_swapchainImageViews[i], m_transientAttachments->getView(frame, DEPTH_ATTACHMENT) };
+
+            VkExtent2D swapchainExtent{ m_swapchainImageExtent };
+            VkFramebufferCreateInfo createInfo{
+                .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+                .renderPass = m_renderPass,
+                .attachmentCount = static_cast<std::uint32_t>(attachments.size()),
+                .pAttachments = attachments.data(),
                 .width = swapchainExtent.width,
                 .height = swapchainExtent.height,
-                .depth = 1
-            },
-            .mipLevels = 1,
-            .arrayLayers = 1,
-            .samples = VK_SAMPLE_COUNT_1_BIT,
-            .tiling = VK_IMAGE_TILING_OPTIMAL,
-            .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
-        };
-
-        device.createImageWithInfo(imageCreateInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImages[i], m_depthImagesMemory[i]);
+                .layers = 1
+            };
 
-        VkImageViewCreateInfo imageViewCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-            .image = m_depthImages[i],
-            .viewType = VK_IMAGE_VIEW_TYPE_2D,
-            .format = depthFormat,
-            .subresourceRange = {
-                .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
-                .baseMipLevel = 0,
-                .levelCount = 1,
-                .baseArrayLayer = 0,
-                .layerCount = 1
-            }
-        };
-
-        if(vkCreateImageView(device.getHandle(), &imageViewCreateInfo, nullptr, &m_depthImageViews[i]) != VK_SUCCESS)
-            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_IMAGE_VIEW, i);
+            const std::size_t index{ frame * imageCount() + i };
+            if(vkCreateFramebuffer(device.getHandle(), &createInfo, nullptr, &m_swapchainFramebuffers[index]) != VK_SUCCESS)
+                throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_FRAMEBUFFER, index);
+        }
     }
 }
 
 /**
- *  Set up the framebuffers which are use by the swapchain to display frames.
+ *  Set up the semaphores signaled when an image was rendered, there is one per swapchain image.
 */
-void VulkanSwapchain::createFramebuffers()
+void VulkanSwapchain::createRenderFinishedSemaphores()
 {
-    m_swapchainFramebuffers.resize(imageCount());
+    m_renderFinishedSemaphores.resize(imageCount());
 
-    for(std::size_t i{0}; i < imageCount(); ++i)
-    {
-        std::array<VkImageView, 2> attachments{ m_swapchainImageViews[i], m_depthImageViews[i] };
-
-        VkExtent2D swapchainExtent{ m_swapchainImageExtent };
-        VkFramebufferCreateInfo createInfo{
-            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass = m_renderPass,
-            .attachmentCount = static_cast<std::uint32_t>(attachments.size()),
-            .pAttachments = attachments.data(),
-            .width = swapchainExtent.width,
-            .height = swapchainExtent.height,
-            .layers = 1
-        };
+    VkSemaphoreCreateInfo semaphoreCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    };
 
-        if(vkCreateFramebuffer(device.getHandle(), &createInfo, nullptr, &m_swapchainFramebuffers[i]) != VK_SUCCESS)
-            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_FRAMEBUFFER, i);
+    for(std::size_t i{0}; i < m_renderFinishedSemaphores.size(); ++i)
+    {
+        if(vkCreateSemaphore(device.getHandle(), &semaphoreCreateInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
+            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_SEMAPHORE, i);
     }
 }
 
 /**
- *  Set up the semaphores and fences used during the presentation of frames.
+ *  Set up the semaphores and fences used during the presentation of frames. They belong to the frames in flight and
+ *  survive recreation.
 */
 void VulkanSwapchain::createSyncObjects()
 {
     m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(imageCount());
     m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
     m_imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
 
@@ -392,12 +563,6 @@ void VulkanSwapchain::createSyncObjects()
         .flags = VK_FENCE_CREATE_SIGNALED_BIT
     };
 
-    for(std::size_t i{0}; i < m_renderFinishedSemaphores.size(); ++i)
-    {
-        if(vkCreateSemaphore(device.getHandle(), &semaphoreCreateInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS)
-            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_SEMAPHORE, i);
-    }
-
     for(std::size_t i{0}; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
         if(vkCreateSemaphore(device.getHandle(), &semaphoreCreateInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
@@ -406,6 +571,36 @@ void VulkanSwapchain::createSyncObjects()
     }
 }
 
+/**
+ *  Destroy resources replaced by <code>recreate()<\code>. Presentation is not covered by the frame fences, so
+ *  resources are kept one frame longer than the frames in flight that could still use them.
+ *
+ *  @param all - destroy every retired resource, the device has to be idle
+*/
+void VulkanSwapchain::releaseRetiredResources(bool all)
+{
+    while(!m_retired.empty() && (all || m_retired.front().frame + MAX_FRAMES_IN_FLIGHT <= m_submittedFrames))
+    {
+        auto& retired{ m_retired.front() };
+
+        for(auto* const framebuffer : retired.framebuffers)
+            vkDestroyFramebuffer(device.getHandle(), framebuffer, nullptr);
+
+        for(auto* const imageView : retired.imageViews)
+            vkDestroyImageView(device.getHandle(), imageView, nullptr);
+
+        for(auto* const semaphore : retired.renderFinishedSemaphores)
+            vkDestroySemaphore(device.getHandle(), semaphore, nullptr);
+
+        if(retired.renderPass != VK_NULL_HANDLE)
+            vkDestroyRenderPass(device.getHandle(), retired.renderPass, nullptr);
+
+        vkDestroySwapchainKHR(device.getHandle(), retired.swapchain, nullptr);
+
+        m_retired.pop_front();
+    }
+}
+
 /**
  *  Choose a Extent2D for the swapchain.
  *
@@ -1,13 +1,16 @@
 #ifndef RRENDERER_ENGINE_CORE_SWAPCHAIN_HPP
 #define RRENDERER_ENGINE_CORE_SWAPCHAIN_HPP
 
+#include "core/VulkanAllocator.hpp"
 #include "core/VulkanDevice.hpp"
+#include "core/VulkanTransientAttachments.hpp"
 
 #include <memory>
 #include <vulkan/vulkan_core.h>
 
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <vector>
 
 namespace rr
@@ -17,14 +20,17 @@ namespace rr
  *  <code>VulkanSwapchain<\code> is a wrapper around <code>VkSwapchainKHR<\code> and all supporting resources
  *  like render passes, depth resources and sync objects.
  *
+ *  With <code>dynamicRendering<\code> no render pass and framebuffers are created, frames are rendered with
+ *  <code>beginRendering()<\code> and <code>endRendering()<\code> straight into the swapchain image and depth buffer
+ *  instead, which also takes care of their layout transitions.
+ *
  *  @author Felix Hommel
  *  @date 5/26/2025
 */
 class VulkanSwapchain
 {
 public:
-    VulkanSwapchain(VulkanDevice& device, VkSurfaceKHR surface, VkExtent2D windowExtent);
-    VulkanSwapchain(VulkanDevice& device, VkSurfaceKHR surface, VkExtent2D windowExtent, std::shared_ptr<VulkanSwapchain> previous);
+    VulkanSwapchain(VulkanDevice& device, VkSurfaceKHR surface, VkExtent2D windowExtent, bool dynamicRendering = false);
     ~VulkanSwapchain();
 
     VulkanSwapchain(const VulkanSwapchain&) = delete;
@@ -33,20 +39,50 @@ public:
     VulkanSwapchain& operator=(VulkanSwapchain&&) = delete;
 
     static constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT{ 2 };
+    /** Index of the depth buffer in the transient attachments */
+    static constexpr std::size_t DEPTH_ATTACHMENT{ 0 };
+    /** Recreations that may wait for frames to finish before the device is stalled to release them */
+    static constexpr std::size_t MAX_RETIRED_SWAPCHAINS{ 4 };
 
     [[nodiscard]] std::size_t imageCount() const { return m_swapchainImages.size(); }
     [[nodiscard]] VkExtent2D getExtent() const { return m_swapchainImageExtent; }
+    [[nodiscard]] std::size_t getCurrentFrame() const { return m_currentFrame; }
+    [[nodiscard]] VkFormat getImageFormat() const { return m_swapchainImageFormat; }
+    [[nodiscard]] VkFormat getDepthFormat() const { return m_depthFormat; }
+    [[nodiscard]] bool usesDynamicRendering() const { return m_dynamicRendering; }
+
+    [[nodiscard]] bool recreate(VkExtent2D newWindowExtent);
 
     /** Presentation utility */
     [[nodiscard]] VkResult acquireNextImage(std::uint32_t* imageIndex);
-    [[nodiscard]] VkResult submitCommandBuffer(const VkCommandBuffer* commandBuffer, const std::uint32_t* imageIndex);
+    [[nodiscard]] VkResult submitCommandBuffer(const VkCommandBuffer* commandBuffer, const std::uint32_t* imageIndex, VkSemaphore uploadSemaphore = VK_NULL_HANDLE, std::uint64_t uploadValue = 0);
+
+    /** Dynamic rendering into swapchain image <code>imageIndex<\code> and the depth buffer of the current frame, both
+     *  are cleared */
+    void beginRendering(VkCommandBuffer cmdBuffer, std::size_t imageIndex, const VkClearColorValue& clearColor, VkRenderingFlags flags) const;
+    /** End dynamic rendering and transition swapchain image <code>imageIndex<\code> for presentation */
+    void endRendering(VkCommandBuffer cmdBuffer, std::size_t imageIndex) const;
 
     /** Raw handle access */
     [[nodiscard]] VkSwapchainKHR getHandle() const { return m_swapchain; }
+    /** <code>VK_NULL_HANDLE<\code> with dynamic rendering */
     [[nodiscard]] VkRenderPass getRenderPassHandle() const { return m_renderPass; }
+    /** Framebuffer of swapchain image <code>index<\code> combined with the attachments of the current frame */
     [[nodiscard]] VkFramebuffer getFramebufferHandle(std::size_t index) const;
 
 private:
+    /** Resources replaced during recreation that frames in flight may still use */
+    struct RetiredResources
+    {
+        VkSwapchainKHR swapchain;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkFramebuffer> framebuffers;
+        std::vector<VkSemaphore> renderFinishedSemaphores;
+        VkRenderPass renderPass;
+        std::unique_ptr<VulkanTransientAttachments> transientAttachments;
+        std::uint64_t frame;
+    };
+
     /** External objects */
     VulkanDevice& device;
     VkSurfaceKHR surface;
@@ -56,15 +92,15 @@ private:
     VkSwapchainKHR m_swapchain{ VK_NULL_HANDLE };
     std::vector<VkFramebuffer> m_swapchainFramebuffers{ VK_NULL_HANDLE };
     VkRenderPass m_renderPass{ VK_NULL_HANDLE };
+    bool m_dynamicRendering{ false };
 
     /** Images */
     VkFormat m_swapchainImageFormat{};
+    VkFormat m_depthFormat{ VK_FORMAT_UNDEFINED };
     VkExtent2D m_swapchainImageExtent{};
     std::vector<VkImage> m_swapchainImages;
     std::vector<VkImageView> m_swapchainImageViews;
-    std::vector<VkImage> m_depthImages;
-    std::vector<VkDeviceMemory> m_depthImagesMemory;
-    std::vector<VkImageView> m_depthImageViews;
+    std::unique_ptr<VulkanTransientAttachments> m_transientAttachments;
     std::size_t m_currentFrame{ 0 };
     std::uint32_t m_lastImageIndex{};
 
@@ -73,16 +109,21 @@ private:
     std::vector<VkSemaphore> m_renderFinishedSemaphores;
     std::vector<VkFence> m_inFlightFences;
     std::vector<VkFence> m_imagesInFlight;
+    std::uint64_t m_submittedFrames{ 0 };
+
+    std::deque<RetiredResources> m_retired;
 
-    void createVulkanSwapchain(std::shared_ptr<VulkanSwapchain> previous = nullptr);
+    void createVulkanSwapchain();
 
     /** Setup functions */
-    void createSwapchain(std::shared_ptr<VulkanSwapchain> previous = nullptr);
+    void createSwapchain(VkSwapchainKHR oldSwapchain);
     void createImageViews();
     void createRenderPass();
     void createDepthResources();
     void createFramebuffers();
+    void createRenderFinishedSemaphores();
     void createSyncObjects();
+    void releaseRetiredResources(bool all);
 
     /** Supporting methods */
     [[nodiscard]] VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) const;
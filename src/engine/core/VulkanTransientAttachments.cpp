@@ -0,0 +1,148 @@
+#include "VulkanTransientAttachments.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "utility/AliasPlanner.hpp"
+
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rr
+{
+
+VulkanTransientAttachments::VulkanTransientAttachments(VulkanDevice& device, const std::vector<TransientAttachmentInfo>& attachments, std::uint32_t frameCount, VkExtent2D extent)
+    : device(device)
+    , m_frames(frameCount)
+{
+    assert(!attachments.empty() && "At least one attachment is needed");
+
+    for(auto& frame : m_frames)
+        createFrame(frame, attachments, extent);
+
+    spdlog::info("created {} transient attachment(s) for {} frame(s) using {} bytes per frame{}",
+                 attachments.size(),
+                 frameCount,
+                 m_frameMemorySize,
+                 m_lazilyAllocated ? " of lazily allocated memory" : "");
+}
+
+VulkanTransientAttachments::~VulkanTransientAttachments()
+{
+    for(auto& frame : m_frames)
+    {
+        for(auto* const view : frame.views)
+            vkDestroyImageView(device.getHandle(), view, nullptr);
+
+        for(auto* const image : frame.images)
+            vkDestroyImage(device.getHandle(), image, nullptr);
+
+        if(frame.allocation.isValid())
+            device.freeMemory(frame.allocation);
+    }
+}
+
+/**
+ *  Create the images of one frame, place them inside a single allocation and create their views.
+*/
+void VulkanTransientAttachments::createFrame(Frame& frame, const std::vector<TransientAttachmentInfo>& attachments, VkExtent2D extent)
+{
+    frame.images.resize(attachments.size(), VK_NULL_HANDLE);
+    frame.views.resize(attachments.size(), VK_NULL_HANDLE);
+
+    std::vector<AliasedResource> resources(attachments.size());
+    std::uint32_t memoryTypeBits{ ~0U };
+
+    for(std::size_t i{ 0 }; i < attachments.size(); ++i)
+    {
+        const auto& attachment{ attachments[i] };
+
+        // NOTE: transient images may only be used as attachments, their content never has to reach memory
+        VkImageCreateInfo imageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .flags = 0,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = attachment.format,
+            .extent = {
+                .width = extent.width,
+                .height = extent.height,
+                .depth = 1
+            },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = attachment.usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        if(vkCreateImage(device.getHandle(), &imageCreateInfo, nullptr, &frame.images[i]) != VK_SUCCESS)
+            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_IMAGE);
+
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(device.getHandle(), frame.images[i], &memRequirements);
+
+        memoryTypeBits &= memRequirements.memoryTypeBits;
+        resources[i] = {
+            .size = memRequirements.size,
+            .alignment = memRequirements.alignment,
+            .firstUse = attachment.firstPass,
+            .lastUse = attachment.lastPass
+        };
+    }
+
+    if(memoryTypeBits == 0)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::NO_SUITABLE_MEMORY_TYPE_FOUND);
+
+    const AliasPlan plan{ AliasPlanner::plan(resources) };
+    const auto largest{ std::ranges::max_element(resources, {}, &AliasedResource::size) - resources.begin() };
+
+    VkMemoryRequirements frameRequirements{
+        .size = plan.size,
+        .alignment = plan.alignment,
+        .memoryTypeBits = memoryTypeBits
+    };
+    frame.allocation = device.allocateMemory(
+        frameRequirements,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+        AllocationKind::OPTIMAL,
+        attachments[static_cast<std::size_t>(largest)].category);
+
+    m_frameMemorySize = plan.size;
+    m_lazilyAllocated = device.hasMemoryProperties(frame.allocation, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+
+    for(std::size_t i{ 0 }; i < attachments.size(); ++i)
+    {
+        if(vkBindImageMemory(device.getHandle(), frame.images[i], frame.allocation.memory, frame.allocation.offset + plan.offsets[i]) != VK_SUCCESS)
+            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::BIND_IMAGE_MEMORY);
+
+        VkImageViewCreateInfo imageViewCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = frame.images[i],
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = attachments[i].format,
+            .subresourceRange = {
+                .aspectMask = attachments[i].aspect,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        };
+
+        if(vkCreateImageView(device.getHandle(), &imageViewCreateInfo, nullptr, &frame.views[i]) != VK_SUCCESS)
+            throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_IMAGE_VIEW, i);
+    }
+}
+
+} // !rr
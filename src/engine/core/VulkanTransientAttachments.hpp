@@ -0,0 +1,76 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_TRANSIENT_ATTACHMENTS_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_TRANSIENT_ATTACHMENTS_HPP
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Attachment that is only read and written inside of render passes. It is needed from pass
+ *  <code>firstPass<\code> to pass <code>lastPass<\code> of a frame.
+*/
+struct TransientAttachmentInfo
+{
+    VkFormat format{ VK_FORMAT_UNDEFINED };
+    VkImageUsageFlags usage{ 0 };
+    VkImageAspectFlags aspect{ 0 };
+    MemoryCategory category{ MemoryCategory::OTHER };
+    std::uint32_t firstPass{ 0 };
+    std::uint32_t lastPass{ 0 };
+};
+
+/**
+ *  <code>VulkanTransientAttachments<\code> owns attachments like depth buffers that never leave the GPU. Only one
+ *  set per frame in flight is needed, not one per swapchain image. Images are created with
+ *  <code>VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT<\code> and bound to lazily allocated memory if the device has it,
+ *  so tile based GPUs may never back them at all. All attachments of a frame share one allocation and attachments
+ *  whose passes do not overlap alias the same bytes.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanTransientAttachments
+{
+public:
+    VulkanTransientAttachments(VulkanDevice& device, const std::vector<TransientAttachmentInfo>& attachments, std::uint32_t frameCount, VkExtent2D extent);
+    ~VulkanTransientAttachments();
+
+    VulkanTransientAttachments(const VulkanTransientAttachments&) = delete;
+    VulkanTransientAttachments(VulkanTransientAttachments&&) = delete;
+    VulkanTransientAttachments& operator=(const VulkanTransientAttachments&) = delete;
+    VulkanTransientAttachments& operator=(VulkanTransientAttachments&&) = delete;
+
+    [[nodiscard]] VkImage getImage(std::size_t frame, std::size_t attachment) const { return m_frames.at(frame).images.at(attachment); }
+    [[nodiscard]] VkImageView getView(std::size_t frame, std::size_t attachment) const { return m_frames.at(frame).views.at(attachment); }
+    [[nodiscard]] bool isLazilyAllocated() const { return m_lazilyAllocated; }
+    /** Bytes bound for all attachments of one frame, after aliasing */
+    [[nodiscard]] VkDeviceSize getFrameMemorySize() const { return m_frameMemorySize; }
+
+private:
+    struct Frame
+    {
+        std::vector<VkImage> images;
+        std::vector<VkImageView> views;
+        VulkanAllocation allocation;
+    };
+
+    VulkanDevice& device;
+
+    std::vector<Frame> m_frames;
+    VkDeviceSize m_frameMemorySize{ 0 };
+    bool m_lazilyAllocated{ false };
+
+    void createFrame(Frame& frame, const std::vector<TransientAttachmentInfo>& attachments, VkExtent2D extent);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_TRANSIENT_ATTACHMENTS_HPP
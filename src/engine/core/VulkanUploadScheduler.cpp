@@ -0,0 +1,489 @@
+#include "VulkanUploadScheduler.hpp"
+
+#include "core/VulkanAllocator.hpp"
+#include "core/VulkanDevice.hpp"
+#include "utility/FreeListAllocator.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/VulkanException.hpp"
+#include "spdlog/spdlog.h"
+#include <source_location>
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace rr
+{
+
+VulkanUploadScheduler::VulkanUploadScheduler(VulkanDevice& device, VkDeviceSize capacity)
+    : device(device)
+    , m_capacity(capacity)
+    , m_queue(device.getTransferQueueHandle())
+{
+    createStagingBuffer();
+
+    const QueueFamilyIndices& indices{ device.findPhysicalQueueFamilies() };
+    if(!indices.transferFamily.has_value())
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::QUEUE_FAMILY_INDEX_IS_EMPTY);
+
+    VkCommandPoolCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = indices.transferFamily.value()
+    };
+
+    if(vkCreateCommandPool(device.getHandle(), &createInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_COMMAND_POOL);
+
+    VkSemaphoreTypeCreateInfo typeInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0
+    };
+    VkSemaphoreCreateInfo semaphoreInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &typeInfo
+    };
+
+    if(vkCreateSemaphore(device.getHandle(), &semaphoreInfo, nullptr, &m_timeline) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::CREATE_TIMELINE_SEMAPHORE);
+
+    m_budgetCallbackId = device.addBudgetCallback([this](std::uint32_t heapIndex, VkDeviceSize) { return releaseIdleStaging(heapIndex); });
+
+    spdlog::info("Upload scheduler uses queue family {} ({})", indices.transferFamily.value(), indices.hasDedicatedTransfer() ? "dedicated transfer" : "graphics");
+}
+
+VulkanUploadScheduler::~VulkanUploadScheduler()
+{
+    device.removeBudgetCallback(m_budgetCallbackId);
+    waitIdle();
+
+    vkDestroySemaphore(device.getHandle(), m_timeline, nullptr);
+    vkDestroyCommandPool(device.getHandle(), m_commandPool, nullptr);
+    if(m_buffer != VK_NULL_HANDLE)
+        device.destroyBuffer(m_buffer, m_allocation);
+}
+
+/**
+ *  Stage <code>size<\code> bytes from <code>data<\code> and record a copy into <code>dstBuffer<\code>.
+ *  Uploads bigger than the ring are split up.
+ *
+ *  @param dstBuffer - buffer the data is copied to, needs VK_BUFFER_USAGE_TRANSFER_DST_BIT
+ *  @param dstOffset - offset into <code>dstBuffer<\code>
+ *  @param data - source data on the host
+ *  @param size - amount of bytes to upload
+ *  @returns std::uint64_t - timeline value that is signaled once the data arrived in <code>dstBuffer<\code>
+*/
+std::uint64_t VulkanUploadScheduler::uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size)
+{
+    std::lock_guard lock{ m_mutex };
+
+    const auto* src{ static_cast<const std::byte*>(data) };
+    VkDeviceSize uploaded{ 0 };
+
+    while(uploaded < size)
+    {
+        const VkDeviceSize chunkSize{ std::min(size - uploaded, m_capacity) };
+
+        m_pendingBufferCopies.push_back({
+            .dstBuffer = dstBuffer,
+            .region = {
+                .srcOffset = stage(src + uploaded, chunkSize),
+                .dstOffset = dstOffset + uploaded,
+                .size = chunkSize
+            }
+        });
+
+        uploaded += chunkSize;
+    }
+
+    return m_submittedValue + 1;
+}
+
+/**
+ *  Stage tightly packed texel data for the first mip level and layer of <code>dstImage<\code>. The image is
+ *  transitioned to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL after the copy.
+ *
+ *  @param dstImage - color image the data is copied to, needs VK_IMAGE_USAGE_TRANSFER_DST_BIT
+ *  @param extent - size of the image in texels
+ *  @param data - source data on the host
+ *  @param size - amount of bytes to upload, has to fit into the ring
+ *  @returns std::uint64_t - timeline value that is signaled once the image can be sampled
+*/
+std::uint64_t VulkanUploadScheduler::uploadToImage(VkImage dstImage, VkExtent3D extent, const void* data, VkDeviceSize size)
+{
+    assert(size <= m_capacity && "Image uploads cannot be bigger than the staging ring");
+
+    std::lock_guard lock{ m_mutex };
+
+    m_pendingImageCopies.push_back({
+        .dstImage = dstImage,
+        .region = {
+            .bufferOffset = stage(data, size),
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = extent
+        }
+    });
+
+    return m_submittedValue + 1;
+}
+
+/**
+ *  Submit all pending jobs in a single command buffer.
+*/
+void VulkanUploadScheduler::flush()
+{
+    std::lock_guard lock{ m_mutex };
+
+    retireCompleted(false);
+    submitPending();
+}
+
+/**
+ *  Submit everything that is pending and block until the GPU has consumed the whole ring.
+*/
+void VulkanUploadScheduler::waitIdle()
+{
+    std::lock_guard lock{ m_mutex };
+
+    submitPending();
+
+    while(!m_inFlight.empty())
+        retireCompleted(true);
+}
+
+bool VulkanUploadScheduler::isComplete(std::uint64_t value) const
+{
+    return completedValue() >= value;
+}
+
+/**
+ *  Block the calling thread until the timeline reached <code>value<\code>. The value has to be submitted already.
+*/
+void VulkanUploadScheduler::wait(std::uint64_t value) const
+{
+    VkSemaphoreWaitInfo waitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &m_timeline,
+        .pValues = &value
+    };
+
+    vkWaitSemaphores(device.getHandle(), &waitInfo, std::numeric_limits<std::uint64_t>::max());
+}
+
+/**
+ *  The ring is created into locals and only published once it is complete, the budget callback never sees a half
+ *  built ring.
+*/
+void VulkanUploadScheduler::createStagingBuffer()
+{
+    VkBuffer buffer{ VK_NULL_HANDLE };
+    VulkanAllocation allocation;
+
+    m_creatingStaging = true;
+    try
+    {
+        device.createBuffer(
+            m_capacity,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            buffer,
+            allocation,
+            MemoryCategory::STAGING);
+    }
+    catch(...)
+    {
+        m_creatingStaging = false;
+        throw;
+    }
+    m_creatingStaging = false;
+
+    m_buffer = buffer;
+    m_allocation = allocation;
+}
+
+/**
+ *  Budget callback that destroys the ring if it lies in <code>heapIndex<\code> and no upload uses it.
+ *
+ *  @returns VkDeviceSize - amount of bytes the heap usage of the allocator went down by
+*/
+VkDeviceSize VulkanUploadScheduler::releaseIdleStaging(std::uint32_t heapIndex)
+{
+    // NOTE: checked before locking, the thread creating the ring already holds the lock
+    if(m_creatingStaging)
+        return 0;
+
+    std::lock_guard lock{ m_mutex };
+
+    retireCompleted(false);
+    if(m_buffer == VK_NULL_HANDLE || !isEmpty() || device.getHeapIndex(m_allocation.memoryTypeIndex) != heapIndex)
+        return 0;
+
+    const VkDeviceSize usage{ device.getAllocator().getHeapUsage(heapIndex) };
+    device.destroyBuffer(m_buffer, m_allocation);
+    m_buffer = VK_NULL_HANDLE;
+
+    // NOTE: a ring inside a shared block only leaves the block empty, which is released by a later callback
+    return usage - device.getAllocator().getHeapUsage(heapIndex);
+}
+
+VkDeviceSize VulkanUploadScheduler::stage(const void* data, VkDeviceSize size)
+{
+    if(m_buffer == VK_NULL_HANDLE)
+        createStagingBuffer();
+
+    assert(m_allocation.mappedData != nullptr && "Staging memory has to be host visible");
+
+    const VkDeviceSize offset{ reserve(size) };
+    std::memcpy(static_cast<std::byte*>(m_allocation.mappedData) + offset, data, size);
+
+    return offset;
+}
+
+/**
+ *  Reserve <code>size<\code> contiguous bytes. If the ring is full pending jobs are submitted and the oldest
+ *  submissions are waited on until enough space is available.
+*/
+VkDeviceSize VulkanUploadScheduler::reserve(VkDeviceSize size)
+{
+    assert(size <= m_capacity && "Upload chunks cannot be bigger than the staging ring");
+
+    VkDeviceSize offset{ 0 };
+    while(!tryReserve(size, offset))
+    {
+        if(m_inFlight.empty())
+            submitPending();
+
+        retireCompleted(true);
+    }
+
+    return offset;
+}
+
+bool VulkanUploadScheduler::tryReserve(VkDeviceSize size, VkDeviceSize& offset)
+{
+    if(isEmpty())
+    {
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    const VkDeviceSize alignedHead{ FreeListAllocator::alignUp(m_head, COPY_ALIGNMENT) };
+
+    // NOTE: occupied range is [tail, head), free space is behind head and in front of tail after wrapping
+    if(m_head > m_tail || isEmpty())
+    {
+        if(alignedHead + size <= m_capacity)
+        {
+            offset = alignedHead;
+            m_head = alignedHead + size;
+            return true;
+        }
+
+        if(size <= m_tail)
+        {
+            offset = 0;
+            m_head = size;
+            return true;
+        }
+
+        return false;
+    }
+
+    // NOTE: occupied range wraps around, free space is [head, tail)
+    if(alignedHead + size <= m_tail)
+    {
+        offset = alignedHead;
+        m_head = alignedHead + size;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ *  Record all pending copies and submit them, signaling the next timeline value. Consumers wait on that value
+ *  with a semaphore wait, which also makes the written memory visible to them, so no trailing barrier is needed.
+*/
+void VulkanUploadScheduler::submitPending()
+{
+    if(!hasPendingCopies())
+        return;
+
+    VkCommandBuffer commandBuffer{ acquireCommandBuffer() };
+
+    VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    if(vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::RECORD_UPLOAD_COMMAND_BUFFER);
+
+    // NOTE: copies are grouped per destination so every buffer gets a single vkCmdCopyBuffer
+    std::ranges::stable_sort(m_pendingBufferCopies, std::less{}, &PendingBufferCopy::dstBuffer);
+
+    std::vector<VkBufferCopy> regions;
+    for(std::size_t i{ 0 }; i < m_pendingBufferCopies.size();)
+    {
+        const VkBuffer dstBuffer{ m_pendingBufferCopies[i].dstBuffer };
+
+        regions.clear();
+        for(; i < m_pendingBufferCopies.size() && m_pendingBufferCopies[i].dstBuffer == dstBuffer; ++i)
+            regions.push_back(m_pendingBufferCopies[i].region);
+
+        vkCmdCopyBuffer(commandBuffer, m_buffer, dstBuffer, static_cast<std::uint32_t>(regions.size()), regions.data());
+    }
+
+    if(!m_pendingImageCopies.empty())
+    {
+        recordImageTransitions(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        for(const auto& copy : m_pendingImageCopies)
+            vkCmdCopyBufferToImage(commandBuffer, m_buffer, copy.dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+
+        recordImageTransitions(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    if(vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::RECORD_UPLOAD_COMMAND_BUFFER);
+
+    const std::uint64_t signalValue{ m_submittedValue + 1 };
+    VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signalValue
+    };
+    VkSubmitInfo submitInfo{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineInfo,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &commandBuffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &m_timeline
+    };
+
+    if(vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::QUEUE_SUBMIT_TRANSFER);
+
+    m_submittedValue = signalValue;
+    m_inFlight.push_back({ .value = signalValue, .commandBuffer = commandBuffer, .end = m_head });
+    m_pendingBufferCopies.clear();
+    m_pendingImageCopies.clear();
+}
+
+/**
+ *  Release the ring space of all submissions whose timeline value was reached.
+ *
+ *  @param waitForOldest - block until at least the oldest submission finished
+*/
+void VulkanUploadScheduler::retireCompleted(bool waitForOldest)
+{
+    if(m_inFlight.empty())
+        return;
+
+    if(waitForOldest)
+        wait(m_inFlight.front().value);
+
+    const std::uint64_t completed{ completedValue() };
+    while(!m_inFlight.empty() && m_inFlight.front().value <= completed)
+    {
+        m_tail = m_inFlight.front().end;
+        m_freeCommandBuffers.push_back(m_inFlight.front().commandBuffer);
+
+        m_inFlight.pop_front();
+    }
+}
+
+/**
+ *  Images are written from the transfer queue and read on the graphics queue, so the transition to the final
+ *  layout only has to finish before the timeline value is signaled.
+*/
+void VulkanUploadScheduler::recordImageTransitions(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout) const
+{
+    const bool toTransfer{ newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL };
+    const VkAccessFlags transferWrite{ VK_ACCESS_TRANSFER_WRITE_BIT };
+
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(m_pendingImageCopies.size());
+
+    for(const auto& copy : m_pendingImageCopies)
+    {
+        barriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = toTransfer ? 0 : transferWrite,
+            .dstAccessMask = toTransfer ? transferWrite : 0,
+            .oldLayout = oldLayout,
+            .newLayout = newLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = copy.dstImage,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        });
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        toTransfer ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
+        toTransfer ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        static_cast<std::uint32_t>(barriers.size()), barriers.data());
+}
+
+std::uint64_t VulkanUploadScheduler::completedValue() const
+{
+    std::uint64_t value{ 0 };
+    vkGetSemaphoreCounterValue(device.getHandle(), m_timeline, &value);
+
+    return value;
+}
+
+VkCommandBuffer VulkanUploadScheduler::acquireCommandBuffer()
+{
+    if(!m_freeCommandBuffers.empty())
+    {
+        VkCommandBuffer commandBuffer{ m_freeCommandBuffers.back() };
+        m_freeCommandBuffers.pop_back();
+
+        return commandBuffer;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = m_commandPool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+
+    VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+    if(vkAllocateCommandBuffers(device.getHandle(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+        throwWithLog<VulkanException>(std::source_location::current(), VulkanExceptionCause::ALLOCATE_COMMAND_BUFFERS);
+
+    return commandBuffer;
+}
+
+} // !rr
@@ -0,0 +1,122 @@
+#ifndef RRENDERER_ENGINE_CORE_VULKAN_UPLOAD_SCHEDULER_HPP
+#define RRENDERER_ENGINE_CORE_VULKAN_UPLOAD_SCHEDULER_HPP
+
+#include "core/VulkanAllocator.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace rr
+{
+
+class VulkanDevice;
+
+/**
+ *  <code>VulkanUploadScheduler<\code> copies buffer and image data into device local memory on the transfer queue.
+ *  Jobs can be added from any thread. Their data is staged in a persistently mapped ring buffer and all jobs are
+ *  submitted together by <code>flush()<\code>. Every submission signals the next value of a timeline semaphore and
+ *  each job hands back the value after which its data can be used. Ring space is reused once the value of the
+ *  submission that read from it is reached.
+ *
+ *  When the device has no dedicated transfer queue the graphics queue is used, in that case <code>flush()<\code>
+ *  has to be called from the thread that submits the rendering work.
+ *
+ *  The ring is only needed while uploads are staged or in flight. Under memory pressure an idle ring is given back
+ *  and created again by the next upload.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class VulkanUploadScheduler
+{
+public:
+    VulkanUploadScheduler(VulkanDevice& device, VkDeviceSize capacity = DEFAULT_CAPACITY);
+    ~VulkanUploadScheduler();
+
+    VulkanUploadScheduler(const VulkanUploadScheduler&) = delete;
+    VulkanUploadScheduler(VulkanUploadScheduler&&) = delete;
+    VulkanUploadScheduler& operator=(const VulkanUploadScheduler&) = delete;
+    VulkanUploadScheduler& operator=(VulkanUploadScheduler&&) = delete;
+
+    static constexpr VkDeviceSize DEFAULT_CAPACITY{ 16ULL * 1024 * 1024 };
+    static constexpr VkDeviceSize COPY_ALIGNMENT{ 16 };
+
+    [[nodiscard]] std::uint64_t uploadToBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+    [[nodiscard]] std::uint64_t uploadToImage(VkImage dstImage, VkExtent3D extent, const void* data, VkDeviceSize size);
+    void flush();
+    void waitIdle();
+
+    [[nodiscard]] bool isComplete(std::uint64_t value) const;
+    void wait(std::uint64_t value) const;
+
+    [[nodiscard]] VkSemaphore getTimelineSemaphore() const { return m_timeline; }
+    [[nodiscard]] VkDeviceSize capacity() const { return m_capacity; }
+
+private:
+    struct PendingBufferCopy
+    {
+        VkBuffer dstBuffer;
+        VkBufferCopy region;
+    };
+
+    struct PendingImageCopy
+    {
+        VkImage dstImage;
+        VkBufferImageCopy region;
+    };
+
+    struct Submission
+    {
+        std::uint64_t value;
+        VkCommandBuffer commandBuffer;
+        VkDeviceSize end;
+    };
+
+    VulkanDevice& device;
+
+    mutable std::mutex m_mutex;
+    std::size_t m_budgetCallbackId{ 0 };
+    /** Creating the ring may run the budget callback of this scheduler on the same thread, which has to skip it */
+    std::atomic<bool> m_creatingStaging{ false };
+
+    VkBuffer m_buffer{ VK_NULL_HANDLE };
+    VulkanAllocation m_allocation;
+    VkDeviceSize m_capacity;
+    VkDeviceSize m_head{ 0 };
+    VkDeviceSize m_tail{ 0 };
+
+    VkQueue m_queue{ VK_NULL_HANDLE };
+    VkCommandPool m_commandPool{ VK_NULL_HANDLE };
+    VkSemaphore m_timeline{ VK_NULL_HANDLE };
+    std::uint64_t m_submittedValue{ 0 };
+
+    std::vector<PendingBufferCopy> m_pendingBufferCopies;
+    std::vector<PendingImageCopy> m_pendingImageCopies;
+    std::deque<Submission> m_inFlight;
+    std::vector<VkCommandBuffer> m_freeCommandBuffers;
+
+    void createStagingBuffer();
+    [[nodiscard]] VkDeviceSize releaseIdleStaging(std::uint32_t heapIndex);
+    [[nodiscard]] VkDeviceSize stage(const void* data, VkDeviceSize size);
+    [[nodiscard]] VkDeviceSize reserve(VkDeviceSize size);
+    [[nodiscard]] bool tryReserve(VkDeviceSize size, VkDeviceSize& offset);
+    void submitPending();
+    void retireCompleted(bool waitForOldest);
+    void recordImageTransitions(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout) const;
+
+    [[nodiscard]] bool hasPendingCopies() const { return !m_pendingBufferCopies.empty() || !m_pendingImageCopies.empty(); }
+    [[nodiscard]] bool isEmpty() const { return m_inFlight.empty() && !hasPendingCopies(); }
+    [[nodiscard]] std::uint64_t completedValue() const;
+
+    [[nodiscard]] VkCommandBuffer acquireCommandBuffer();
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_CORE_VULKAN_UPLOAD_SCHEDULER_HPP
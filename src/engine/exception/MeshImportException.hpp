@@ -0,0 +1,61 @@
+#ifndef RRENDERER_ENGINE_EXCEPTIONS_MESH_IMPORT_EXCEPTION_HPP
+#define RRENDERER_ENGINE_EXCEPTIONS_MESH_IMPORT_EXCEPTION_HPP
+
+#include "exception/EngineException.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace rr
+{
+
+enum class MeshImportExceptionCause : std::uint8_t
+{
+    UNSUPPORTED_FORMAT,
+    MALFORMED_OBJ,
+    MALFORMED_GLTF,
+    UNSUPPORTED_GLTF_FEATURE,
+    INDEX_OUT_OF_RANGE,
+    INVALID_MESH_FILE,
+    MESH_FILE_VERSION_MISMATCH,
+    MESH_FILE_CORRUPTED
+};
+
+class MeshImportException : public EngineException
+{
+public:
+    MeshImportException(MeshImportExceptionCause cause, const std::string& path)
+        : EngineException("Mesh import of " + path + " failed: " + causeToString(cause))
+        , m_cause(cause)
+        , m_path(path)
+    {}
+
+    [[nodiscard]] MeshImportExceptionCause cause() const { return m_cause; }
+    [[nodiscard]] std::string getPath() const { return m_path; }
+
+private:
+    MeshImportExceptionCause m_cause;
+    std::string m_path;
+
+    static std::string causeToString(MeshImportExceptionCause cause)
+    {
+        switch(cause)
+        {
+            using enum MeshImportExceptionCause;
+
+            case UNSUPPORTED_FORMAT: return "unsupported file format";
+            case MALFORMED_OBJ: return "malformed OBJ data";
+            case MALFORMED_GLTF: return "malformed glTF data";
+            case UNSUPPORTED_GLTF_FEATURE: return "unsupported glTF feature";
+            case INDEX_OUT_OF_RANGE: return "index out of range";
+            case INVALID_MESH_FILE: return "not a valid mesh file";
+            case MESH_FILE_VERSION_MISMATCH: return "mesh file was written by a different version";
+            case MESH_FILE_CORRUPTED: return "content hash of mesh file does not match";
+            default: return "unknown error";
+        }
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_EXCEPTIONS_MESH_IMPORT_EXCEPTION_HPP
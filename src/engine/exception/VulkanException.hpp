@@ -32,6 +32,7 @@ enum class VulkanExceptionCause : std::uint8_t
     NO_SUITABLE_MEMORY_TYPE_FOUND,
     GLFW_EXTENSIONS_MISSING,
     CREATE_GRAPHICS_PIPELINE,
+    CREATE_COMPUTE_PIPELINE,
     CREATE_SHADER_MODULE,
     CREATE_PIPELINE_LAYOUT,
     QUEUE_SUBMIT_GRAPHICS,
@@ -42,7 +43,17 @@ enum class VulkanExceptionCause : std::uint8_t
     CREATE_SEMAPHORE,
     CREATE_IN_FLIGHT_SYNC_OBJECT,
     VALIDATION_LAYERS_UNAVAILABLE,
-    CREATE_BUFFER
+    CREATE_BUFFER,
+    MAP_MEMORY,
+    BIND_BUFFER_MEMORY,
+    CREATE_TIMELINE_SEMAPHORE,
+    RECORD_UPLOAD_COMMAND_BUFFER,
+    QUEUE_SUBMIT_TRANSFER,
+    CREATE_DESCRIPTOR_SET_LAYOUT,
+    CREATE_DESCRIPTOR_POOL,
+    ALLOCATE_DESCRIPTOR_SETS,
+    FRAME_ALLOCATOR_EXHAUSTED,
+    RESET_COMMAND_POOL
 };
 
 class VulkanException : public EngineException
@@ -88,6 +99,7 @@ private:
             case NO_SUITABLE_MEMORY_TYPE_FOUND: return "search for a suitable memory type";
             case GLFW_EXTENSIONS_MISSING: return "verifying availability of extensions required by GLFW";
             case CREATE_GRAPHICS_PIPELINE: return "creation of VkPipeline";
+            case CREATE_COMPUTE_PIPELINE: return "creation of a compute VkPipeline";
             case CREATE_SHADER_MODULE: return "creation of VkShaderModule";
             case CREATE_PIPELINE_LAYOUT: return "creation of VkPipelineLayout";
             case QUEUE_SUBMIT_GRAPHICS: return "submiting graphics queue";
@@ -99,6 +111,16 @@ private:
             case CREATE_IN_FLIGHT_SYNC_OBJECT: return "creation of in flight VkFence or VkSemaphore #";
             case VALIDATION_LAYERS_UNAVAILABLE: return "checking for validation layer availability";
             case CREATE_BUFFER: return "creation of a buffer";
+            case MAP_MEMORY: return "mapping device memory";
+            case BIND_BUFFER_MEMORY: return "binding buffer memory";
+            case CREATE_TIMELINE_SEMAPHORE: return "creation of a timeline VkSemaphore";
+            case RECORD_UPLOAD_COMMAND_BUFFER: return "recording of an upload VkCommandBuffer";
+            case QUEUE_SUBMIT_TRANSFER: return "submiting transfer queue";
+            case CREATE_DESCRIPTOR_SET_LAYOUT: return "creation of VkDescriptorSetLayout";
+            case CREATE_DESCRIPTOR_POOL: return "creation of VkDescriptorPool";
+            case ALLOCATE_DESCRIPTOR_SETS: return "allocating VkDescriptorSets";
+            case FRAME_ALLOCATOR_EXHAUSTED: return "allocating per frame memory, the frame capacity is exhausted";
+            case RESET_COMMAND_POOL: return "resetting a VkCommandPool";
             default: return "unknown events";
         }
     }
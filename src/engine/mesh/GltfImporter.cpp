@@ -0,0 +1,572 @@
+#include "GltfImporter.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/MeshImportException.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/Vertex.hpp"
+#include "utility/Json.hpp"
+#include "utility/MappedFile.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include "spdlog/spdlog.h"
+#include <source_location>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rr
+{
+
+namespace
+{
+
+constexpr std::uint32_t GLB_MAGIC{ 0x46546C67 }; // "glTF"
+constexpr std::uint32_t GLB_CHUNK_JSON{ 0x4E4F534A }; // "JSON"
+constexpr std::uint32_t GLB_CHUNK_BIN{ 0x004E4942 }; // "BIN\0"
+constexpr std::size_t GLB_HEADER_SIZE{ 12 };
+constexpr std::size_t GLB_CHUNK_HEADER_SIZE{ 8 };
+
+constexpr std::uint32_t COMPONENT_UNSIGNED_BYTE{ 5121 };
+constexpr std::uint32_t COMPONENT_UNSIGNED_SHORT{ 5123 };
+constexpr std::uint32_t COMPONENT_UNSIGNED_INT{ 5125 };
+constexpr std::uint32_t COMPONENT_FLOAT{ 5126 };
+
+constexpr std::uint32_t MODE_TRIANGLES{ 4 };
+
+/** Column major like glTF itself */
+using Matrix4 = std::array<float, 16>;
+
+constexpr Matrix4 IDENTITY{ 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f };
+
+Matrix4 multiply(const Matrix4& lhs, const Matrix4& rhs)
+{
+    Matrix4 result{};
+    for(std::size_t column{ 0 }; column < 4; ++column)
+    {
+        for(std::size_t row{ 0 }; row < 4; ++row)
+        {
+            float sum{ 0.f };
+            for(std::size_t k{ 0 }; k < 4; ++k)
+                sum += lhs[k * 4 + row] * rhs[column * 4 + k];
+            result[column * 4 + row] = sum;
+        }
+    }
+
+    return result;
+}
+
+/** Compose translation * rotation * scale with the rotation given as unit quaternion (x, y, z, w) */
+Matrix4 composeTransform(const std::array<float, 3>& t, const std::array<float, 4>& r, const std::array<float, 3>& s)
+{
+    const auto [x, y, z, w]{ r };
+
+    return {
+        (1.f - 2.f * (y * y + z * z)) * s[0], (2.f * (x * y + z * w)) * s[0], (2.f * (x * z - y * w)) * s[0], 0.f,
+        (2.f * (x * y - z * w)) * s[1], (1.f - 2.f * (x * x + z * z)) * s[1], (2.f * (y * z + x * w)) * s[1], 0.f,
+        (2.f * (x * z + y * w)) * s[2], (2.f * (y * z - x * w)) * s[2], (1.f - 2.f * (x * x + y * y)) * s[2], 0.f,
+        t[0], t[1], t[2], 1.f
+    };
+}
+
+std::uint32_t readU32(std::span<const std::byte> data, std::size_t offset)
+{
+    std::uint32_t value{ 0 };
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+
+    return value;
+}
+
+std::vector<std::byte> decodeBase64(std::string_view text)
+{
+    auto decode{ [](char c) -> int {
+        if(c >= 'A' && c <= 'Z') return c - 'A';
+        if(c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if(c >= '0' && c <= '9') return c - '0' + 52;
+        if(c == '+' || c == '-') return 62;
+        if(c == '/' || c == '_') return 63;
+        return -1;
+    } };
+
+    std::vector<std::byte> result;
+    result.reserve(text.size() / 4 * 3);
+
+    std::uint32_t accumulator{ 0 };
+    int bits{ 0 };
+    for(const char c : text)
+    {
+        const int value{ decode(c) };
+        if(value < 0)
+            continue;
+
+        accumulator = (accumulator << 6U) | static_cast<std::uint32_t>(value);
+        bits += 6;
+        if(bits >= 8)
+        {
+            bits -= 8;
+            result.push_back(static_cast<std::byte>((accumulator >> static_cast<std::uint32_t>(bits)) & 0xFFU));
+        }
+    }
+
+    return result;
+}
+
+/** View of the elements of one accessor, already checked to lie within their buffer */
+struct Accessor
+{
+    const std::byte* data{ nullptr };
+    std::size_t count{ 0 };
+    std::size_t stride{ 0 };
+    std::uint32_t componentType{ 0 };
+    std::size_t componentCount{ 0 };
+
+    [[nodiscard]] float readComponent(std::size_t element, std::size_t component) const
+    {
+        const std::byte* address{ data + element * stride };
+        switch(componentType)
+        {
+            case COMPONENT_FLOAT:
+            {
+                float value{ 0.f };
+                std::memcpy(&value, address + component * sizeof(float), sizeof(float));
+                return value;
+            }
+            // NOTE: integer colors are always normalized
+            case COMPONENT_UNSIGNED_BYTE: return static_cast<float>(std::to_integer<std::uint8_t>(address[component])) / 255.f;
+            case COMPONENT_UNSIGNED_SHORT:
+            {
+                std::uint16_t value{ 0 };
+                std::memcpy(&value, address + component * sizeof(value), sizeof(value));
+                return static_cast<float>(value) / 65535.f;
+            }
+            default: return 0.f;
+        }
+    }
+
+    [[nodiscard]] std::uint32_t readIndex(std::size_t element) const
+    {
+        const std::byte* address{ data + element * stride };
+        switch(componentType)
+        {
+            case COMPONENT_UNSIGNED_BYTE: return std::to_integer<std::uint32_t>(*address);
+            case COMPONENT_UNSIGNED_SHORT:
+            {
+                std::uint16_t value{ 0 };
+                std::memcpy(&value, address, sizeof(value));
+                return value;
+            }
+            default:
+            {
+                std::uint32_t value{ 0 };
+                std::memcpy(&value, address, sizeof(value));
+                return value;
+            }
+        }
+    }
+};
+
+/** One primitive of one mesh instance together with its place in the output */
+struct PrimitiveJob
+{
+    Accessor positions;
+    std::optional<Accessor> normals;
+    std::optional<Accessor> colors;
+    std::optional<Accessor> indices;
+    Matrix4 transform{ IDENTITY };
+
+    std::size_t vertexOffset{ 0 };
+    std::size_t indexOffset{ 0 };
+
+    [[nodiscard]] std::size_t indexCount() const { return indices ? indices->count : positions.count; }
+};
+
+class Document
+{
+public:
+    Document(std::span<const std::byte> data, const std::filesystem::path& baseDirectory, const std::string& name)
+        : name(name)
+    {
+        std::string_view jsonText;
+        std::span<const std::byte> binaryChunk;
+
+        if(data.size() >= GLB_HEADER_SIZE && readU32(data, 0) == GLB_MAGIC)
+            splitGlb(data, jsonText, binaryChunk);
+        else
+            jsonText = { reinterpret_cast<const char*>(data.data()), data.size() }; // NOLINT
+
+        auto root{ Json::parse(jsonText) };
+        if(!root || !root->isObject())
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+        m_root = std::move(*root);
+
+        if(const auto* required{ m_root.find("extensionsRequired") }; required != nullptr && required->size() > 0)
+            fail(MeshImportExceptionCause::UNSUPPORTED_GLTF_FEATURE);
+
+        loadBuffers(baseDirectory, binaryChunk);
+    }
+
+    /** Collect every triangle primitive reachable from the default scene */
+    [[nodiscard]] std::vector<PrimitiveJob> collectPrimitives()
+    {
+        std::vector<PrimitiveJob> jobs;
+
+        const auto* scenes{ m_root.find("scenes") };
+        if(scenes == nullptr || scenes->size() == 0)
+        {
+            // NOTE: files without scenes are valid, they are treated as a library of meshes without transforms
+            for(std::size_t mesh{ 0 }; mesh < member("meshes").size(); ++mesh)
+                addMesh(mesh, IDENTITY, jobs);
+
+            return jobs;
+        }
+
+        const auto* scene{ scenes->at(static_cast<std::size_t>(m_root.getNumber("scene", 0.0))) };
+        if(scene == nullptr)
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        if(const auto* nodes{ scene->find("nodes") }; nodes != nullptr)
+        {
+            for(const auto& node : nodes->asArray())
+                addNode(index(node), IDENTITY, 0, jobs);
+        }
+
+        return jobs;
+    }
+
+private:
+    const std::string& name;
+    JsonValue m_root;
+    std::vector<std::vector<std::byte>> m_decodedBuffers;
+    std::vector<std::unique_ptr<MappedFile>> m_mappedBuffers;
+    std::vector<std::span<const std::byte>> m_buffers;
+
+    [[noreturn]] void fail(MeshImportExceptionCause cause) const
+    {
+        throwWithLog<MeshImportException>(std::source_location::current(), cause, name);
+    }
+
+    [[nodiscard]] const JsonValue& member(std::string_view key) const
+    {
+        static const JsonValue empty;
+        const auto* value{ m_root.find(key) };
+
+        return value != nullptr ? *value : empty;
+    }
+
+    /** Element <code>i<\code> of the top level array <code>key<\code>, fails if it does not exist */
+    [[nodiscard]] const JsonValue& element(std::string_view key, std::size_t i) const
+    {
+        const auto* value{ member(key).at(i) };
+        if(value == nullptr || !value->isObject())
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        return *value;
+    }
+
+    [[nodiscard]] std::size_t index(const JsonValue& value) const
+    {
+        if(!value.isNumber() || value.asNumber() < 0.0)
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        return static_cast<std::size_t>(value.asNumber());
+    }
+
+    void splitGlb(std::span<const std::byte> data, std::string_view& jsonText, std::span<const std::byte>& binaryChunk) const
+    {
+        const std::size_t length{ std::min<std::size_t>(readU32(data, 8), data.size()) };
+
+        std::size_t offset{ GLB_HEADER_SIZE };
+        while(offset + GLB_CHUNK_HEADER_SIZE <= length)
+        {
+            const std::size_t chunkLength{ readU32(data, offset) };
+            const std::uint32_t chunkType{ readU32(data, offset + 4) };
+            offset += GLB_CHUNK_HEADER_SIZE;
+            if(chunkLength > length - offset)
+                fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+            const auto chunk{ data.subspan(offset, chunkLength) };
+            if(chunkType == GLB_CHUNK_JSON && jsonText.empty())
+                jsonText = { reinterpret_cast<const char*>(chunk.data()), chunk.size() }; // NOLINT
+            else if(chunkType == GLB_CHUNK_BIN && binaryChunk.empty())
+                binaryChunk = chunk;
+
+            // NOTE: chunks are padded to 4 bytes
+            offset += (chunkLength + 3) & ~std::size_t{ 3 };
+        }
+
+        if(jsonText.empty())
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+    }
+
+    void loadBuffers(const std::filesystem::path& baseDirectory, std::span<const std::byte> binaryChunk)
+    {
+        constexpr std::string_view DATA_URI{ "data:" };
+        constexpr std::string_view BASE64_MARKER{ ";base64," };
+
+        for(const auto& buffer : member("buffers").asArray())
+        {
+            const auto byteLength{ static_cast<std::size_t>(buffer.getNumber("byteLength", 0.0)) };
+            const auto* uriValue{ buffer.find("uri") };
+
+            std::span<const std::byte> contents;
+            if(uriValue == nullptr)
+            {
+                // NOTE: only the first buffer of a .glb may omit its URI, it refers to the binary chunk
+                contents = binaryChunk;
+            }
+            else if(const auto uri{ uriValue->asString() }; uri.starts_with(DATA_URI))
+            {
+                const auto marker{ uri.find(BASE64_MARKER) };
+                if(marker == std::string_view::npos)
+                    fail(MeshImportExceptionCause::UNSUPPORTED_GLTF_FEATURE);
+
+                contents = m_decodedBuffers.emplace_back(decodeBase64(uri.substr(marker + BASE64_MARKER.size())));
+            }
+            else
+            {
+                contents = m_mappedBuffers.emplace_back(std::make_unique<MappedFile>(baseDirectory / std::filesystem::path{ uri }))->getData();
+            }
+
+            if(contents.size() < byteLength)
+                fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+            m_buffers.push_back(contents.first(byteLength));
+        }
+    }
+
+    [[nodiscard]] Accessor resolveAccessor(std::size_t accessorIndex) const
+    {
+        const auto& accessor{ element("accessors", accessorIndex) };
+        if(accessor.find("sparse") != nullptr || accessor.find("bufferView") == nullptr)
+            fail(MeshImportExceptionCause::UNSUPPORTED_GLTF_FEATURE);
+
+        const auto type{ accessor.find("type") != nullptr ? accessor.find("type")->asString() : std::string_view{} };
+        std::size_t componentCount{ 0 };
+        if(type == "SCALAR")
+            componentCount = 1;
+        else if(type == "VEC2")
+            componentCount = 2;
+        else if(type == "VEC3")
+            componentCount = 3;
+        else if(type == "VEC4")
+            componentCount = 4;
+        else
+            fail(MeshImportExceptionCause::UNSUPPORTED_GLTF_FEATURE);
+
+        Accessor result{
+            .count = static_cast<std::size_t>(accessor.getNumber("count", 0.0)),
+            .componentType = static_cast<std::uint32_t>(accessor.getNumber("componentType", 0.0)),
+            .componentCount = componentCount
+        };
+
+        std::size_t componentSize{ 0 };
+        switch(result.componentType)
+        {
+            case COMPONENT_UNSIGNED_BYTE: componentSize = 1; break;
+            case COMPONENT_UNSIGNED_SHORT: componentSize = 2; break;
+            case COMPONENT_UNSIGNED_INT: [[fallthrough]];
+            case COMPONENT_FLOAT: componentSize = 4; break;
+            default: fail(MeshImportExceptionCause::UNSUPPORTED_GLTF_FEATURE);
+        }
+
+        const auto& view{ element("bufferViews", index(*accessor.find("bufferView"))) };
+        const auto bufferIndex{ index(view.find("buffer") != nullptr ? *view.find("buffer") : JsonValue{}) };
+        if(bufferIndex >= m_buffers.size())
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        const auto viewOffset{ static_cast<std::size_t>(view.getNumber("byteOffset", 0.0)) };
+        const auto viewLength{ static_cast<std::size_t>(view.getNumber("byteLength", 0.0)) };
+        const auto accessorOffset{ static_cast<std::size_t>(accessor.getNumber("byteOffset", 0.0)) };
+        const std::size_t elementSize{ componentSize * componentCount };
+        result.stride = static_cast<std::size_t>(view.getNumber("byteStride", static_cast<double>(elementSize)));
+
+        const auto buffer{ m_buffers[bufferIndex] };
+        const bool viewInBuffer{ viewOffset <= buffer.size() && viewLength <= buffer.size() - viewOffset };
+        const std::size_t required{ result.count == 0 ? 0 : accessorOffset + (result.count - 1) * result.stride + elementSize };
+        if(!viewInBuffer || result.stride < elementSize || required > viewLength)
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        result.data = buffer.data() + viewOffset + accessorOffset;
+
+        return result;
+    }
+
+    [[nodiscard]] Matrix4 localTransform(const JsonValue& node) const
+    {
+        if(const auto* matrix{ node.find("matrix") }; matrix != nullptr)
+        {
+            if(matrix->size() != 16)
+                fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+            Matrix4 result{};
+            for(std::size_t i{ 0 }; i < 16; ++i)
+                result[i] = static_cast<float>(matrix->at(i)->asNumber());
+
+            return result;
+        }
+
+        auto read{ [&node]<std::size_t N>(std::string_view key, std::array<float, N> value) {
+            if(const auto* array{ node.find(key) }; array != nullptr && array->size() == N)
+            {
+                for(std::size_t i{ 0 }; i < N; ++i)
+                    value[i] = static_cast<float>(array->at(i)->asNumber());
+            }
+            return value;
+        } };
+
+        return composeTransform(
+            read("translation", std::array{ 0.f, 0.f, 0.f }),
+            read("rotation", std::array{ 0.f, 0.f, 0.f, 1.f }),
+            read("scale", std::array{ 1.f, 1.f, 1.f }));
+    }
+
+    void addNode(std::size_t nodeIndex, const Matrix4& parent, std::size_t depth, std::vector<PrimitiveJob>& jobs) const
+    {
+        // NOTE: the node graph has to be a forest, a path longer than the node count means there is a cycle
+        if(depth > member("nodes").size())
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        const auto& node{ element("nodes", nodeIndex) };
+        const auto transform{ multiply(parent, localTransform(node)) };
+
+        if(const auto* mesh{ node.find("mesh") }; mesh != nullptr)
+            addMesh(index(*mesh), transform, jobs);
+
+        if(const auto* children{ node.find("children") }; children != nullptr)
+        {
+            for(const auto& child : children->asArray())
+                addNode(index(child), transform, depth + 1, jobs);
+        }
+    }
+
+    void addMesh(std::size_t meshIndex, const Matrix4& transform, std::vector<PrimitiveJob>& jobs) const
+    {
+        const auto& mesh{ element("meshes", meshIndex) };
+        const auto* primitives{ mesh.find("primitives") };
+        if(primitives == nullptr)
+            fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+        for(const auto& primitive : primitives->asArray())
+        {
+            if(static_cast<std::uint32_t>(primitive.getNumber("mode", MODE_TRIANGLES)) != MODE_TRIANGLES)
+            {
+                spdlog::warn("skipping non triangle primitive of mesh {} in {}", meshIndex, name);
+                continue;
+            }
+
+            const auto* attributes{ primitive.find("attributes") };
+            const auto* position{ attributes != nullptr ? attributes->find("POSITION") : nullptr };
+            if(position == nullptr)
+                fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+            PrimitiveJob job{ .positions = resolveAccessor(index(*position)), .transform = transform };
+            if(job.positions.componentType != COMPONENT_FLOAT || job.positions.componentCount != 3)
+                fail(MeshImportExceptionCause::MALFORMED_GLTF);
+
+            if(const auto* normal{ attributes->find("NORMAL") }; normal != nullptr)
+            {
+                job.normals = resolveAccessor(index(*normal));
+                if(job.normals->componentType != COMPONENT_FLOAT || job.normals->componentCount != 3 || job.normals->count != job.positions.count)
+                    fail(MeshImportExceptionCause::MALFORMED_GLTF);
+            }
+
+            if(const auto* color{ attributes->find("COLOR_0") }; color != nullptr)
+            {
+                job.colors = resolveAccessor(index(*color));
+                if(job.colors->componentType == COMPONENT_UNSIGNED_INT || job.colors->componentCount < 3 || job.colors->count != job.positions.count)
+                    fail(MeshImportExceptionCause::MALFORMED_GLTF);
+            }
+
+            if(const auto* indices{ primitive.find("indices") }; indices != nullptr)
+            {
+                job.indices = resolveAccessor(index(*indices));
+                if(job.indices->componentType == COMPONENT_FLOAT || job.indices->componentCount != 1)
+                    fail(MeshImportExceptionCause::MALFORMED_GLTF);
+            }
+
+            jobs.push_back(job);
+        }
+    }
+};
+
+void decodePrimitive(const PrimitiveJob& job, MeshData& mesh, const std::string& name)
+{
+    const auto& m{ job.transform };
+    for(std::size_t i{ 0 }; i < job.positions.count; ++i)
+    {
+        const float x{ job.positions.readComponent(i, 0) };
+        const float y{ job.positions.readComponent(i, 1) };
+        const float z{ job.positions.readComponent(i, 2) };
+
+        std::array<float, 3> color{ 1.f, 1.f, 1.f };
+        if(job.colors)
+        {
+            color = { job.colors->readComponent(i, 0), job.colors->readComponent(i, 1), job.colors->readComponent(i, 2) };
+        }
+        else if(job.normals)
+        {
+            for(std::size_t c{ 0 }; c < 3; ++c)
+                color[c] = job.normals->readComponent(i, c) * 0.5f + 0.5f;
+        }
+
+        mesh.vertices[job.vertexOffset + i] = {
+            .position = {
+                m[0] * x + m[4] * y + m[8] * z + m[12],
+                m[1] * x + m[5] * y + m[9] * z + m[13],
+                m[2] * x + m[6] * y + m[10] * z + m[14]
+            },
+            .color = { color[0], color[1], color[2] }
+        };
+    }
+
+    const auto baseVertex{ static_cast<std::uint32_t>(job.vertexOffset) };
+    for(std::size_t i{ 0 }; i < job.indexCount(); ++i)
+    {
+        const std::uint32_t index{ job.indices ? job.indices->readIndex(i) : static_cast<std::uint32_t>(i) };
+        if(index >= job.positions.count)
+            throwWithLog<MeshImportException>(std::source_location::current(), MeshImportExceptionCause::INDEX_OUT_OF_RANGE, name);
+
+        mesh.indices[job.indexOffset + i] = baseVertex + index;
+    }
+}
+
+} // !namespace
+
+MeshData GltfImporter::parse(std::span<const std::byte> data, const std::filesystem::path& baseDirectory, ThreadPool& threadPool, const std::string& name)
+{
+    Document document{ data, baseDirectory, name };
+    auto jobs{ document.collectPrimitives() };
+
+    std::size_t vertexCount{ 0 };
+    std::size_t indexCount{ 0 };
+    for(auto& job : jobs)
+    {
+        job.vertexOffset = vertexCount;
+        job.indexOffset = indexCount;
+        vertexCount += job.positions.count;
+        indexCount += job.indexCount();
+    }
+
+    MeshData mesh;
+    mesh.vertices.resize(vertexCount);
+    mesh.indices.resize(indexCount);
+
+    threadPool.parallelFor(jobs.size(), 1, [&jobs, &mesh, &name](std::size_t begin, std::size_t end) {
+        for(std::size_t i{ begin }; i < end; ++i)
+            decodePrimitive(jobs[i], mesh, name);
+    });
+
+    return mesh;
+}
+
+} // !rr
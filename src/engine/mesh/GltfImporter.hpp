@@ -0,0 +1,39 @@
+#ifndef RRENDERER_ENGINE_MESH_GLTF_IMPORTER_HPP
+#define RRENDERER_ENGINE_MESH_GLTF_IMPORTER_HPP
+
+#include "mesh/MeshData.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+
+namespace rr
+{
+
+/**
+ *  <code>GltfImporter<\code> loads glTF 2.0 files, both the JSON form with external or base64 embedded buffers and
+ *  the binary .glb container. All triangle primitives reachable from the default scene are flattened into a single
+ *  mesh with node transforms applied to the positions.
+ *
+ *  Primitives are independent of each other, after computing their place in the output with a prefix sum they are
+ *  decoded from the buffers into the final arrays in parallel. Positions and normals have to be float vectors,
+ *  colors may also be normalized integers, sparse accessors are not supported.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class GltfImporter
+{
+public:
+    /**
+     *  <code>baseDirectory<\code> is used to resolve relative buffer URIs, <code>name<\code> is only used for
+     *  error reporting.
+    */
+    [[nodiscard]] static MeshData parse(std::span<const std::byte> data, const std::filesystem::path& baseDirectory, ThreadPool& threadPool, const std::string& name);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_GLTF_IMPORTER_HPP
@@ -0,0 +1,57 @@
+#ifndef RRENDERER_ENGINE_MESH_INSTANCE_DATA_HPP
+#define RRENDERER_ENGINE_MESH_INSTANCE_DATA_HPP
+
+#include "mesh/Vertex.hpp"
+#include "mesh/VertexLayout.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/ext/vector_float4.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace rr
+{
+
+/**
+ *  Per instance attributes of instanced draws. They are read from their own vertex buffer that advances once per
+ *  instance, so any number of copies of a mesh are drawn with a single draw call.
+*/
+struct InstanceData
+{
+    /** Translation in xyz and uniform scale in w, the same transform <code>CullingSet<\code> applies to bounds */
+    glm::vec4 transform;
+    glm::vec4 color;
+    /** Free for the shaders of a pipeline to interpret, e.g. material or animation parameters */
+    glm::vec4 payload;
+
+    static constexpr VkVertexInputRate INPUT_RATE{ VK_VERTEX_INPUT_RATE_INSTANCE };
+
+    static constexpr auto getBindingDescriptions()
+    {
+        return std::array{ vertexBinding<InstanceData>(0, INPUT_RATE) };
+    }
+
+    static constexpr auto getAttributeDescriptions()
+    {
+        return std::array{
+            vertexAttribute<glm::vec4>(2, offsetof(InstanceData, transform)),
+            vertexAttribute<glm::vec4>(3, offsetof(InstanceData, color)),
+            vertexAttribute<glm::vec4>(4, offsetof(InstanceData, payload))
+        };
+    }
+};
+
+/** Vertices in binding 0 and instances in binding 1 */
+using InstancedVertex = VertexStreams<Vertex, InstanceData>;
+
+/** Binding the instance buffer of <code>InstancedVertex<\code> pipelines is bound to */
+inline constexpr std::uint32_t INSTANCE_BINDING{ 1 };
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_INSTANCE_DATA_HPP
@@ -0,0 +1,57 @@
+#ifndef RRENDERER_ENGINE_MESH_MESH_DATA_HPP
+#define RRENDERER_ENGINE_MESH_MESH_DATA_HPP
+
+#include "mesh/Vertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rr
+{
+
+/** Meshes with at most this many vertices can use 16 bit indices */
+inline constexpr std::uint32_t MAX_16_BIT_VERTEX_COUNT{ 1U << 16U };
+
+/** CPU side geometry in the layout <code>VulkanMesh<\code> uploads as is */
+struct MeshData
+{
+    std::vector<Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+/** Axis aligned box and bounding sphere around the box, both in model space */
+struct MeshBounds
+{
+    glm::vec3 min;
+    glm::vec3 max;
+    glm::vec3 center;
+    float radius;
+
+    [[nodiscard]] static MeshBounds compute(std::span<const Vertex> vertices)
+    {
+        if(vertices.empty())
+            return { .min = { 0.f, 0.f, 0.f }, .max = { 0.f, 0.f, 0.f }, .center = { 0.f, 0.f, 0.f }, .radius = 0.f };
+
+        MeshBounds bounds{ .min = vertices[0].position, .max = vertices[0].position, .center = {}, .radius = 0.f };
+        for(const auto& vertex : vertices)
+        {
+            bounds.min = { std::min(bounds.min.x, vertex.position.x), std::min(bounds.min.y, vertex.position.y), std::min(bounds.min.z, vertex.position.z) };
+            bounds.max = { std::max(bounds.max.x, vertex.position.x), std::max(bounds.max.y, vertex.position.y), std::max(bounds.max.z, vertex.position.z) };
+        }
+
+        bounds.center = { (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+        const float dx{ bounds.max.x - bounds.center.x };
+        const float dy{ bounds.max.y - bounds.center.y };
+        const float dz{ bounds.max.z - bounds.center.z };
+        bounds.radius = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        return bounds;
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESH_DATA_HPP
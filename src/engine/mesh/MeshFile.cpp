@@ -0,0 +1,234 @@
+#include "MeshFile.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/FileIOException.hpp"
+#include "exception/MeshImportException.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/MeshLod.hpp"
+#include "mesh/Vertex.hpp"
+#include "utility/MappedFile.hpp"
+
+#include <source_location>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rr
+{
+
+static_assert(std::endian::native == std::endian::little, "Mesh files are stored little endian and read in place");
+static_assert(std::is_trivially_copyable_v<MeshFileHeader> && sizeof(MeshFileHeader) == 112);
+static_assert(std::is_trivially_copyable_v<MeshBounds> && std::is_trivially_copyable_v<MeshLod> && std::is_trivially_copyable_v<Vertex>);
+
+namespace
+{
+
+std::uint64_t alignUp(std::uint64_t value)
+{
+    return (value + MeshFile::SECTION_ALIGNMENT - 1) & ~std::uint64_t{ MeshFile::SECTION_ALIGNMENT - 1 };
+}
+
+std::uint64_t readWord(const std::byte* data)
+{
+    std::uint64_t word{ 0 };
+    std::memcpy(&word, data, sizeof(word));
+
+    return word;
+}
+
+} // !namespace
+
+MeshFile::MeshFile(const std::filesystem::path& path, bool verifyContent)
+    : m_file(path)
+{
+    validate(path, verifyContent);
+}
+
+/**
+ *  Check everything the accessors rely on, so that a truncated or foreign file can never lead to reads outside of
+ *  the mapping. Index values are not range checked, files are only written from validated meshes and the content
+ *  hash catches later corruption.
+*/
+void MeshFile::validate(const std::filesystem::path& path, bool verifyContent)
+{
+    auto fail{ [&path](MeshImportExceptionCause cause) {
+        throwWithLog<MeshImportException>(std::source_location::current(), cause, path.string());
+    } };
+
+    const auto data{ m_file.getData() };
+    if(data.size() < sizeof(MeshFileHeader))
+        fail(MeshImportExceptionCause::INVALID_MESH_FILE);
+
+    std::memcpy(&m_header, data.data(), sizeof(MeshFileHeader));
+    if(m_header.magic != MAGIC)
+        fail(MeshImportExceptionCause::INVALID_MESH_FILE);
+    if(m_header.version != VERSION || m_header.vertexStride != sizeof(Vertex))
+        fail(MeshImportExceptionCause::MESH_FILE_VERSION_MISMATCH);
+
+    auto validSection{ [&data](const MeshFileSection& candidate, std::uint64_t expectedSize) {
+        return candidate.offset % SECTION_ALIGNMENT == 0
+            && candidate.size == expectedSize
+            && candidate.offset <= data.size()
+            && candidate.size <= data.size() - candidate.offset;
+    } };
+
+    const bool validIndexSize{ m_header.indexSize == sizeof(std::uint16_t) || m_header.indexSize == sizeof(std::uint32_t) || (m_header.indexSize == 0 && m_header.indexCount == 0) };
+    const bool validCounts{ m_header.vertexCount <= std::numeric_limits<std::uint32_t>::max() && m_header.indexCount <= std::numeric_limits<std::uint32_t>::max() };
+    if(!validIndexSize || !validCounts
+       || !validSection(m_header.vertices, m_header.vertexCount * m_header.vertexStride)
+       || !validSection(m_header.indices, m_header.indexCount * m_header.indexSize)
+       || !validSection(m_header.lods, std::uint64_t{ m_header.lodCount } * sizeof(MeshLod))
+       || !validSection(m_header.bounds, sizeof(MeshBounds)))
+        fail(MeshImportExceptionCause::INVALID_MESH_FILE);
+
+    std::memcpy(&m_bounds, data.data() + m_header.bounds.offset, sizeof(MeshBounds));
+
+    m_lods.resize(m_header.lodCount);
+    if(!m_lods.empty())
+        std::memcpy(m_lods.data(), data.data() + m_header.lods.offset, m_header.lods.size);
+    const bool validLods{ std::ranges::all_of(m_lods, [this](const MeshLod& lod) {
+        return lod.indexCount % 3 == 0 && std::uint64_t{ lod.firstIndex } + lod.indexCount <= m_header.indexCount && lod.error >= 0.f;
+    }) };
+    if(!validLods)
+        fail(MeshImportExceptionCause::INVALID_MESH_FILE);
+
+    if(verifyContent)
+    {
+        const auto contentHash{ hash(section(m_header.lods), hash(getIndexData(), hash(getVertexData()))) };
+        if(hash(section(m_header.bounds), contentHash) != m_header.contentHash)
+            fail(MeshImportExceptionCause::MESH_FILE_CORRUPTED);
+    }
+}
+
+void MeshFile::write(const std::filesystem::path& path, std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::span<const MeshLod> lods)
+{
+    std::vector<std::byte> indexBytes;
+    std::uint32_t indexSize{ 0 };
+    if(!indices.empty() && vertices.size() <= MAX_16_BIT_VERTEX_COUNT)
+    {
+        indexSize = sizeof(std::uint16_t);
+        indexBytes.resize(indices.size() * indexSize);
+        for(std::size_t i{ 0 }; i < indices.size(); ++i)
+        {
+            const auto index{ static_cast<std::uint16_t>(indices[i]) };
+            std::memcpy(indexBytes.data() + i * indexSize, &index, indexSize);
+        }
+    }
+    else if(!indices.empty())
+    {
+        indexSize = sizeof(std::uint32_t);
+        indexBytes.resize(indices.size_bytes());
+        std::memcpy(indexBytes.data(), indices.data(), indices.size_bytes());
+    }
+
+    const auto bounds{ MeshBounds::compute(vertices) };
+    const auto vertexBytes{ std::as_bytes(vertices) };
+    const auto lodBytes{ std::as_bytes(lods) };
+    const auto boundsBytes{ std::as_bytes(std::span{ &bounds, 1 }) };
+
+    MeshFileHeader header{
+        .magic = MAGIC,
+        .version = VERSION,
+        .vertexStride = sizeof(Vertex),
+        .indexSize = indexSize,
+        .lodCount = static_cast<std::uint32_t>(lods.size()),
+        .vertexCount = vertices.size(),
+        .indexCount = indices.size(),
+        .vertices = {},
+        .indices = {},
+        .lods = {},
+        .bounds = {},
+        .contentHash = 0
+    };
+    header.vertices = { .offset = alignUp(sizeof(MeshFileHeader)), .size = vertexBytes.size() };
+    header.indices = { .offset = alignUp(header.vertices.offset + header.vertices.size), .size = indexBytes.size() };
+    header.lods = { .offset = alignUp(header.indices.offset + header.indices.size), .size = lodBytes.size() };
+    header.bounds = { .offset = alignUp(header.lods.offset + header.lods.size), .size = boundsBytes.size() };
+    header.contentHash = hash(boundsBytes, hash(lodBytes, hash(indexBytes, hash(vertexBytes))));
+
+    // NOTE: written next to the destination and renamed, so readers never see a partially written file
+    auto temporaryPath{ path };
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+        if(!file.is_open())
+            throwWithLog<FileIOException>(std::source_location::current(), temporaryPath.string());
+
+        std::uint64_t written{ 0 };
+        auto writeSection{ [&file, &written](std::uint64_t offset, std::span<const std::byte> bytes) {
+            static constexpr std::array<char, SECTION_ALIGNMENT> PADDING{};
+            file.write(PADDING.data(), static_cast<std::streamsize>(offset - written));
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())); // NOLINT
+            written = offset + bytes.size();
+        } };
+
+        writeSection(0, std::as_bytes(std::span{ &header, 1 }));
+        writeSection(header.vertices.offset, vertexBytes);
+        writeSection(header.indices.offset, indexBytes);
+        writeSection(header.lods.offset, lodBytes);
+        writeSection(header.bounds.offset, boundsBytes);
+
+        if(!file.good())
+            throwWithLog<FileIOException>(std::source_location::current(), temporaryPath.string());
+    }
+
+    std::filesystem::rename(temporaryPath, path);
+}
+
+std::filesystem::path MeshFile::cachePathFor(const std::filesystem::path& sourcePath)
+{
+    auto cachePath{ sourcePath };
+    cachePath += EXTENSION;
+
+    return cachePath;
+}
+
+/**
+ *  64 bit hash processing four independent lanes of eight bytes, so it runs at memory speed rather than being bound by
+ *  the latency of a single multiply chain. Only used to detect corruption, not for security.
+*/
+std::uint64_t MeshFile::hash(std::span<const std::byte> data, std::uint64_t seed)
+{
+    constexpr std::uint64_t PRIME_1{ 0x9E3779B185EBCA87ULL };
+    constexpr std::uint64_t PRIME_2{ 0xC2B2AE3D27D4EB4FULL };
+    constexpr std::uint64_t PRIME_3{ 0x165667B19E3779F9ULL };
+
+    auto round{ [](std::uint64_t lane, std::uint64_t word) { return std::rotl(lane + word * PRIME_2, 31) * PRIME_1; } };
+
+    std::array<std::uint64_t, 4> lanes{ seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+    std::size_t offset{ 0 };
+    for(; offset + 32 <= data.size(); offset += 32)
+    {
+        for(std::size_t lane{ 0 }; lane < lanes.size(); ++lane)
+            lanes[lane] = round(lanes[lane], readWord(data.data() + offset + lane * 8));
+    }
+
+    std::uint64_t result{ std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18) };
+    result += data.size();
+
+    for(; offset + 8 <= data.size(); offset += 8)
+        result = std::rotl(result ^ round(0, readWord(data.data() + offset)), 27) * PRIME_1 + PRIME_3;
+
+    for(; offset < data.size(); ++offset)
+        result = std::rotl(result ^ (std::to_integer<std::uint64_t>(data[offset]) * PRIME_3), 11) * PRIME_1;
+
+    result ^= result >> 33U;
+    result *= PRIME_2;
+    result ^= result >> 29U;
+    result *= PRIME_3;
+    result ^= result >> 32U;
+
+    return result;
+}
+
+} // !rr
@@ -0,0 +1,111 @@
+#ifndef RRENDERER_ENGINE_MESH_MESH_FILE_HPP
+#define RRENDERER_ENGINE_MESH_MESH_FILE_HPP
+
+#include "mesh/MeshData.hpp"
+#include "mesh/MeshLod.hpp"
+#include "mesh/Vertex.hpp"
+#include "utility/MappedFile.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace rr
+{
+
+struct MeshFileSection
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+/** Stored at the start of every mesh file, all values are little endian */
+struct MeshFileHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t vertexStride;
+    /** Size of one index in bytes, 0 for meshes without indices */
+    std::uint32_t indexSize;
+    std::uint32_t lodCount;
+    std::uint64_t vertexCount;
+    std::uint64_t indexCount;
+    MeshFileSection vertices;
+    /** Indices of all levels of detail, level 0 first */
+    MeshFileSection indices;
+    MeshFileSection lods;
+    MeshFileSection bounds;
+    /** Hash over the vertex, index, level of detail and bounds sections in that order */
+    std::uint64_t contentHash;
+};
+
+/**
+ *  <code>MeshFile<\code> is the engine native mesh container. Vertices and indices are stored exactly in the layout
+ *  <code>VulkanMesh<\code> uploads, so opening a file is a memory mapping and a validation of the header, the
+ *  sections are then copied straight from the mapping into staging memory.
+ *
+ *  Sections start at multiples of <code>SECTION_ALIGNMENT<\code> so they can be read in place. Files are written by
+ *  <code>write()<\code> after importing and optimizing a mesh, a file with a different version or vertex layout is
+ *  rejected and has to be written again from its source.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class MeshFile
+{
+public:
+    static constexpr std::array<char, 8> MAGIC{ 'R', 'R', 'M', 'E', 'S', 'H', '\0', '\0' };
+    static constexpr std::uint32_t VERSION{ 2 };
+    static constexpr std::size_t SECTION_ALIGNMENT{ 64 };
+    static constexpr std::string_view EXTENSION{ ".rrmesh" };
+
+    /** <code>verifyContent<\code> hashes all sections, which touches every page of the file */
+    explicit MeshFile(const std::filesystem::path& path, bool verifyContent = true);
+    ~MeshFile() = default;
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile(MeshFile&&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+    MeshFile& operator=(MeshFile&&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> getVertexData() const { return section(m_header.vertices); }
+    [[nodiscard]] std::span<const std::byte> getIndexData() const { return section(m_header.indices); }
+    [[nodiscard]] std::uint32_t getVertexCount() const { return static_cast<std::uint32_t>(m_header.vertexCount); }
+    [[nodiscard]] std::uint32_t getIndexCount() const { return static_cast<std::uint32_t>(m_header.indexCount); }
+    [[nodiscard]] VkIndexType getIndexType() const { return m_header.indexSize == sizeof(std::uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32; }
+    /** Empty for files written without levels of detail */
+    [[nodiscard]] std::span<const MeshLod> getLods() const { return m_lods; }
+    [[nodiscard]] const MeshBounds& getBounds() const { return m_bounds; }
+    [[nodiscard]] std::size_t getFileSize() const { return m_file.size(); }
+
+    /** Indices are stored with 16 bits whenever the vertex count allows it, <code>lods<\code> index into <code>indices<\code> */
+    static void write(const std::filesystem::path& path, std::span<const Vertex> vertices, std::span<const std::uint32_t> indices, std::span<const MeshLod> lods = {});
+
+    /** Path of the file caching the imported and optimized contents of <code>sourcePath<\code> */
+    [[nodiscard]] static std::filesystem::path cachePathFor(const std::filesystem::path& sourcePath);
+
+    [[nodiscard]] static std::uint64_t hash(std::span<const std::byte> data, std::uint64_t seed = 0);
+
+private:
+    MappedFile m_file;
+    MeshFileHeader m_header{};
+    std::vector<MeshLod> m_lods;
+    MeshBounds m_bounds{};
+
+    [[nodiscard]] std::span<const std::byte> section(const MeshFileSection& section) const
+    {
+        return m_file.getData().subspan(section.offset, section.size);
+    }
+
+    void validate(const std::filesystem::path& path, bool verifyContent);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESH_FILE_HPP
@@ -0,0 +1,96 @@
+#include "MeshImporter.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/MeshImportException.hpp"
+#include "mesh/GltfImporter.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/ObjImporter.hpp"
+#include "utility/MappedFile.hpp"
+
+#include "spdlog/spdlog.h"
+#include <source_location>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace rr
+{
+
+namespace
+{
+
+std::string lowercaseExtension(const std::filesystem::path& path)
+{
+    auto extension{ path.extension().string() };
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    return extension;
+}
+
+} // !namespace
+
+MeshImporter::MeshImporter(std::size_t threadCount)
+    : m_threadPool(threadCount)
+{}
+
+bool MeshImporter::isSupported(const std::filesystem::path& path)
+{
+    const auto extension{ lowercaseExtension(path) };
+
+    return extension == ".obj" || extension == ".gltf" || extension == ".glb";
+}
+
+MeshData MeshImporter::import(const std::filesystem::path& path, ImportStatistics* statistics)
+{
+    const auto extension{ lowercaseExtension(path) };
+    if(!isSupported(path))
+        throwWithLog<MeshImportException>(std::source_location::current(), MeshImportExceptionCause::UNSUPPORTED_FORMAT, path.string());
+
+    const auto readStart{ std::chrono::steady_clock::now() };
+
+    // NOTE: the parsers work on views into the mapping, only the final vertex and index arrays are allocated
+    const MappedFile file{ path };
+    const auto contents{ file.getData() };
+
+    const auto parseStart{ std::chrono::steady_clock::now() };
+
+    MeshData mesh;
+    if(extension == ".obj")
+        mesh = ObjImporter::parse({ reinterpret_cast<const char*>(contents.data()), contents.size() }, m_threadPool, path.string()); // NOLINT
+    else
+        mesh = GltfImporter::parse(contents, path.parent_path(), m_threadPool, path.string());
+
+    const auto parseEnd{ std::chrono::steady_clock::now() };
+
+    ImportStatistics result{
+        .bytes = contents.size(),
+        .vertexCount = mesh.vertices.size(),
+        .indexCount = mesh.indices.size(),
+        .threadCount = m_threadPool.threadCount(),
+        .readTime = parseStart - readStart,
+        .parseTime = parseEnd - parseStart
+    };
+
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    spdlog::info("imported {}: {} vertices, {} indices, {:.2f} MiB read in {:.2f} ms, parsed in {:.2f} ms ({:.1f} MB/s on {} threads)",
+                 path.filename().string(),
+                 result.vertexCount,
+                 result.indexCount,
+                 static_cast<double>(result.bytes) / (1024.0 * 1024.0),
+                 Milliseconds{ result.readTime }.count(),
+                 Milliseconds{ result.parseTime }.count(),
+                 result.megabytesPerSecond(),
+                 result.threadCount);
+
+    if(statistics != nullptr)
+        *statistics = result;
+
+    return mesh;
+}
+
+} // !rr
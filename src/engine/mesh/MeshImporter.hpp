@@ -0,0 +1,61 @@
+#ifndef RRENDERER_ENGINE_MESH_MESH_IMPORTER_HPP
+#define RRENDERER_ENGINE_MESH_MESH_IMPORTER_HPP
+
+#include "mesh/MeshData.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+
+namespace rr
+{
+
+struct ImportStatistics
+{
+    std::size_t bytes{ 0 };
+    std::size_t vertexCount{ 0 };
+    std::size_t indexCount{ 0 };
+    std::size_t threadCount{ 0 };
+    std::chrono::nanoseconds readTime{ 0 };
+    std::chrono::nanoseconds parseTime{ 0 };
+
+    /** Parse throughput, reading the file from disk is not included */
+    [[nodiscard]] double megabytesPerSecond() const
+    {
+        const std::chrono::duration<double> seconds{ parseTime };
+
+        return seconds.count() > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds.count() : 0.0;
+    }
+};
+
+/**
+ *  <code>MeshImporter<\code> loads mesh files into <code>MeshData<\code> that can be handed to
+ *  <code>VulkanMesh<\code> directly. The format is chosen by the file extension, supported are .obj, .gltf and .glb.
+ *  Parsing is spread across the worker threads of the importer.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class MeshImporter
+{
+public:
+    explicit MeshImporter(std::size_t threadCount = ThreadPool::defaultThreadCount());
+    ~MeshImporter() = default;
+
+    MeshImporter(const MeshImporter&) = delete;
+    MeshImporter(MeshImporter&&) = delete;
+    MeshImporter& operator=(const MeshImporter&) = delete;
+    MeshImporter& operator=(MeshImporter&&) = delete;
+
+    [[nodiscard]] MeshData import(const std::filesystem::path& path, ImportStatistics* statistics = nullptr);
+
+    [[nodiscard]] static bool isSupported(const std::filesystem::path& path);
+
+private:
+    ThreadPool m_threadPool;
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESH_IMPORTER_HPP
@@ -0,0 +1,81 @@
+#ifndef RRENDERER_ENGINE_MESH_MESH_LOD_HPP
+#define RRENDERER_ENGINE_MESH_MESH_LOD_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace rr
+{
+
+/**
+ *  Range of the index buffer holding one level of detail of a mesh. All levels share the vertex buffer, level 0 is the
+ *  full mesh and every further level is coarser than the one before.
+*/
+struct MeshLod
+{
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+    /** Largest deviation from the full mesh in model space units */
+    float error;
+};
+
+/**
+ *  Picks the level of detail of a draw by projecting the error of every level onto the screen.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+struct LodSelector
+{
+    /** Pixels covered by one world space unit, at distance one for perspective projections */
+    float pixelsPerUnit;
+    bool isOrthographic;
+    /** The coarsest level whose projected error stays below this is selected */
+    float maxPixelError;
+
+    [[nodiscard]] static LodSelector perspective(float verticalFov, float viewportHeight, float maxPixelError = 1.f)
+    {
+        return { .pixelsPerUnit = viewportHeight / (2.f * std::tan(verticalFov * 0.5f)), .isOrthographic = false, .maxPixelError = maxPixelError };
+    }
+
+    /** <code>viewHeight<\code> is the world space height the viewport shows */
+    [[nodiscard]] static LodSelector orthographic(float viewHeight, float viewportHeight, float maxPixelError = 1.f)
+    {
+        return { .pixelsPerUnit = viewportHeight / viewHeight, .isOrthographic = true, .maxPixelError = maxPixelError };
+    }
+
+    /** Size in pixels of a world space <code>error<\code> at <code>distance<\code> from the camera */
+    [[nodiscard]] float projectedError(float error, float distance) const
+    {
+        if(error <= 0.f)
+            return 0.f;
+        if(isOrthographic)
+            return error * pixelsPerUnit;
+
+        // NOTE: the camera is inside the bounds, every error is visible
+        if(distance <= 0.f)
+            return std::numeric_limits<float>::infinity();
+
+        return error * pixelsPerUnit / distance;
+    }
+
+    /**
+     *  @param distance - distance from the camera to the closest point of the bounding sphere of the draw
+     *  @param scale - largest scale factor of the transform from model into world space
+    */
+    [[nodiscard]] std::size_t select(std::span<const MeshLod> lods, float distance, float scale = 1.f) const
+    {
+        std::size_t result{ 0 };
+        for(std::size_t i{ 1 }; i < lods.size() && projectedError(lods[i].error * scale, distance) <= maxPixelError; ++i)
+            result = i;
+
+        return result;
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESH_LOD_HPP
@@ -0,0 +1,428 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace rr
+{
+
+namespace
+{
+
+constexpr std::uint32_t INVALID_INDEX{ std::numeric_limits<std::uint32_t>::max() };
+
+/** Tuning of the Forsyth vertex score, values from the original article */
+constexpr std::size_t SCORE_CACHE_SIZE{ 32 };
+constexpr float CACHE_DECAY_POWER{ 1.5f };
+constexpr float LAST_TRIANGLE_SCORE{ 0.75f };
+constexpr float VALENCE_BOOST_SCALE{ 2.f };
+constexpr float VALENCE_BOOST_POWER{ 0.5f };
+
+float vertexScore(std::int32_t cachePosition, std::uint32_t remainingValence)
+{
+    if(remainingValence == 0)
+        return -1.f;
+
+    float score{ 0.f };
+    if(cachePosition >= 0)
+    {
+        // NOTE: the vertices of the last triangle get a fixed score so the next triangle does not just reuse them
+        if(cachePosition < 3)
+        {
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            constexpr float SCALER{ 1.f / static_cast<float>(SCORE_CACHE_SIZE - 3) };
+            score = std::pow(1.f - static_cast<float>(cachePosition - 3) * SCALER, CACHE_DECAY_POWER);
+        }
+    }
+
+    return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingValence), -VALENCE_BOOST_POWER);
+}
+
+std::array<float, 3> readPosition(std::span<const std::byte> vertices, std::size_t stride, std::size_t positionOffset, std::size_t positionComponents, std::uint32_t index)
+{
+    std::array<float, 3> position{ 0.f, 0.f, 0.f };
+    std::memcpy(position.data(), vertices.data() + index * stride + positionOffset, positionComponents * sizeof(float));
+
+    return position;
+}
+
+} // !namespace
+
+/**
+ *  Merge vertices that are byte wise identical and rewrite <code>indices<\code> to point at the merged ones. If
+ *  <code>indices<\code> is empty the vertices are a triangle list and an index buffer is generated for them.
+ *
+ *  @returns std::size_t - amount of vertices that are left
+*/
+std::size_t MeshOptimizer::deduplicateVertices(std::vector<std::byte>& vertices, std::size_t stride, std::vector<std::uint32_t>& indices)
+{
+    assert(stride > 0 && vertices.size() % stride == 0 && "Vertex data has to be a multiple of the stride");
+
+    const std::size_t vertexCount{ vertices.size() / stride };
+    if(indices.empty())
+    {
+        indices.resize(vertexCount);
+        std::iota(indices.begin(), indices.end(), 0U);
+    }
+
+    std::vector<std::byte> unique;
+    unique.reserve(vertices.size());
+
+    std::vector<std::uint32_t> remap(vertexCount, INVALID_INDEX);
+    std::unordered_map<std::string_view, std::uint32_t> lookup;
+    lookup.reserve(vertexCount);
+
+    // NOTE: keys point into the source data which stays untouched until the loop is done
+    const auto* const data{ reinterpret_cast<const char*>(vertices.data()) };
+    for(auto& index : indices)
+    {
+        assert(index < vertexCount && "Index out of range");
+
+        if(remap[index] == INVALID_INDEX)
+        {
+            const std::string_view key{ data + static_cast<std::size_t>(index) * stride, stride };
+            auto [it, inserted]{ lookup.try_emplace(key, static_cast<std::uint32_t>(unique.size() / stride)) };
+            if(inserted)
+                unique.insert(unique.end(), vertices.begin() + static_cast<std::ptrdiff_t>(index * stride), vertices.begin() + static_cast<std::ptrdiff_t>((index + 1) * stride));
+
+            remap[index] = it->second;
+        }
+
+        index = remap[index];
+    }
+
+    vertices = std::move(unique);
+    return vertices.size() / stride;
+}
+
+/**
+ *  Reorder triangles so that consecutive triangles share vertices that are still in the post-transform cache. This
+ *  is Tom Forsyth's linear speed algorithm, which does not depend on the exact cache size of the GPU.
+*/
+void MeshOptimizer::optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    assert(indices.size() % 3 == 0 && "Only triangle lists are supported");
+
+    const std::size_t triangleCount{ indices.size() / 3 };
+    if(triangleCount == 0)
+        return;
+
+    // NOTE: triangles adjacent to every vertex, stored as offsets into one array
+    std::vector<std::uint32_t> valence(vertexCount, 0);
+    for(const auto index : indices)
+        ++valence[index];
+
+    std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    std::inclusive_scan(valence.begin(), valence.end(), adjacencyOffsets.begin() + 1);
+
+    std::vector<std::uint32_t> adjacency(indices.size());
+    std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for(std::size_t i{ 0 }; i < indices.size(); ++i)
+        adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+
+    std::vector<std::int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for(std::size_t v{ 0 }; v < vertexCount; ++v)
+        vertexScores[v] = vertexScore(-1, valence[v]);
+
+    std::vector<float> triangleScores(triangleCount);
+    for(std::size_t t{ 0 }; t < triangleCount; ++t)
+        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<std::uint32_t> result;
+    result.reserve(indices.size());
+
+    std::vector<std::uint32_t> cache;
+    std::vector<std::uint32_t> nextCache;
+    cache.reserve(SCORE_CACHE_SIZE + 3);
+    nextCache.reserve(SCORE_CACHE_SIZE + 3);
+
+    auto bestTriangle{ static_cast<std::uint32_t>(std::ranges::max_element(triangleScores) - triangleScores.begin()) };
+    std::size_t scanCursor{ 0 };
+
+    while(bestTriangle != INVALID_INDEX)
+    {
+        emitted[bestTriangle] = true;
+
+        nextCache.clear();
+        for(std::size_t corner{ 0 }; corner < 3; ++corner)
+        {
+            const std::uint32_t vertex{ indices[bestTriangle * 3 + corner] };
+            result.push_back(vertex);
+            if(std::ranges::find(nextCache, vertex) == nextCache.end())
+                nextCache.push_back(vertex);
+
+            // NOTE: the emitted triangle is moved behind the still pending triangles of the vertex
+            const auto begin{ adjacency.begin() + adjacencyOffsets[vertex] };
+            const auto end{ begin + valence[vertex] };
+            std::iter_swap(std::find(begin, end, bestTriangle), end - 1);
+            --valence[vertex];
+        }
+
+        for(const auto vertex : cache)
+        {
+            if(std::ranges::find(nextCache, vertex) == nextCache.end())
+                nextCache.push_back(vertex);
+        }
+
+        // NOTE: vertices that fell out of the cache lose their cache bonus
+        for(std::size_t i{ SCORE_CACHE_SIZE }; i < nextCache.size(); ++i)
+        {
+            cachePosition[nextCache[i]] = -1;
+            vertexScores[nextCache[i]] = vertexScore(-1, valence[nextCache[i]]);
+        }
+        nextCache.resize(std::min(nextCache.size(), SCORE_CACHE_SIZE));
+
+        for(std::size_t i{ 0 }; i < nextCache.size(); ++i)
+        {
+            cachePosition[nextCache[i]] = static_cast<std::int32_t>(i);
+            vertexScores[nextCache[i]] = vertexScore(static_cast<std::int32_t>(i), valence[nextCache[i]]);
+        }
+
+        // NOTE: only triangles touching the cache changed their score, so the next one is searched among them
+        bestTriangle = INVALID_INDEX;
+        float bestScore{ -1.f };
+        for(const auto vertex : nextCache)
+        {
+            for(std::uint32_t a{ 0 }; a < valence[vertex]; ++a)
+            {
+                const auto triangle{ adjacency[adjacencyOffsets[vertex] + a] };
+                const float score{ vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]] + vertexScores[indices[triangle * 3 + 2]] };
+
+                if(score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = triangle;
+                }
+            }
+        }
+
+        if(bestTriangle == INVALID_INDEX)
+        {
+            while(scanCursor < triangleCount && emitted[scanCursor])
+                ++scanCursor;
+
+            if(scanCursor < triangleCount)
+                bestTriangle = static_cast<std::uint32_t>(scanCursor);
+        }
+
+        std::swap(cache, nextCache);
+    }
+
+    indices = std::move(result);
+}
+
+/**
+ *  Reorder clusters of triangles so that triangles facing outwards are drawn first and hide what is behind them. The
+ *  triangle order produced by <code>optimizeVertexCache()<\code> is split where the cache starts cold, so moving
+ *  whole clusters keeps most of the cache efficiency. If ACMR still gets worse than <code>threshold<\code> times the
+ *  original, the order is left alone.
+*/
+void MeshOptimizer::optimizeOverdraw(
+    std::vector<std::uint32_t>& indices,
+    std::span<const std::byte> vertices,
+    std::size_t stride,
+    std::size_t positionOffset,
+    std::size_t positionComponents,
+    float threshold)
+{
+    assert(indices.size() % 3 == 0 && "Only triangle lists are supported");
+    assert(positionComponents >= 2 && positionComponents <= 3 && "Positions need two or three components");
+
+    const std::size_t triangleCount{ indices.size() / 3 };
+    const std::size_t vertexCount{ vertices.size() / stride };
+    if(triangleCount < 2)
+        return;
+
+    // NOTE: a cluster starts wherever a triangle misses the cache with all three vertices
+    std::vector<std::size_t> clusterStarts{ 0 };
+    std::vector<std::uint32_t> fifo(DEFAULT_CACHE_SIZE, INVALID_INDEX);
+    std::size_t fifoHead{ 0 };
+    for(std::size_t t{ 0 }; t < triangleCount; ++t)
+    {
+        std::size_t misses{ 0 };
+        for(std::size_t corner{ 0 }; corner < 3; ++corner)
+        {
+            const auto vertex{ indices[t * 3 + corner] };
+            if(std::ranges::find(fifo, vertex) != fifo.end())
+                continue;
+
+            fifo[fifoHead] = vertex;
+            fifoHead = (fifoHead + 1) % fifo.size();
+            ++misses;
+        }
+
+        if(misses == 3 && t != 0)
+            clusterStarts.push_back(t);
+    }
+    clusterStarts.push_back(triangleCount);
+
+    const std::size_t clusterCount{ clusterStarts.size() - 1 };
+    if(clusterCount < 2)
+        return;
+
+    std::array<float, 3> meshCentroid{ 0.f, 0.f, 0.f };
+    for(std::uint32_t v{ 0 }; v < vertexCount; ++v)
+    {
+        const auto position{ readPosition(vertices, stride, positionOffset, positionComponents, v) };
+        for(std::size_t c{ 0 }; c < 3; ++c)
+            meshCentroid[c] += position[c] / static_cast<float>(vertexCount);
+    }
+
+    // NOTE: the further a cluster is out along its own normal, the more likely it occludes other clusters
+    std::vector<float> sortKeys(clusterCount);
+    for(std::size_t cluster{ 0 }; cluster < clusterCount; ++cluster)
+    {
+        std::array<float, 3> centroid{ 0.f, 0.f, 0.f };
+        std::array<float, 3> normal{ 0.f, 0.f, 0.f };
+        float area{ 0.f };
+
+        for(std::size_t t{ clusterStarts[cluster] }; t < clusterStarts[cluster + 1]; ++t)
+        {
+            const auto p0{ readPosition(vertices, stride, positionOffset, positionComponents, indices[t * 3]) };
+            const auto p1{ readPosition(vertices, stride, positionOffset, positionComponents, indices[t * 3 + 1]) };
+            const auto p2{ readPosition(vertices, stride, positionOffset, positionComponents, indices[t * 3 + 2]) };
+
+            const std::array<float, 3> e1{ p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            const std::array<float, 3> e2{ p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            const std::array<float, 3> cross{ e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            const float triangleArea{ std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]) * 0.5f };
+
+            for(std::size_t c{ 0 }; c < 3; ++c)
+            {
+                centroid[c] += (p0[c] + p1[c] + p2[c]) / 3.f * triangleArea;
+                normal[c] += cross[c];
+            }
+            area += triangleArea;
+        }
+
+        const float normalLength{ std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) };
+        if(area <= 0.f || normalLength <= 0.f)
+            continue;
+
+        float key{ 0.f };
+        for(std::size_t c{ 0 }; c < 3; ++c)
+            key += (centroid[c] / area - meshCentroid[c]) * normal[c] / normalLength;
+        sortKeys[cluster] = key;
+    }
+
+    std::vector<std::size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&sortKeys](std::size_t lhs, std::size_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+    std::vector<std::uint32_t> reordered;
+    reordered.reserve(indices.size());
+    for(const auto cluster : order)
+    {
+        reordered.insert(
+            reordered.end(),
+            indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[cluster] * 3),
+            indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[cluster + 1] * 3));
+    }
+
+    const float acmrBefore{ analyzeVertexCache(indices, vertexCount).acmr };
+    const float acmrAfter{ analyzeVertexCache(reordered, vertexCount).acmr };
+    if(acmrAfter <= acmrBefore * threshold)
+        indices = std::move(reordered);
+}
+
+/**
+ *  Reorder vertices in the order they are first referenced so that the vertex fetch reads memory linearly. Vertices
+ *  that are not referenced at all are removed.
+ *
+ *  @returns std::size_t - amount of vertices that are left
+*/
+std::size_t MeshOptimizer::optimizeVertexFetch(std::vector<std::byte>& vertices, std::size_t stride, std::vector<std::uint32_t>& indices)
+{
+    const std::size_t vertexCount{ vertices.size() / stride };
+
+    std::vector<std::uint32_t> remap(vertexCount, INVALID_INDEX);
+    std::vector<std::byte> reordered;
+    reordered.reserve(vertices.size());
+
+    std::uint32_t nextVertex{ 0 };
+    for(auto& index : indices)
+    {
+        if(remap[index] == INVALID_INDEX)
+        {
+            remap[index] = nextVertex++;
+            reordered.insert(reordered.end(), vertices.begin() + static_cast<std::ptrdiff_t>(index * stride), vertices.begin() + static_cast<std::ptrdiff_t>((index + 1) * stride));
+        }
+
+        index = remap[index];
+    }
+
+    vertices = std::move(reordered);
+    return nextVertex;
+}
+
+/**
+ *  Simulate a FIFO post-transform cache of <code>cacheSize<\code> entries.
+*/
+VertexCacheStatistics MeshOptimizer::analyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::uint32_t cacheSize)
+{
+    VertexCacheStatistics statistics;
+    if(indices.empty() || vertexCount == 0)
+        return statistics;
+
+    // NOTE: a vertex is in the cache if it was inserted less than cacheSize insertions ago
+    std::vector<std::size_t> insertedAt(vertexCount, std::numeric_limits<std::size_t>::max());
+    std::size_t insertions{ 0 };
+
+    for(const auto index : indices)
+    {
+        if(insertedAt[index] != std::numeric_limits<std::size_t>::max() && insertions - insertedAt[index] <= cacheSize)
+            continue;
+
+        insertedAt[index] = ++insertions;
+    }
+
+    statistics.transformedVertexCount = insertions;
+    statistics.acmr = static_cast<float>(insertions) / static_cast<float>(indices.size() / 3);
+    statistics.atvr = static_cast<float>(insertions) / static_cast<float>(vertexCount);
+
+    return statistics;
+}
+
+MeshOptimizationStatistics MeshOptimizer::optimize(
+    std::vector<std::byte>& vertices,
+    std::size_t stride,
+    std::vector<std::uint32_t>& indices,
+    std::size_t positionOffset,
+    std::size_t positionComponents)
+{
+    MeshOptimizationStatistics statistics;
+    statistics.vertexCountBefore = vertices.size() / stride;
+
+    if(indices.empty())
+    {
+        indices.resize(statistics.vertexCountBefore);
+        std::iota(indices.begin(), indices.end(), 0U);
+    }
+    statistics.before = analyzeVertexCache(indices, statistics.vertexCountBefore);
+
+    const std::size_t vertexCount{ deduplicateVertices(vertices, stride, indices) };
+    optimizeVertexCache(indices, vertexCount);
+    optimizeOverdraw(indices, vertices, stride, positionOffset, positionComponents);
+    statistics.vertexCountAfter = optimizeVertexFetch(vertices, stride, indices);
+    statistics.after = analyzeVertexCache(indices, statistics.vertexCountAfter);
+
+    return statistics;
+}
+
+} // !rr
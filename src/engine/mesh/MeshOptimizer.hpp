@@ -0,0 +1,98 @@
+#ifndef RRENDERER_ENGINE_MESH_MESH_OPTIMIZER_HPP
+#define RRENDERER_ENGINE_MESH_MESH_OPTIMIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Result of simulating a FIFO post-transform cache over an index buffer. ACMR is the amount of vertex shader
+ *  invocations per triangle (0.5 at best, 3 at worst), ATVR per unique vertex (1 at best).
+*/
+struct VertexCacheStatistics
+{
+    std::size_t transformedVertexCount{ 0 };
+    float acmr{ 0.f };
+    float atvr{ 0.f };
+};
+
+struct MeshOptimizationStatistics
+{
+    std::size_t vertexCountBefore{ 0 };
+    std::size_t vertexCountAfter{ 0 };
+    VertexCacheStatistics before;
+    VertexCacheStatistics after;
+};
+
+/**
+ *  <code>MeshOptimizer<\code> prepares indexed triangle lists for rendering. Vertices are handled as raw bytes with a
+ *  stride so that any vertex layout can be optimized, vertices are considered equal if all of their bytes are.
+ *
+ *  The full pipeline in <code>optimize()<\code> runs, in order:
+ *  - deduplication of identical vertices
+ *  - triangle reordering for post-transform cache locality (Forsyth)
+ *  - cluster reordering to reduce overdraw, as long as cache efficiency does not suffer too much (Sander et al.)
+ *  - vertex reordering for fetch locality
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class MeshOptimizer
+{
+public:
+    /** Size of the FIFO cache used when analyzing, a conservative value for current GPUs */
+    static constexpr std::uint32_t DEFAULT_CACHE_SIZE{ 16 };
+    /** Overdraw optimization may make ACMR worse by at most this factor */
+    static constexpr float DEFAULT_OVERDRAW_THRESHOLD{ 1.05f };
+
+    [[nodiscard]] static std::size_t deduplicateVertices(std::vector<std::byte>& vertices, std::size_t stride, std::vector<std::uint32_t>& indices);
+    static void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+    static void optimizeOverdraw(
+        std::vector<std::uint32_t>& indices,
+        std::span<const std::byte> vertices,
+        std::size_t stride,
+        std::size_t positionOffset,
+        std::size_t positionComponents,
+        float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+    [[nodiscard]] static std::size_t optimizeVertexFetch(std::vector<std::byte>& vertices, std::size_t stride, std::vector<std::uint32_t>& indices);
+
+    [[nodiscard]] static VertexCacheStatistics analyzeVertexCache(std::span<const std::uint32_t> indices, std::size_t vertexCount, std::uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     *  Run every optimization on a mesh with vertices of type <code>V<\code>. Positions are read as
+     *  <code>positionComponents<\code> floats at <code>positionOffset<\code>. If <code>indices<\code> is empty the
+     *  vertices are treated as a plain triangle list.
+    */
+    template<typename V>
+    static MeshOptimizationStatistics optimize(std::vector<V>& vertices, std::vector<std::uint32_t>& indices, std::size_t positionOffset, std::size_t positionComponents)
+    {
+        static_assert(std::is_trivially_copyable_v<V>, "Vertices are optimized as raw bytes");
+
+        std::vector<std::byte> bytes(vertices.size() * sizeof(V));
+        std::memcpy(bytes.data(), vertices.data(), bytes.size());
+
+        const auto statistics{ optimize(bytes, sizeof(V), indices, positionOffset, positionComponents) };
+
+        vertices.resize(bytes.size() / sizeof(V));
+        std::memcpy(vertices.data(), bytes.data(), bytes.size());
+
+        return statistics;
+    }
+
+    static MeshOptimizationStatistics optimize(
+        std::vector<std::byte>& vertices,
+        std::size_t stride,
+        std::vector<std::uint32_t>& indices,
+        std::size_t positionOffset,
+        std::size_t positionComponents);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESH_OPTIMIZER_HPP
@@ -0,0 +1,610 @@
+#include "MeshSimplifier.hpp"
+
+#include "mesh/MeshLod.hpp"
+#include "mesh/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace rr
+{
+
+namespace
+{
+
+constexpr std::size_t DIMENSION{ 3 + MeshSimplifier::MAX_ATTRIBUTE_COUNT };
+/** Border quadrics are weighted higher than surface ones so borders keep their shape */
+constexpr double BORDER_WEIGHT{ 10.0 };
+
+using Point = std::array<double, DIMENSION>;
+
+double dot(const Point& lhs, const Point& rhs)
+{
+    double result{ 0.0 };
+    for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        result += lhs[i] * rhs[i];
+
+    return result;
+}
+
+std::array<double, 3> cross(const std::array<double, 3>& lhs, const std::array<double, 3>& rhs)
+{
+    return { lhs[1] * rhs[2] - lhs[2] * rhs[1], lhs[2] * rhs[0] - lhs[0] * rhs[2], lhs[0] * rhs[1] - lhs[1] * rhs[0] };
+}
+
+std::array<double, 3> positionOf(const Point& point)
+{
+    return { point[0], point[1], point[2] };
+}
+
+std::array<double, 3> subtract(const std::array<double, 3>& lhs, const std::array<double, 3>& rhs)
+{
+    return { lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2] };
+}
+
+/**
+ *  Squared distance to a plane through a triangle in position and attribute space, stored as the symmetric matrix
+ *  <code>A<\code> (upper triangle), vector <code>b<\code> and constant <code>c<\code> of x'Ax + 2b'x + c. Quadrics are
+ *  weighted by area, dividing by the accumulated weight turns the sum back into a mean squared distance.
+*/
+struct Quadric
+{
+    std::array<double, DIMENSION * (DIMENSION + 1) / 2> a{};
+    Point b{};
+    double c{ 0.0 };
+    double weight{ 0.0 };
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        for(std::size_t i{ 0 }; i < a.size(); ++i)
+            a[i] += other.a[i];
+        for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+            b[i] += other.b[i];
+        c += other.c;
+        weight += other.weight;
+
+        return *this;
+    }
+
+    [[nodiscard]] double evaluate(const Point& point) const
+    {
+        double result{ c };
+        std::size_t k{ 0 };
+        for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        {
+            result += a[k++] * point[i] * point[i];
+            for(std::size_t j{ i + 1 }; j < DIMENSION; ++j)
+                result += 2.0 * a[k++] * point[i] * point[j];
+
+            result += 2.0 * b[i] * point[i];
+        }
+
+        return result;
+    }
+
+    /** Quadric of the plane spanned by two orthonormal directions <code>e1<\code> and <code>e2<\code> through <code>p<\code> */
+    [[nodiscard]] static Quadric fromPlane(const Point& p, const Point& e1, const Point& e2, double weight)
+    {
+        Quadric result;
+        std::size_t k{ 0 };
+        for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        {
+            for(std::size_t j{ i }; j < DIMENSION; ++j)
+                result.a[k++] = weight * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+        }
+
+        const double pe1{ dot(p, e1) };
+        const double pe2{ dot(p, e2) };
+        for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+            result.b[i] = weight * (pe1 * e1[i] + pe2 * e2[i] - p[i]);
+
+        result.c = weight * (dot(p, p) - pe1 * pe1 - pe2 * pe2);
+        result.weight = weight;
+
+        return result;
+    }
+
+    /** Quadric of the position only plane with unit <code>normal<\code> through <code>p<\code> */
+    [[nodiscard]] static Quadric fromNormal(const Point& p, const std::array<double, 3>& normal, double weight)
+    {
+        Quadric result;
+        std::size_t k{ 0 };
+        for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        {
+            for(std::size_t j{ i }; j < DIMENSION; ++j)
+                result.a[k++] = i < 3 && j < 3 ? weight * normal[i] * normal[j] : 0.0;
+        }
+
+        const double distance{ -(normal[0] * p[0] + normal[1] * p[1] + normal[2] * p[2]) };
+        for(std::size_t i{ 0 }; i < 3; ++i)
+            result.b[i] = weight * distance * normal[i];
+
+        result.c = weight * distance * distance;
+        result.weight = weight;
+
+        return result;
+    }
+};
+
+/** Gram-Schmidt, returns false for degenerate triangles */
+bool planeDirections(const Point& p0, const Point& p1, const Point& p2, Point& e1, Point& e2)
+{
+    for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        e1[i] = p1[i] - p0[i];
+
+    const double length1{ std::sqrt(dot(e1, e1)) };
+    if(length1 <= 1e-12)
+        return false;
+    for(auto& value : e1)
+        value /= length1;
+
+    Point edge2{};
+    for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        edge2[i] = p2[i] - p0[i];
+
+    const double projection{ dot(e1, edge2) };
+    for(std::size_t i{ 0 }; i < DIMENSION; ++i)
+        e2[i] = edge2[i] - projection * e1[i];
+
+    const double length2{ std::sqrt(dot(e2, e2)) };
+    if(length2 <= 1e-12)
+        return false;
+    for(auto& value : e2)
+        value /= length2;
+
+    return true;
+}
+
+enum class VertexKind : std::uint8_t
+{
+    MANIFOLD,
+    BORDER,
+    LOCKED
+};
+
+std::vector<std::array<float, 3>> readPositions(std::span<const std::byte> vertices, std::size_t stride, std::size_t positionOffset)
+{
+    std::vector<std::array<float, 3>> positions(vertices.size() / stride);
+    for(std::size_t i{ 0 }; i < positions.size(); ++i)
+        std::memcpy(positions[i].data(), vertices.data() + i * stride + positionOffset, sizeof(positions[i]));
+
+    return positions;
+}
+
+struct Bounds
+{
+    std::array<float, 3> min;
+    /** Largest side of the bounding box, errors are relative to it */
+    float extent;
+};
+
+Bounds computeBounds(std::span<const std::array<float, 3>> positions)
+{
+    if(positions.empty())
+        return { .min = { 0.f, 0.f, 0.f }, .extent = 0.f };
+
+    auto min{ positions[0] };
+    auto max{ positions[0] };
+    for(const auto& position : positions)
+    {
+        for(std::size_t axis{ 0 }; axis < 3; ++axis)
+        {
+            min[axis] = std::min(min[axis], position[axis]);
+            max[axis] = std::max(max[axis], position[axis]);
+        }
+    }
+
+    return { .min = min, .extent = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2] }) };
+}
+
+struct Collapse
+{
+    double error;
+    std::uint32_t from;
+    std::uint32_t to;
+};
+
+/** Positions are compared bit wise, vertices that only differ in attributes share the same bits */
+using PositionBits = std::array<std::uint32_t, 3>;
+
+struct PositionHash
+{
+    std::size_t operator()(const PositionBits& bits) const
+    {
+        std::uint64_t result{ 0xCBF29CE484222325ULL };
+        for(const auto value : bits)
+            result = (result ^ value) * 0x100000001B3ULL;
+
+        return result;
+    }
+};
+
+constexpr std::uint64_t edgeKey(std::uint32_t from, std::uint32_t to)
+{
+    return (static_cast<std::uint64_t>(from) << 32U) | to;
+}
+
+/**
+ *  Everything that stays the same while simplifying: normalized vertex data, the position every vertex shares with
+ *  others and how far each vertex may move.
+*/
+class SimplificationMesh
+{
+public:
+    SimplificationMesh(std::span<const std::byte> vertices, std::size_t stride, const SimplificationLayout& layout, std::span<const std::uint32_t> indices)
+        : m_vertexCount(vertices.size() / stride)
+        , m_points(m_vertexCount)
+        , m_positionIds(m_vertexCount)
+        , m_kinds(m_vertexCount, VertexKind::MANIFOLD)
+    {
+        assert(layout.attributeCount <= MeshSimplifier::MAX_ATTRIBUTE_COUNT && "Too many attributes");
+
+        const auto positions{ readPositions(vertices, stride, layout.positionOffset) };
+        const auto [min, extent]{ computeBounds(positions) };
+        const double scale{ extent > 0.f ? 1.0 / static_cast<double>(extent) : 1.0 };
+
+        std::unordered_map<PositionBits, std::uint32_t, PositionHash> firstWithPosition;
+        std::vector<std::uint32_t> wedgeCounts(m_vertexCount, 0);
+        for(std::size_t i{ 0 }; i < m_vertexCount; ++i)
+        {
+            for(std::size_t axis{ 0 }; axis < 3; ++axis)
+                m_points[i][axis] = static_cast<double>(positions[i][axis] - min[axis]) * scale;
+
+            std::array<float, MeshSimplifier::MAX_ATTRIBUTE_COUNT> attributes{};
+            std::memcpy(attributes.data(), vertices.data() + i * stride + layout.attributeOffset, layout.attributeCount * sizeof(float));
+            for(std::size_t attribute{ 0 }; attribute < layout.attributeCount; ++attribute)
+                m_points[i][3 + attribute] = static_cast<double>(attributes[attribute]) * static_cast<double>(layout.attributeWeight);
+
+            PositionBits bits{};
+            std::memcpy(bits.data(), positions[i].data(), sizeof(bits));
+            const auto [it, inserted]{ firstWithPosition.try_emplace(bits, static_cast<std::uint32_t>(i)) };
+            m_positionIds[i] = it->second;
+            ++wedgeCounts[it->second];
+        }
+
+        classify(indices, wedgeCounts);
+    }
+
+    [[nodiscard]] std::size_t vertexCount() const { return m_vertexCount; }
+    [[nodiscard]] const Point& point(std::uint32_t vertex) const { return m_points[vertex]; }
+    [[nodiscard]] std::uint32_t positionId(std::uint32_t vertex) const { return m_positionIds[vertex]; }
+    [[nodiscard]] VertexKind kind(std::uint32_t vertex) const { return m_kinds[m_positionIds[vertex]]; }
+
+    [[nodiscard]] std::vector<Quadric> computeQuadrics(std::span<const std::uint32_t> indices, const std::unordered_set<std::uint64_t>& edges) const
+    {
+        std::vector<Quadric> quadrics(m_vertexCount);
+        for(std::size_t triangle{ 0 }; triangle + 2 < indices.size(); triangle += 3)
+        {
+            const std::array corners{ indices[triangle], indices[triangle + 1], indices[triangle + 2] };
+            const auto& p0{ m_points[corners[0]] };
+            const auto& p1{ m_points[corners[1]] };
+            const auto& p2{ m_points[corners[2]] };
+
+            const auto normal{ cross(subtract(positionOf(p1), positionOf(p0)), subtract(positionOf(p2), positionOf(p0))) };
+            const double doubleArea{ std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) };
+            if(doubleArea <= 1e-12)
+                continue;
+
+            Point e1{};
+            Point e2{};
+            if(planeDirections(p0, p1, p2, e1, e2))
+            {
+                const auto quadric{ Quadric::fromPlane(p0, e1, e2, doubleArea * 0.5) };
+                for(const auto corner : corners)
+                    quadrics[corner] += quadric;
+            }
+
+            for(std::size_t k{ 0 }; k < 3; ++k)
+            {
+                const auto from{ corners[k] };
+                const auto to{ corners[(k + 1) % 3] };
+                if(edges.contains(edgeKey(m_positionIds[to], m_positionIds[from])))
+                    continue;
+
+                // NOTE: plane through the border edge perpendicular to the triangle, so borders do not shrink
+                const auto edge{ subtract(positionOf(m_points[to]), positionOf(m_points[from])) };
+                const double edgeLengthSquared{ edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2] };
+                auto borderNormal{ cross(edge, normal) };
+                const double borderNormalLength{ std::sqrt(borderNormal[0] * borderNormal[0] + borderNormal[1] * borderNormal[1] + borderNormal[2] * borderNormal[2]) };
+                if(borderNormalLength <= 1e-12)
+                    continue;
+                for(auto& value : borderNormal)
+                    value /= borderNormalLength;
+
+                const auto quadric{ Quadric::fromNormal(m_points[from], borderNormal, edgeLengthSquared * BORDER_WEIGHT) };
+                quadrics[from] += quadric;
+                quadrics[to] += quadric;
+            }
+        }
+
+        return quadrics;
+    }
+
+    /** Directed edges between positions, an edge without its reverse lies on a border */
+    [[nodiscard]] std::unordered_set<std::uint64_t> collectEdges(std::span<const std::uint32_t> indices) const
+    {
+        std::unordered_set<std::uint64_t> edges;
+        edges.reserve(indices.size());
+        for(std::size_t triangle{ 0 }; triangle + 2 < indices.size(); triangle += 3)
+        {
+            for(std::size_t k{ 0 }; k < 3; ++k)
+                edges.insert(edgeKey(m_positionIds[indices[triangle + k]], m_positionIds[indices[triangle + (k + 1) % 3]]));
+        }
+
+        return edges;
+    }
+
+private:
+    std::size_t m_vertexCount;
+    std::vector<Point> m_points;
+    std::vector<std::uint32_t> m_positionIds;
+    std::vector<VertexKind> m_kinds;
+
+    /**
+     *  Lock vertices that are shared by several attribute sets (seams) or have non-manifold edges, and mark vertices
+     *  with exactly one incoming and one outgoing border edge as border vertices.
+    */
+    void classify(std::span<const std::uint32_t> indices, std::span<const std::uint32_t> wedgeCounts)
+    {
+        std::unordered_map<std::uint64_t, std::uint32_t> edgeCounts;
+        edgeCounts.reserve(indices.size());
+        for(std::size_t triangle{ 0 }; triangle + 2 < indices.size(); triangle += 3)
+        {
+            for(std::size_t k{ 0 }; k < 3; ++k)
+                ++edgeCounts[edgeKey(m_positionIds[indices[triangle + k]], m_positionIds[indices[triangle + (k + 1) % 3]])];
+        }
+
+        std::vector<std::uint32_t> borderOut(m_vertexCount, 0);
+        std::vector<std::uint32_t> borderIn(m_vertexCount, 0);
+        for(const auto& [key, count] : edgeCounts)
+        {
+            const auto from{ static_cast<std::uint32_t>(key >> 32U) };
+            const auto to{ static_cast<std::uint32_t>(key & 0xFFFFFFFFU) };
+            if(count > 1)
+            {
+                m_kinds[from] = VertexKind::LOCKED;
+                m_kinds[to] = VertexKind::LOCKED;
+            }
+            else if(!edgeCounts.contains(edgeKey(to, from)))
+            {
+                ++borderOut[from];
+                ++borderIn[to];
+            }
+        }
+
+        for(std::size_t i{ 0 }; i < m_vertexCount; ++i)
+        {
+            if(m_kinds[i] == VertexKind::LOCKED)
+                continue;
+
+            if(wedgeCounts[i] > 1)
+                m_kinds[i] = VertexKind::LOCKED;
+            else if(borderOut[i] == 1 && borderIn[i] == 1)
+                m_kinds[i] = VertexKind::BORDER;
+            else if(borderOut[i] > 0 || borderIn[i] > 0)
+                m_kinds[i] = VertexKind::LOCKED;
+        }
+    }
+};
+
+/** Moving <code>from<\code> onto <code>to<\code> must not turn any remaining triangle around */
+bool flipsTriangle(const SimplificationMesh& mesh, std::span<const std::uint32_t> triangles, std::span<const std::uint32_t> indices, std::uint32_t from, std::uint32_t to)
+{
+    const auto target{ positionOf(mesh.point(to)) };
+    for(const auto triangle : triangles)
+    {
+        std::array<std::array<double, 3>, 3> before{};
+        std::array<std::array<double, 3>, 3> after{};
+        bool collapses{ false };
+        for(std::size_t k{ 0 }; k < 3; ++k)
+        {
+            const auto corner{ indices[triangle * 3 + k] };
+            collapses = collapses || mesh.positionId(corner) == mesh.positionId(to);
+            before[k] = positionOf(mesh.point(corner));
+            after[k] = corner == from ? target : before[k];
+        }
+
+        // NOTE: triangles along the collapsed edge disappear
+        if(collapses)
+            continue;
+
+        const auto normalBefore{ cross(subtract(before[1], before[0]), subtract(before[2], before[0])) };
+        const auto normalAfter{ cross(subtract(after[1], after[0]), subtract(after[2], after[0])) };
+        if(normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] + normalBefore[2] * normalAfter[2] <= 0.0)
+            return true;
+    }
+
+    return false;
+}
+
+} // !namespace
+
+/**
+ *  Collapses run in passes. Each pass ranks every allowed collapse by its error and performs the cheapest ones that do
+ *  not touch a triangle changed earlier in the same pass, so the ranking stays exact within a pass without having to
+ *  maintain a priority queue.
+*/
+std::vector<std::uint32_t> MeshSimplifier::simplify(
+    std::span<const std::byte> vertices,
+    std::size_t stride,
+    const SimplificationLayout& layout,
+    std::span<const std::uint32_t> indices,
+    std::size_t targetIndexCount,
+    float targetError,
+    float* resultError)
+{
+    assert(stride > 0 && vertices.size() % stride == 0 && "Vertex data has to be a multiple of the stride");
+    assert(indices.size() % 3 == 0 && "Only triangle lists can be simplified");
+
+    const SimplificationMesh mesh{ vertices, stride, layout, indices };
+    std::vector<std::uint32_t> result(indices.begin(), indices.end());
+    auto quadrics{ mesh.computeQuadrics(result, mesh.collectEdges(result)) };
+
+    const double errorLimit{ static_cast<double>(targetError) * static_cast<double>(targetError) };
+    double maxError{ 0.0 };
+
+    std::vector<std::uint32_t> triangleOffsets(mesh.vertexCount() + 1);
+    std::vector<std::uint32_t> vertexTriangles;
+    std::vector<Collapse> collapses;
+    std::vector<bool> touched(mesh.vertexCount());
+    std::vector<bool> removed;
+
+    while(result.size() > targetIndexCount)
+    {
+        const std::size_t triangleCount{ result.size() / 3 };
+        const auto edges{ mesh.collectEdges(result) };
+
+        // NOTE: triangles around every vertex, as offsets into one shared array
+        std::ranges::fill(triangleOffsets, 0U);
+        for(const auto index : result)
+            ++triangleOffsets[index + 1];
+        for(std::size_t i{ 1 }; i < triangleOffsets.size(); ++i)
+            triangleOffsets[i] += triangleOffsets[i - 1];
+
+        vertexTriangles.resize(result.size());
+        std::vector<std::uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for(std::size_t i{ 0 }; i < result.size(); ++i)
+            vertexTriangles[fill[result[i]]++] = static_cast<std::uint32_t>(i / 3);
+
+        auto canCollapse{ [&mesh, &edges](std::uint32_t from, std::uint32_t to) {
+            switch(mesh.kind(from))
+            {
+                case VertexKind::MANIFOLD:
+                    return true;
+                case VertexKind::BORDER:
+                    return mesh.kind(to) != VertexKind::MANIFOLD
+                        && edges.contains(edgeKey(mesh.positionId(from), mesh.positionId(to))) != edges.contains(edgeKey(mesh.positionId(to), mesh.positionId(from)));
+                case VertexKind::LOCKED:
+                    return false;
+            }
+
+            return false;
+        } };
+
+        collapses.clear();
+        for(std::size_t i{ 0 }; i < result.size(); ++i)
+        {
+            const auto a{ result[i] };
+            const auto b{ result[i - i % 3 + (i + 1) % 3] };
+            for(const auto& [from, to] : { std::pair{ a, b }, std::pair{ b, a } })
+            {
+                if(!canCollapse(from, to))
+                    continue;
+
+                const auto& target{ mesh.point(to) };
+                const double weight{ std::max(quadrics[from].weight + quadrics[to].weight, 1e-12) };
+                const double error{ std::max(quadrics[from].evaluate(target) + quadrics[to].evaluate(target), 0.0) / weight };
+                collapses.push_back({ .error = error, .from = from, .to = to });
+            }
+        }
+
+        std::ranges::sort(collapses, {}, &Collapse::error);
+
+        const std::size_t targetTriangleCount{ targetIndexCount / 3 };
+        std::size_t removedCount{ 0 };
+        std::fill(touched.begin(), touched.end(), false);
+        removed.assign(triangleCount, false);
+
+        for(const auto& collapse : collapses)
+        {
+            if(collapse.error > errorLimit || triangleCount - removedCount <= targetTriangleCount)
+                break;
+            if(touched[mesh.positionId(collapse.from)] || touched[mesh.positionId(collapse.to)])
+                continue;
+
+            const std::span<const std::uint32_t> triangles{ vertexTriangles.data() + triangleOffsets[collapse.from], vertexTriangles.data() + triangleOffsets[collapse.from + 1] };
+            if(flipsTriangle(mesh, triangles, result, collapse.from, collapse.to))
+                continue;
+
+            for(const auto triangle : triangles)
+            {
+                auto* const corners{ result.data() + static_cast<std::size_t>(triangle) * 3 };
+                for(std::size_t k{ 0 }; k < 3; ++k)
+                {
+                    touched[mesh.positionId(corners[k])] = true;
+                    // NOTE: the target is the vertex on the collapsed edge, so the attributes of its side are kept
+                    if(corners[k] == collapse.from)
+                        corners[k] = collapse.to;
+                }
+
+                const auto p0{ mesh.positionId(corners[0]) };
+                const auto p1{ mesh.positionId(corners[1]) };
+                const auto p2{ mesh.positionId(corners[2]) };
+                if(!removed[triangle] && (p0 == p1 || p1 == p2 || p0 == p2))
+                {
+                    removed[triangle] = true;
+                    ++removedCount;
+                }
+            }
+
+            quadrics[collapse.to] += quadrics[collapse.from];
+            maxError = std::max(maxError, collapse.error);
+        }
+
+        if(removedCount == 0)
+            break;
+
+        std::size_t write{ 0 };
+        for(std::size_t triangle{ 0 }; triangle < triangleCount; ++triangle)
+        {
+            if(removed[triangle])
+                continue;
+
+            std::copy_n(result.begin() + static_cast<std::ptrdiff_t>(triangle * 3), 3, result.begin() + static_cast<std::ptrdiff_t>(write));
+            write += 3;
+        }
+        result.resize(write);
+    }
+
+    if(resultError != nullptr)
+        *resultError = static_cast<float>(std::sqrt(maxError));
+
+    return result;
+}
+
+std::vector<MeshLod> MeshSimplifier::generateLods(
+    std::span<const std::byte> vertices,
+    std::size_t stride,
+    const SimplificationLayout& layout,
+    std::vector<std::uint32_t>& indices,
+    float maxError)
+{
+    if(indices.size() < 3)
+        return {};
+
+    std::vector<MeshLod> lods{ { .firstIndex = 0, .indexCount = static_cast<std::uint32_t>(indices.size()), .error = 0.f } };
+    const float extent{ computeBounds(readPositions(vertices, stride, layout.positionOffset)).extent };
+
+    // NOTE: every level is simplified from the one before, which is much faster than starting over from the full mesh
+    std::vector<std::uint32_t> previous(indices);
+    float previousError{ 0.f };
+    while(lods.size() < MAX_LOD_COUNT && previous.size() >= MIN_LOD_INDEX_COUNT && previousError < maxError)
+    {
+        float error{ 0.f };
+        auto lod{ simplify(vertices, stride, layout, previous, previous.size() / 6 * 3, maxError - previousError, &error) };
+        if(lod.empty() || static_cast<float>(lod.size()) > static_cast<float>(previous.size()) * (1.f - MIN_LOD_REDUCTION))
+            break;
+
+        MeshOptimizer::optimizeVertexCache(lod, vertices.size() / stride);
+
+        // NOTE: errors of consecutive levels add up, the distance of a surface to the original is at most their sum
+        previousError += error;
+        lods.push_back({ .firstIndex = static_cast<std::uint32_t>(indices.size()), .indexCount = static_cast<std::uint32_t>(lod.size()), .error = previousError * extent });
+        indices.insert(indices.end(), lod.begin(), lod.end());
+        previous = std::move(lod);
+    }
+
+    return lods;
+}
+
+} // !rr
@@ -0,0 +1,91 @@
+#ifndef RRENDERER_ENGINE_MESH_MESH_SIMPLIFIER_HPP
+#define RRENDERER_ENGINE_MESH_MESH_SIMPLIFIER_HPP
+
+#include "mesh/MeshLod.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rr
+{
+
+/** Where the simplifier finds the data of a vertex, positions are three floats and attributes up to three floats */
+struct SimplificationLayout
+{
+    std::size_t positionOffset{ 0 };
+    std::size_t attributeOffset{ 0 };
+    std::size_t attributeCount{ 0 };
+    /** Importance of attribute differences relative to geometric ones, positions are normalized to the unit cube */
+    float attributeWeight{ 0.1f };
+};
+
+/**
+ *  <code>MeshSimplifier<\code> reduces the triangle count of indexed meshes by collapsing edges in the order of their
+ *  quadric error (Garland & Heckbert). The quadrics span positions and attributes, so collapses that would smear
+ *  e.g. colors are as expensive as those that change the silhouette.
+ *
+ *  Collapses only move a vertex onto one of its neighbors, so the result indexes the original vertex buffer and all
+ *  levels of detail of a mesh can share it. Vertices on attribute seams and non-manifold edges never move, vertices on
+ *  open borders only move along the border, which keeps meshes free of cracks.
+ *
+ *  Errors are relative to the largest extent of the mesh, 0.01 is a deviation of one percent of its size.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class MeshSimplifier
+{
+public:
+    static constexpr std::size_t MAX_ATTRIBUTE_COUNT{ 3 };
+    static constexpr std::size_t MAX_LOD_COUNT{ 8 };
+    /** Coarsest level of detail generated, relative to the extent of the mesh */
+    static constexpr float DEFAULT_MAX_LOD_ERROR{ 0.1f };
+
+    /**
+     *  Simplify until at most <code>targetIndexCount<\code> indices are left or the next collapse would exceed
+     *  <code>targetError<\code>, whichever happens first.
+     *
+     *  @param resultError - receives the error of the returned mesh if not null
+    */
+    [[nodiscard]] static std::vector<std::uint32_t> simplify(
+        std::span<const std::byte> vertices,
+        std::size_t stride,
+        const SimplificationLayout& layout,
+        std::span<const std::uint32_t> indices,
+        std::size_t targetIndexCount,
+        float targetError,
+        float* resultError = nullptr);
+
+    /**
+     *  Build a chain of levels of detail that each halve the triangle count of the one before, until the error
+     *  reaches <code>maxError<\code> or simplification stalls. The levels are appended to <code>indices<\code>, level
+     *  0 stays the original mesh at the front. Errors of the returned levels are in model space units.
+    */
+    [[nodiscard]] static std::vector<MeshLod> generateLods(
+        std::span<const std::byte> vertices,
+        std::size_t stride,
+        const SimplificationLayout& layout,
+        std::vector<std::uint32_t>& indices,
+        float maxError = DEFAULT_MAX_LOD_ERROR);
+
+    template<typename V>
+    [[nodiscard]] static std::vector<MeshLod> generateLods(const std::vector<V>& vertices, std::vector<std::uint32_t>& indices, const SimplificationLayout& layout, float maxError = DEFAULT_MAX_LOD_ERROR)
+    {
+        static_assert(std::is_trivially_copyable_v<V>, "Vertices are read as raw bytes");
+
+        return generateLods(std::as_bytes(std::span{ vertices }), sizeof(V), layout, indices, maxError);
+    }
+
+private:
+    /** A level has to remove at least this share of the triangles of the level before, otherwise the chain ends */
+    static constexpr float MIN_LOD_REDUCTION{ 0.1f };
+    /** Meshes this small are cheaper to draw than to switch levels for */
+    static constexpr std::size_t MIN_LOD_INDEX_COUNT{ 3 * 64 };
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESH_SIMPLIFIER_HPP
@@ -0,0 +1,99 @@
+#ifndef RRENDERER_ENGINE_MESH_MESHLET_HPP
+#define RRENDERER_ENGINE_MESH_MESHLET_HPP
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/ext/vector_float3.hpp"
+#include "glm/ext/vector_float4.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Small cluster of a mesh. Vertices are listed in <code>MeshletData::vertices<\code> and triangles as three local
+ *  vertex indices of one byte each in <code>MeshletData::triangles<\code>. Meshlets cover consecutive triangles of
+ *  the index buffer, so <code>triangleOffset<\code> is also the first index of the meshlet in it.
+*/
+struct Meshlet
+{
+    std::uint32_t vertexOffset;
+    std::uint32_t triangleOffset;
+    std::uint32_t vertexCount;
+    std::uint32_t triangleCount;
+};
+
+/**
+ *  Bounding sphere and normal cone of a meshlet in model space, laid out according to std430. Normals follow the
+ *  counter clockwise winding, a cutoff of 1 marks a cone too wide to ever be back facing.
+*/
+struct MeshletBounds
+{
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneAxis;
+    float coneCutoff;
+};
+
+struct MeshletData
+{
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;
+    std::vector<std::uint32_t> vertices;
+    std::vector<std::uint8_t> triangles;
+};
+
+/**
+ *  View a draw is culled against, laid out according to std140 as it is read by the culling shaders. Culling happens
+ *  in world space, the model is only translated.
+*/
+struct MeshletCullData
+{
+    /** Planes as normal and distance, the normal points inside */
+    std::array<glm::vec4, 6> frustumPlanes;
+    /** Camera position with w = 1, or view direction with w = 0 for orthographic projections */
+    glm::vec4 camera;
+    glm::vec4 translation;
+    std::uint32_t meshletCount;
+    std::uint32_t drawIndex;
+    /** Only valid if back faces are culled by the pipeline, 0 or 1 */
+    std::uint32_t coneCulling;
+    /** Position of the mesh in the index and vertex blocks of the geometry pool */
+    std::uint32_t firstIndex;
+    std::int32_t vertexOffset;
+};
+
+/** CPU version of the test the culling shaders run for every meshlet */
+[[nodiscard]] inline bool isMeshletVisible(const MeshletBounds& bounds, const MeshletCullData& view)
+{
+    const float x{ bounds.center.x + view.translation.x };
+    const float y{ bounds.center.y + view.translation.y };
+    const float z{ bounds.center.z + view.translation.z };
+
+    for(const auto& plane : view.frustumPlanes)
+    {
+        if(plane.x * x + plane.y * y + plane.z * z + plane.w < -bounds.radius)
+            return false;
+    }
+
+    if(view.coneCulling == 0)
+        return true;
+
+    if(view.camera.w == 0.f)
+        return view.camera.x * bounds.coneAxis.x + view.camera.y * bounds.coneAxis.y + view.camera.z * bounds.coneAxis.z < bounds.coneCutoff;
+
+    const float dx{ x - view.camera.x };
+    const float dy{ y - view.camera.y };
+    const float dz{ z - view.camera.z };
+    const float distance{ std::sqrt(dx * dx + dy * dy + dz * dz) };
+
+    return dx * bounds.coneAxis.x + dy * bounds.coneAxis.y + dz * bounds.coneAxis.z < bounds.coneCutoff * distance + bounds.radius;
+}
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESHLET_HPP
@@ -0,0 +1,182 @@
+#include "MeshletBuilder.hpp"
+
+#include "mesh/Meshlet.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace rr
+{
+
+namespace
+{
+
+constexpr std::uint8_t NOT_IN_MESHLET{ std::numeric_limits<std::uint8_t>::max() };
+/** Normal cones wider than this (the dot product of the axis with the widest normal) are never back facing */
+constexpr float MIN_CONE_SPREAD{ 0.1f };
+
+using Position = std::array<float, 3>;
+
+Position readPosition(std::span<const std::byte> vertices, std::size_t stride, std::size_t positionOffset, std::uint32_t index)
+{
+    Position position{};
+    std::memcpy(position.data(), vertices.data() + index * stride + positionOffset, sizeof(position));
+
+    return position;
+}
+
+/** Sphere around the bounding box of the vertices and cone around the normals of the triangles */
+MeshletBounds computeBounds(std::span<const Position> positions, std::span<const std::uint8_t> triangles)
+{
+    Position min{ positions[0] };
+    Position max{ positions[0] };
+    for(const auto& position : positions)
+    {
+        for(std::size_t axis{ 0 }; axis < 3; ++axis)
+        {
+            min[axis] = std::min(min[axis], position[axis]);
+            max[axis] = std::max(max[axis], position[axis]);
+        }
+    }
+
+    const Position center{ (min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f };
+    float radiusSquared{ 0.f };
+    for(const auto& position : positions)
+    {
+        const float dx{ position[0] - center[0] };
+        const float dy{ position[1] - center[1] };
+        const float dz{ position[2] - center[2] };
+        radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+    }
+
+    std::vector<Position> normals;
+    normals.reserve(triangles.size() / 3);
+    Position axis{ 0.f, 0.f, 0.f };
+    for(std::size_t i{ 0 }; i < triangles.size(); i += 3)
+    {
+        const auto& a{ positions[triangles[i]] };
+        const auto& b{ positions[triangles[i + 1]] };
+        const auto& c{ positions[triangles[i + 2]] };
+        const Position ab{ b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const Position ac{ c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        Position normal{ ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+
+        const float length{ std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) };
+        if(length <= 0.f)
+            continue;
+
+        for(std::size_t k{ 0 }; k < 3; ++k)
+        {
+            normal[k] /= length;
+            axis[k] += normal[k];
+        }
+        normals.push_back(normal);
+    }
+
+    MeshletBounds bounds{
+        .center = { center[0], center[1], center[2] },
+        .radius = std::sqrt(radiusSquared),
+        .coneAxis = { 0.f, 0.f, 0.f },
+        .coneCutoff = 1.f
+    };
+
+    const float axisLength{ std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]) };
+    if(normals.empty() || axisLength <= 0.f)
+        return bounds;
+
+    bounds.coneAxis = { axis[0] / axisLength, axis[1] / axisLength, axis[2] / axisLength };
+
+    float minDot{ 1.f };
+    for(const auto& normal : normals)
+        minDot = std::min(minDot, normal[0] * bounds.coneAxis.x + normal[1] * bounds.coneAxis.y + normal[2] * bounds.coneAxis.z);
+
+    // NOTE: the cutoff is the sine of the cone angle, the view vector has to be at least that far behind the cone
+    if(minDot > MIN_CONE_SPREAD)
+        bounds.coneCutoff = std::sqrt(1.f - minDot * minDot);
+
+    return bounds;
+}
+
+} // !namespace
+
+MeshletData MeshletBuilder::build(
+    std::span<const std::byte> vertices,
+    std::size_t stride,
+    std::size_t positionOffset,
+    std::span<const std::uint32_t> indices,
+    std::uint32_t maxVertices,
+    std::uint32_t maxTriangles)
+{
+    assert(stride > 0 && vertices.size() % stride == 0 && "Vertex data has to be a multiple of the stride");
+    assert(indices.size() % 3 == 0 && "Only triangle lists can be split into meshlets");
+    assert(maxVertices >= 3 && maxVertices < NOT_IN_MESHLET && maxTriangles > 0 && "Meshlets need room for a triangle and local indices fit a byte");
+
+    MeshletData result;
+    result.vertices.reserve(indices.size() / 2);
+    result.triangles.reserve(indices.size());
+
+    // NOTE: local index of every vertex in the open meshlet, reset for its vertices only when it is closed
+    std::vector<std::uint8_t> localIndices(vertices.size() / stride, NOT_IN_MESHLET);
+    std::vector<Position> positions;
+    Meshlet current{ .vertexOffset = 0, .triangleOffset = 0, .vertexCount = 0, .triangleCount = 0 };
+
+    auto close{ [&]() {
+        if(current.triangleCount == 0)
+            return;
+
+        for(std::uint32_t i{ 0 }; i < current.vertexCount; ++i)
+        {
+            const auto vertex{ result.vertices[current.vertexOffset + i] };
+            localIndices[vertex] = NOT_IN_MESHLET;
+            positions.push_back(readPosition(vertices, stride, positionOffset, vertex));
+        }
+
+        result.meshlets.push_back(current);
+        result.bounds.push_back(computeBounds(positions, std::span{ result.triangles }.subspan(current.triangleOffset, current.triangleCount * 3)));
+        positions.clear();
+
+        current = { .vertexOffset = static_cast<std::uint32_t>(result.vertices.size()), .triangleOffset = static_cast<std::uint32_t>(result.triangles.size()), .vertexCount = 0, .triangleCount = 0 };
+    } };
+
+    for(std::size_t i{ 0 }; i < indices.size(); i += 3)
+    {
+        const std::array corners{ indices[i], indices[i + 1], indices[i + 2] };
+
+        std::uint32_t newVertices{ 0 };
+        for(std::size_t k{ 0 }; k < 3; ++k)
+        {
+            const bool repeated{ (k > 0 && corners[k] == corners[0]) || (k > 1 && corners[k] == corners[1]) };
+            if(localIndices[corners[k]] == NOT_IN_MESHLET && !repeated)
+                ++newVertices;
+        }
+
+        if(current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles)
+            close();
+
+        for(const auto corner : corners)
+        {
+            if(localIndices[corner] == NOT_IN_MESHLET)
+            {
+                localIndices[corner] = static_cast<std::uint8_t>(current.vertexCount++);
+                result.vertices.push_back(corner);
+            }
+
+            result.triangles.push_back(localIndices[corner]);
+        }
+        ++current.triangleCount;
+    }
+
+    close();
+
+    return result;
+}
+
+} // !rr
@@ -0,0 +1,51 @@
+#ifndef RRENDERER_ENGINE_MESH_MESHLET_BUILDER_HPP
+#define RRENDERER_ENGINE_MESH_MESHLET_BUILDER_HPP
+
+#include "mesh/Meshlet.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>MeshletBuilder<\code> splits indexed triangle lists into meshlets for cluster culling and mesh shaders.
+ *
+ *  Triangles are taken in index buffer order and a meshlet is closed once the next triangle would exceed either limit.
+ *  Index buffers that went through <code>MeshOptimizer<\code> are already sorted for vertex reuse, so this yields
+ *  compact clusters without any spatial search.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class MeshletBuilder
+{
+public:
+    /** Limits that fit the output of a single mesh shader workgroup well on current hardware */
+    static constexpr std::uint32_t MAX_VERTICES{ 64 };
+    static constexpr std::uint32_t MAX_TRIANGLES{ 124 };
+
+    [[nodiscard]] static MeshletData build(
+        std::span<const std::byte> vertices,
+        std::size_t stride,
+        std::size_t positionOffset,
+        std::span<const std::uint32_t> indices,
+        std::uint32_t maxVertices = MAX_VERTICES,
+        std::uint32_t maxTriangles = MAX_TRIANGLES);
+
+    template<typename V>
+    [[nodiscard]] static MeshletData build(const std::vector<V>& vertices, std::span<const std::uint32_t> indices, std::size_t positionOffset)
+    {
+        static_assert(std::is_trivially_copyable_v<V>, "Vertices are read as raw bytes");
+
+        return build(std::as_bytes(std::span{ vertices }), sizeof(V), positionOffset, indices);
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_MESHLET_BUILDER_HPP
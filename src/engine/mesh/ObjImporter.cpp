@@ -0,0 +1,360 @@
+#include "ObjImporter.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/MeshImportException.hpp"
+#include "mesh/MeshData.hpp"
+#include "mesh/Vertex.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include <source_location>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace rr
+{
+
+namespace
+{
+
+struct Float3
+{
+    float x{ 0.f };
+    float y{ 0.f };
+    float z{ 0.f };
+};
+
+struct Position
+{
+    Float3 position;
+    Float3 color;
+    bool hasColor{ false };
+};
+
+/**
+ *  Indices are zero based. Negative OBJ indices count back from the last element defined before the face, as chunks
+ *  do not know how much was defined before them these are stored relative to the chunk and resolved later.
+*/
+struct Corner
+{
+    static constexpr std::int64_t NO_NORMAL{ std::numeric_limits<std::int64_t>::min() };
+    static constexpr std::uint8_t POSITION_RELATIVE{ 1U << 0U };
+    static constexpr std::uint8_t NORMAL_RELATIVE{ 1U << 1U };
+
+    std::int64_t position{ 0 };
+    std::int64_t normal{ NO_NORMAL };
+    std::uint8_t relative{ 0 };
+};
+
+struct Chunk
+{
+    std::string_view text;
+    std::vector<Position> positions;
+    std::vector<Float3> normals;
+    /** Already triangulated, three corners per triangle */
+    std::vector<Corner> corners;
+    bool referencesNormals{ false };
+
+    std::size_t positionOffset{ 0 };
+    std::size_t normalOffset{ 0 };
+    std::size_t cornerOffset{ 0 };
+};
+
+class LineParser
+{
+public:
+    LineParser(std::string_view line, const std::string& name) : m_current(line.data()), m_end(line.data() + line.size()), name(name) {}
+
+    void skipWhitespace()
+    {
+        while(m_current != m_end && (*m_current == ' ' || *m_current == '\t' || *m_current == '\r'))
+            ++m_current;
+    }
+
+    [[nodiscard]] bool atEnd()
+    {
+        skipWhitespace();
+        return m_current == m_end;
+    }
+
+    /** Consume the first token of the line */
+    [[nodiscard]] std::string_view keyword()
+    {
+        skipWhitespace();
+        const char* begin{ m_current };
+        while(m_current != m_end && *m_current != ' ' && *m_current != '\t' && *m_current != '\r')
+            ++m_current;
+
+        return { begin, static_cast<std::size_t>(m_current - begin) };
+    }
+
+    float readFloat()
+    {
+        float value{ 0.f };
+        if(!tryReadFloat(value))
+            throwWithLog<MeshImportException>(std::source_location::current(), MeshImportExceptionCause::MALFORMED_OBJ, name);
+
+        return value;
+    }
+
+    bool tryReadFloat(float& value)
+    {
+        skipWhitespace();
+        const auto [end, error]{ std::from_chars(m_current, m_end, value) };
+        if(error != std::errc{})
+            return false;
+
+        m_current = end;
+        return true;
+    }
+
+    /**
+     *  Read a single <code>v/vt/vn<\code> corner. <code>positionCount<\code> and <code>normalCount<\code> are the
+     *  amount of elements this chunk has defined so far.
+    */
+    Corner readCorner(std::size_t positionCount, std::size_t normalCount, bool& hasNormal)
+    {
+        Corner corner;
+        corner.position = readIndex(positionCount, Corner::POSITION_RELATIVE, corner.relative);
+
+        hasNormal = false;
+        if(m_current == m_end || *m_current != '/')
+            return corner;
+        ++m_current;
+
+        // NOTE: texture coordinates are not part of the vertex format, they are only skipped
+        if(m_current != m_end && *m_current != '/')
+            readIndex(0, 0, corner.relative);
+
+        if(m_current == m_end || *m_current != '/')
+            return corner;
+        ++m_current;
+
+        corner.normal = readIndex(normalCount, Corner::NORMAL_RELATIVE, corner.relative);
+        hasNormal = true;
+
+        return corner;
+    }
+
+private:
+    const char* m_current;
+    const char* m_end;
+    const std::string& name;
+
+    std::int64_t readIndex(std::size_t localCount, std::uint8_t relativeFlag, std::uint8_t& relative)
+    {
+        std::int64_t value{ 0 };
+        const auto [end, error]{ std::from_chars(m_current, m_end, value) };
+        if(error != std::errc{} || value == 0)
+            throwWithLog<MeshImportException>(std::source_location::current(), MeshImportExceptionCause::MALFORMED_OBJ, name);
+
+        m_current = end;
+        if(value > 0)
+            return value - 1;
+
+        relative |= relativeFlag;
+        return static_cast<std::int64_t>(localCount) + value;
+    }
+};
+
+void parseChunk(Chunk& chunk, const std::string& name)
+{
+    std::vector<Corner> polygon;
+
+    std::string_view remaining{ chunk.text };
+    while(!remaining.empty())
+    {
+        const auto lineEnd{ remaining.find('\n') };
+        const auto line{ remaining.substr(0, lineEnd) };
+        remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
+
+        LineParser parser{ line, name };
+        const auto keyword{ parser.keyword() };
+
+        if(keyword == "v")
+        {
+            Position position{ .position = { parser.readFloat(), parser.readFloat(), parser.readFloat() } };
+
+            // NOTE: vertex colors are a common extension, "v x y z r g b"
+            Float3 color;
+            if(parser.tryReadFloat(color.x))
+            {
+                color.y = parser.readFloat();
+                color.z = parser.readFloat();
+                position.color = color;
+                position.hasColor = true;
+            }
+
+            chunk.positions.push_back(position);
+        }
+        else if(keyword == "vn")
+        {
+            chunk.normals.push_back({ parser.readFloat(), parser.readFloat(), parser.readFloat() });
+        }
+        else if(keyword == "f")
+        {
+            polygon.clear();
+            while(!parser.atEnd())
+            {
+                bool hasNormal{ false };
+                polygon.push_back(parser.readCorner(chunk.positions.size(), chunk.normals.size(), hasNormal));
+                chunk.referencesNormals |= hasNormal;
+            }
+
+            if(polygon.size() < 3)
+                throwWithLog<MeshImportException>(std::source_location::current(), MeshImportExceptionCause::MALFORMED_OBJ, name);
+
+            for(std::size_t i{ 1 }; i + 1 < polygon.size(); ++i)
+                chunk.corners.insert(chunk.corners.end(), { polygon[0], polygon[i], polygon[i + 1] });
+        }
+    }
+}
+
+/**
+ *  Split <code>text<\code> into at most <code>maxChunkCount<\code> pieces of at least <code>minChunkSize<\code>
+ *  bytes, every piece but the last ends with a newline.
+*/
+std::vector<Chunk> splitIntoChunks(std::string_view text, std::size_t minChunkSize, std::size_t maxChunkCount)
+{
+    const std::size_t chunkCount{ std::clamp<std::size_t>(text.size() / std::max<std::size_t>(minChunkSize, 1), 1, maxChunkCount) };
+    const std::size_t targetSize{ text.size() / chunkCount };
+
+    std::vector<Chunk> chunks;
+    chunks.reserve(chunkCount);
+
+    std::size_t begin{ 0 };
+    while(begin < text.size())
+    {
+        std::size_t end{ text.size() };
+        if(chunks.size() + 1 < chunkCount)
+        {
+            const auto newline{ text.find('\n', begin + targetSize) };
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+
+        chunks.push_back({ .text = text.substr(begin, end - begin) });
+        begin = end;
+    }
+
+    return chunks;
+}
+
+std::size_t resolve(std::int64_t index, bool relative, std::size_t chunkOffset, std::size_t count, const std::string& name)
+{
+    const std::int64_t resolved{ relative ? static_cast<std::int64_t>(chunkOffset) + index : index };
+    if(resolved < 0 || static_cast<std::size_t>(resolved) >= count)
+        throwWithLog<MeshImportException>(std::source_location::current(), MeshImportExceptionCause::INDEX_OUT_OF_RANGE, name);
+
+    return static_cast<std::size_t>(resolved);
+}
+
+Vertex makeVertex(const Position& position, const Float3* normal)
+{
+    Float3 color{ 1.f, 1.f, 1.f };
+    if(position.hasColor)
+        color = position.color;
+    else if(normal != nullptr)
+        color = { normal->x * 0.5f + 0.5f, normal->y * 0.5f + 0.5f, normal->z * 0.5f + 0.5f };
+
+    return {
+        .position = { position.position.x, position.position.y, position.position.z },
+        .color = { color.x, color.y, color.z }
+    };
+}
+
+} // !namespace
+
+MeshData ObjImporter::parse(std::string_view text, ThreadPool& threadPool, const std::string& name, std::size_t minChunkSize)
+{
+    auto chunks{ splitIntoChunks(text, minChunkSize, threadPool.threadCount()) };
+
+    threadPool.parallelFor(chunks.size(), 1, [&chunks, &name](std::size_t begin, std::size_t end) {
+        for(std::size_t i{ begin }; i < end; ++i)
+            parseChunk(chunks[i], name);
+    });
+
+    // NOTE: prefix sums give every chunk the place of its elements in the whole file
+    std::size_t positionCount{ 0 };
+    std::size_t normalCount{ 0 };
+    std::size_t cornerCount{ 0 };
+    bool referencesNormals{ false };
+    for(auto& chunk : chunks)
+    {
+        chunk.positionOffset = positionCount;
+        chunk.normalOffset = normalCount;
+        chunk.cornerOffset = cornerCount;
+        positionCount += chunk.positions.size();
+        normalCount += chunk.normals.size();
+        cornerCount += chunk.corners.size();
+        referencesNormals |= chunk.referencesNormals;
+    }
+
+    // NOTE: faces may reference elements of any other chunk, so lookups go through the chunk that owns the element
+    auto findPosition{ [&chunks](std::size_t index) -> const Position& {
+        const auto chunk{ std::upper_bound(chunks.begin(), chunks.end(), index, [](std::size_t value, const Chunk& c) { return value < c.positionOffset; }) - 1 };
+        return chunk->positions[index - chunk->positionOffset];
+    } };
+    auto findNormal{ [&chunks](std::size_t index) -> const Float3& {
+        const auto chunk{ std::upper_bound(chunks.begin(), chunks.end(), index, [](std::size_t value, const Chunk& c) { return value < c.normalOffset; }) - 1 };
+        return chunk->normals[index - chunk->normalOffset];
+    } };
+
+    MeshData mesh;
+    mesh.indices.resize(cornerCount);
+
+    if(!referencesNormals)
+    {
+        mesh.vertices.resize(positionCount);
+
+        threadPool.parallelFor(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for(std::size_t i{ begin }; i < end; ++i)
+            {
+                const auto& chunk{ chunks[i] };
+                for(std::size_t p{ 0 }; p < chunk.positions.size(); ++p)
+                    mesh.vertices[chunk.positionOffset + p] = makeVertex(chunk.positions[p], nullptr);
+
+                for(std::size_t c{ 0 }; c < chunk.corners.size(); ++c)
+                {
+                    const auto& corner{ chunk.corners[c] };
+                    const bool relative{ (corner.relative & Corner::POSITION_RELATIVE) != 0 };
+                    mesh.indices[chunk.cornerOffset + c] = static_cast<std::uint32_t>(resolve(corner.position, relative, chunk.positionOffset, positionCount, name));
+                }
+            }
+        });
+
+        return mesh;
+    }
+
+    mesh.vertices.resize(cornerCount);
+
+    threadPool.parallelFor(chunks.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i{ begin }; i < end; ++i)
+        {
+            const auto& chunk{ chunks[i] };
+            for(std::size_t c{ 0 }; c < chunk.corners.size(); ++c)
+            {
+                const auto& corner{ chunk.corners[c] };
+                const auto position{ resolve(corner.position, (corner.relative & Corner::POSITION_RELATIVE) != 0, chunk.positionOffset, positionCount, name) };
+
+                const Float3* normal{ nullptr };
+                if(corner.normal != Corner::NO_NORMAL)
+                    normal = &findNormal(resolve(corner.normal, (corner.relative & Corner::NORMAL_RELATIVE) != 0, chunk.normalOffset, normalCount, name));
+
+                const std::size_t vertex{ chunk.cornerOffset + c };
+                mesh.vertices[vertex] = makeVertex(findPosition(position), normal);
+                mesh.indices[vertex] = static_cast<std::uint32_t>(vertex);
+            }
+        }
+    });
+
+    return mesh;
+}
+
+} // !rr
@@ -0,0 +1,40 @@
+#ifndef RRENDERER_ENGINE_MESH_OBJ_IMPORTER_HPP
+#define RRENDERER_ENGINE_MESH_OBJ_IMPORTER_HPP
+
+#include "mesh/MeshData.hpp"
+#include "utility/ThreadPool.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace rr
+{
+
+/**
+ *  <code>ObjImporter<\code> parses Wavefront OBJ text. The text is split into chunks at line boundaries which are
+ *  parsed in parallel, afterwards every chunk writes its triangles straight into the final arrays at an offset given
+ *  by the prefix sum over all chunks.
+ *
+ *  Supported are <code>v<\code> (with optional vertex colors), <code>vn<\code> and <code>f<\code> with positive or
+ *  negative indices. Polygons are triangulated as fans, everything else is skipped. Colors are taken from the vertex
+ *  color, the normal or white in that order of preference. If no face references a normal the positions are used as
+ *  vertices directly, otherwise every face corner becomes its own vertex and deduplication is left to
+ *  <code>MeshOptimizer<\code>.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class ObjImporter
+{
+public:
+    /** Chunks smaller than this are not worth a task of their own */
+    static constexpr std::size_t DEFAULT_MIN_CHUNK_SIZE{ 1UL << 20UL };
+
+    /** <code>name<\code> is only used for error reporting */
+    [[nodiscard]] static MeshData parse(std::string_view text, ThreadPool& threadPool, const std::string& name, std::size_t minChunkSize = DEFAULT_MIN_CHUNK_SIZE);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_OBJ_IMPORTER_HPP
@@ -0,0 +1,57 @@
+#include "PackedVertex.hpp"
+
+#include "mesh/Vertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace rr
+{
+
+Octahedral16 encodeOctahedral(float x, float y, float z)
+{
+    // NOTE: project onto the octahedron |x| + |y| + |z| = 1, the lower half is folded over the diagonals
+    const float length{ std::abs(x) + std::abs(y) + std::abs(z) };
+    float u{ length > 0.f ? x / length : 0.f };
+    float v{ length > 0.f ? y / length : 0.f };
+
+    if(z < 0.f)
+    {
+        const float foldedU{ (1.f - std::abs(v)) * (u >= 0.f ? 1.f : -1.f) };
+        const float foldedV{ (1.f - std::abs(u)) * (v >= 0.f ? 1.f : -1.f) };
+        u = foldedU;
+        v = foldedV;
+    }
+
+    return { .value = { packSnorm16(u), packSnorm16(v) } };
+}
+
+std::array<float, 3> decodeOctahedral(Octahedral16 encoded)
+{
+    float x{ std::max(static_cast<float>(encoded.value[0]) / 32767.f, -1.f) };
+    float y{ std::max(static_cast<float>(encoded.value[1]) / 32767.f, -1.f) };
+    const float z{ 1.f - std::abs(x) - std::abs(y) };
+
+    if(z < 0.f)
+    {
+        const float unfoldedX{ (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f) };
+        const float unfoldedY{ (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f) };
+        x = unfoldedX;
+        y = unfoldedY;
+    }
+
+    const float length{ std::sqrt(x * x + y * y + z * z) };
+
+    return { x / length, y / length, z / length };
+}
+
+PackedVertex PackedVertex::pack(const Vertex& vertex)
+{
+    return {
+        .position = { .value = { floatToHalf(vertex.position.x), floatToHalf(vertex.position.y), floatToHalf(vertex.position.z), floatToHalf(1.f) } },
+        .color = { .value = { packUnorm8(vertex.color.x), packUnorm8(vertex.color.y), packUnorm8(vertex.color.z), packUnorm8(1.f) } }
+    };
+}
+
+} // !rr
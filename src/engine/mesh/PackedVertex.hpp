@@ -0,0 +1,156 @@
+#ifndef RRENDERER_ENGINE_MESH_PACKED_VERTEX_HPP
+#define RRENDERER_ENGINE_MESH_PACKED_VERTEX_HPP
+
+#include "mesh/Vertex.hpp"
+#include "mesh/VertexLayout.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace rr
+{
+
+/** Four IEEE 754 half floats. Three component half formats are rarely supported for vertex input, so w is padding */
+struct Half4
+{
+    std::array<std::uint16_t, 4> value;
+};
+
+/** Four floats in [0, 1] stored as bytes, e.g. colors */
+struct Unorm8x4
+{
+    std::array<std::uint8_t, 4> value;
+};
+
+/** Four floats in [-1, 1] stored as bytes, e.g. normals and tangents with a sign in w */
+struct Snorm8x4
+{
+    std::array<std::int8_t, 4> value;
+};
+
+/** Unit vector mapped onto an octahedron and unfolded into a square, has to be decoded in the shader */
+struct Octahedral16
+{
+    std::array<std::int16_t, 2> value;
+};
+
+template<> struct VertexFormat<Half4> { static constexpr VkFormat value{ VK_FORMAT_R16G16B16A16_SFLOAT }; };
+template<> struct VertexFormat<Unorm8x4> { static constexpr VkFormat value{ VK_FORMAT_R8G8B8A8_UNORM }; };
+template<> struct VertexFormat<Snorm8x4> { static constexpr VkFormat value{ VK_FORMAT_R8G8B8A8_SNORM }; };
+template<> struct VertexFormat<Octahedral16> { static constexpr VkFormat value{ VK_FORMAT_R16G16_SNORM }; };
+
+/** Round to nearest even, values out of range become infinity */
+constexpr std::uint16_t floatToHalf(float value)
+{
+    const auto bits{ std::bit_cast<std::uint32_t>(value) };
+    const std::uint32_t sign{ (bits >> 16U) & 0x8000U };
+    const std::uint32_t exponent{ (bits >> 23U) & 0xFFU };
+    std::uint32_t mantissa{ bits & 0x7FFFFFU };
+
+    if(exponent == 0xFFU)
+        return static_cast<std::uint16_t>(sign | 0x7C00U | (mantissa != 0 ? 0x200U : 0U));
+
+    const std::int32_t halfExponent{ static_cast<std::int32_t>(exponent) - 127 + 15 };
+    if(halfExponent >= 31)
+        return static_cast<std::uint16_t>(sign | 0x7C00U);
+
+    std::uint32_t shift{ 13 };
+    std::uint32_t half{ 0 };
+    if(halfExponent <= 0)
+    {
+        // NOTE: too small for a normal half, shift the mantissa including its implicit one into a subnormal
+        if(halfExponent < -10)
+            return static_cast<std::uint16_t>(sign);
+
+        mantissa |= 0x800000U;
+        shift = static_cast<std::uint32_t>(14 - halfExponent);
+    }
+    else
+    {
+        half = static_cast<std::uint32_t>(halfExponent) << 10U;
+    }
+
+    half |= mantissa >> shift;
+    const std::uint32_t remainder{ mantissa & ((1U << shift) - 1U) };
+    const std::uint32_t halfway{ 1U << (shift - 1U) };
+    // NOTE: a carry out of the mantissa correctly rounds up into the next exponent or infinity
+    if(remainder > halfway || (remainder == halfway && (half & 1U) != 0))
+        ++half;
+
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+constexpr float halfToFloat(std::uint16_t half)
+{
+    const std::uint32_t sign{ (static_cast<std::uint32_t>(half) & 0x8000U) << 16U };
+    const std::uint32_t exponent{ (static_cast<std::uint32_t>(half) >> 10U) & 0x1FU };
+    const std::uint32_t mantissa{ static_cast<std::uint32_t>(half) & 0x3FFU };
+
+    if(exponent == 0)
+    {
+        const float magnitude{ static_cast<float>(mantissa) * (1.f / 16777216.f) };
+        return sign != 0 ? -magnitude : magnitude;
+    }
+
+    if(exponent == 0x1FU)
+        return std::bit_cast<float>(sign | 0x7F800000U | (mantissa << 13U));
+
+    return std::bit_cast<float>(sign | ((exponent + 112U) << 23U) | (mantissa << 13U));
+}
+
+constexpr std::uint8_t packUnorm8(float value)
+{
+    return static_cast<std::uint8_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f);
+}
+
+constexpr std::int8_t packSnorm8(float value)
+{
+    const float scaled{ std::clamp(value, -1.f, 1.f) * 127.f };
+    return static_cast<std::int8_t>(scaled + (scaled >= 0.f ? 0.5f : -0.5f));
+}
+
+constexpr std::int16_t packSnorm16(float value)
+{
+    const float scaled{ std::clamp(value, -1.f, 1.f) * 32767.f };
+    return static_cast<std::int16_t>(scaled + (scaled >= 0.f ? 0.5f : -0.5f));
+}
+
+/** <code>(x, y, z)<\code> has to be normalized */
+[[nodiscard]] Octahedral16 encodeOctahedral(float x, float y, float z);
+[[nodiscard]] std::array<float, 3> decodeOctahedral(Octahedral16 encoded);
+
+/**
+ *  Half the size of <code>Vertex<\code>: positions as half floats (about three significant digits, fine for meshes
+ *  modeled around the origin) and colors as 8 bit unorm. Binds to the same shader inputs as <code>Vertex<\code>.
+*/
+struct PackedVertex
+{
+    Half4 position;
+    Unorm8x4 color;
+
+    [[nodiscard]] static PackedVertex pack(const Vertex& vertex);
+
+    static constexpr auto getBindingDescriptions()
+    {
+        return std::array{ vertexBinding<PackedVertex>(0) };
+    }
+
+    static constexpr auto getAttributeDescriptions()
+    {
+        return std::array{
+            vertexAttribute<Half4>(0, offsetof(PackedVertex, position)),
+            vertexAttribute<Unorm8x4>(1, offsetof(PackedVertex, color))
+        };
+    }
+};
+
+static_assert(sizeof(PackedVertex) * 2 == sizeof(Vertex));
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_PACKED_VERTEX_HPP
@@ -0,0 +1,37 @@
+#ifndef RRENDERER_ENGINE_MESH_VERTEX_HPP
+#define RRENDERER_ENGINE_MESH_VERTEX_HPP
+
+#include "mesh/VertexLayout.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/ext/vector_float3.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace rr
+{
+
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec3 color;
+
+    static constexpr auto getBindingDescriptions()
+    {
+        return std::array{ vertexBinding<Vertex>(0) };
+    }
+
+    static constexpr auto getAttributeDescriptions()
+    {
+        return std::array{
+            vertexAttribute<glm::vec3>(0, offsetof(Vertex, position)),
+            vertexAttribute<glm::vec3>(1, offsetof(Vertex, color))
+        };
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_VERTEX_HPP
@@ -0,0 +1,116 @@
+#ifndef RRENDERER_ENGINE_MESH_VERTEX_LAYOUT_HPP
+#define RRENDERER_ENGINE_MESH_VERTEX_LAYOUT_HPP
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/ext/vector_float2.hpp"
+#include "glm/ext/vector_float3.hpp"
+#include "glm/ext/vector_float4.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace rr
+{
+
+/**
+ *  Format an attribute of type <code>T<\code> is read with. Specialized for every type that may appear in a vertex,
+ *  using an attribute of any other type fails to compile.
+*/
+template<typename T>
+struct VertexFormat;
+
+template<> struct VertexFormat<float> { static constexpr VkFormat value{ VK_FORMAT_R32_SFLOAT }; };
+template<> struct VertexFormat<glm::vec2> { static constexpr VkFormat value{ VK_FORMAT_R32G32_SFLOAT }; };
+template<> struct VertexFormat<glm::vec3> { static constexpr VkFormat value{ VK_FORMAT_R32G32B32_SFLOAT }; };
+template<> struct VertexFormat<glm::vec4> { static constexpr VkFormat value{ VK_FORMAT_R32G32B32A32_SFLOAT }; };
+
+template<typename T>
+inline constexpr VkFormat VERTEX_FORMAT{ VertexFormat<T>::value };
+
+/** A vertex type describes its bindings and attributes with <code>static constexpr<\code> functions */
+template<typename V>
+concept VertexType = requires {
+    { V::getBindingDescriptions() } -> std::convertible_to<std::span<const VkVertexInputBindingDescription>>;
+    { V::getAttributeDescriptions() } -> std::convertible_to<std::span<const VkVertexInputAttributeDescription>>;
+};
+
+template<typename V>
+constexpr VkVertexInputBindingDescription vertexBinding(std::uint32_t binding, VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX)
+{
+    return { .binding = binding, .stride = sizeof(V), .inputRate = inputRate };
+}
+
+/** Vertex types whose attributes advance per instance declare a <code>static constexpr INPUT_RATE<\code> */
+template<typename V>
+constexpr VkVertexInputRate inputRateOf()
+{
+    if constexpr(requires { V::INPUT_RATE; })
+        return V::INPUT_RATE;
+    else
+        return VK_VERTEX_INPUT_RATE_VERTEX;
+}
+
+/** The format follows from the C++ type of the attribute, so it cannot disagree with the data that is uploaded */
+template<typename T>
+constexpr VkVertexInputAttributeDescription vertexAttribute(std::uint32_t location, std::size_t offset, std::uint32_t binding = 0)
+{
+    return { .location = location, .binding = binding, .format = VERTEX_FORMAT<T>, .offset = static_cast<std::uint32_t>(offset) };
+}
+
+/**
+ *  Descriptions of <code>V<\code> with static storage duration, e.g. for pointing a pipeline create info at them.
+ *  Evaluated at compile time, nothing is allocated when a pipeline is created.
+*/
+template<VertexType V>
+inline constexpr auto VERTEX_BINDING_DESCRIPTIONS{ V::getBindingDescriptions() };
+template<VertexType V>
+inline constexpr auto VERTEX_ATTRIBUTE_DESCRIPTIONS{ V::getAttributeDescriptions() };
+
+/**
+ *  Vertex layout made of several streams, each stream is a vertex type of its own that lives in a separate buffer.
+ *  Stream <code>i<\code> is bound to binding <code>i<\code>, attribute locations are kept as the streams declare
+ *  them. Splitting e.g. positions from everything else lets depth only passes fetch a fraction of the vertex data.
+ *  Streams keep their input rate, so per instance data is just another stream.
+*/
+template<VertexType... Streams>
+struct VertexStreams
+{
+    static constexpr std::size_t STREAM_COUNT{ sizeof...(Streams) };
+
+    static constexpr auto getBindingDescriptions()
+    {
+        std::array<VkVertexInputBindingDescription, STREAM_COUNT> result{};
+        std::uint32_t binding{ 0 };
+        ((result[binding] = vertexBinding<Streams>(binding, inputRateOf<Streams>()), ++binding), ...);
+
+        return result;
+    }
+
+    static constexpr auto getAttributeDescriptions()
+    {
+        std::array<VkVertexInputAttributeDescription, (Streams::getAttributeDescriptions().size() + ...)> result{};
+        std::size_t count{ 0 };
+        std::uint32_t binding{ 0 };
+        auto append{ [&result, &count, &binding](const auto& attributes) {
+            for(auto attribute : attributes)
+            {
+                attribute.binding = binding;
+                result[count++] = attribute;
+            }
+            ++binding;
+        } };
+        (append(Streams::getAttributeDescriptions()), ...);
+
+        return result;
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_MESH_VERTEX_LAYOUT_HPP
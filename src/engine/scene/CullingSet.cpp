@@ -0,0 +1,164 @@
+#include "CullingSet.hpp"
+
+#include "mesh/MeshData.hpp"
+#include "scene/Frustum.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define RR_CULLING_AVX
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define RR_CULLING_SSE2
+#endif
+
+namespace rr
+{
+
+namespace
+{
+
+/** The arrays are padded for the widest kernel, so switching kernels never changes the layout */
+constexpr std::size_t PADDING{ 8 };
+/** Padding spheres have a radius of minus infinity, which fails every plane test */
+constexpr float NEVER_VISIBLE_RADIUS{ -std::numeric_limits<float>::infinity() };
+
+constexpr std::size_t paddedSize(std::size_t count)
+{
+    return (count + PADDING - 1) / PADDING * PADDING;
+}
+
+/** Append the indices of the set bits of <code>mask<\code>, the output is sized for every object up front */
+inline std::uint32_t* appendVisible(std::uint32_t* out, std::uint32_t first, unsigned int mask)
+{
+    while(mask != 0)
+    {
+        *out++ = first + static_cast<std::uint32_t>(std::countr_zero(mask));
+        mask &= mask - 1;
+    }
+
+    return out;
+}
+
+} // !namespace
+
+#if defined(RR_CULLING_AVX)
+const std::uint32_t CullingSet::SIMD_WIDTH{ 8 };
+const std::string_view CullingSet::SIMD_NAME{ "AVX" };
+#elif defined(RR_CULLING_SSE2)
+const std::uint32_t CullingSet::SIMD_WIDTH{ 4 };
+const std::string_view CullingSet::SIMD_NAME{ "SSE2" };
+#else
+const std::uint32_t CullingSet::SIMD_WIDTH{ 1 };
+const std::string_view CullingSet::SIMD_NAME{ "scalar" };
+#endif
+
+std::uint32_t CullingSet::add(const MeshBounds& bounds, const glm::vec3& translation, float scale)
+{
+    const auto object{ static_cast<std::uint32_t>(m_localCenters.size()) };
+    m_localCenters.push_back(bounds.center);
+    m_localRadii.push_back(bounds.radius);
+
+    const std::size_t padded{ paddedSize(m_localCenters.size()) };
+    for(auto* const values : { &m_centerX, &m_centerY, &m_centerZ })
+        values->resize(padded, 0.f);
+    m_radius.resize(padded, NEVER_VISIBLE_RADIUS);
+
+    setTransform(object, translation, scale);
+
+    return object;
+}
+
+void CullingSet::setTransform(std::uint32_t object, const glm::vec3& translation, float scale)
+{
+    assert(object < m_localCenters.size() && "Object does not exist");
+
+    const auto& center{ m_localCenters[object] };
+    m_centerX[object] = center.x * scale + translation.x;
+    m_centerY[object] = center.y * scale + translation.y;
+    m_centerZ[object] = center.z * scale + translation.z;
+    m_radius[object] = m_localRadii[object] * scale;
+}
+
+void CullingSet::clear()
+{
+    for(auto* const values : { &m_centerX, &m_centerY, &m_centerZ, &m_radius })
+        values->clear();
+    m_localCenters.clear();
+    m_localRadii.clear();
+}
+
+/**
+ *  Every lane computes the signed distance of its sphere to all six planes, the lanes that stay inside of every plane
+ *  are compacted into <code>visible<\code> through the sign mask.
+*/
+void CullingSet::cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) const
+{
+    visible.resize(m_radius.size());
+    std::uint32_t* out{ visible.data() };
+
+    const float* const centerX{ m_centerX.data() };
+    const float* const centerY{ m_centerY.data() };
+    const float* const centerZ{ m_centerZ.data() };
+    const float* const radius{ m_radius.data() };
+
+#if defined(RR_CULLING_AVX)
+    for(std::size_t i{ 0 }; i < m_radius.size(); i += 8)
+    {
+        const __m256 x{ _mm256_loadu_ps(centerX + i) };
+        const __m256 y{ _mm256_loadu_ps(centerY + i) };
+        const __m256 z{ _mm256_loadu_ps(centerZ + i) };
+        const __m256 negativeRadius{ _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i)) };
+
+        __m256 inside{ _mm256_castsi256_ps(_mm256_set1_epi32(-1)) };
+        for(const auto& plane : frustum.planes)
+        {
+            // NOTE: same order of operations as Frustum::isSphereVisible(), so all kernels agree on spheres touching a plane
+            __m256 distance{ _mm256_mul_ps(x, _mm256_set1_ps(plane.x)) };
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(y, _mm256_set1_ps(plane.y)));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(z, _mm256_set1_ps(plane.z)));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+
+        out = appendVisible(out, static_cast<std::uint32_t>(i), static_cast<unsigned int>(_mm256_movemask_ps(inside)));
+    }
+#elif defined(RR_CULLING_SSE2)
+    for(std::size_t i{ 0 }; i < m_radius.size(); i += 4)
+    {
+        const __m128 x{ _mm_loadu_ps(centerX + i) };
+        const __m128 y{ _mm_loadu_ps(centerY + i) };
+        const __m128 z{ _mm_loadu_ps(centerZ + i) };
+        const __m128 negativeRadius{ _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i)) };
+
+        __m128 inside{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+        for(const auto& plane : frustum.planes)
+        {
+            __m128 distance{ _mm_mul_ps(x, _mm_set1_ps(plane.x)) };
+            distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+
+        out = appendVisible(out, static_cast<std::uint32_t>(i), static_cast<unsigned int>(_mm_movemask_ps(inside)));
+    }
+#else
+    for(std::size_t i{ 0 }; i < m_radius.size(); ++i)
+    {
+        if(frustum.isSphereVisible({ centerX[i], centerY[i], centerZ[i] }, radius[i]))
+            *out++ = static_cast<std::uint32_t>(i);
+    }
+#endif
+
+    visible.resize(static_cast<std::size_t>(out - visible.data()));
+}
+
+} // !rr
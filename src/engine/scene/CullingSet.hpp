@@ -0,0 +1,64 @@
+#ifndef RRENDERER_ENGINE_SCENE_CULLING_SET_HPP
+#define RRENDERER_ENGINE_SCENE_CULLING_SET_HPP
+
+#include "mesh/MeshData.hpp"
+#include "scene/Frustum.hpp"
+
+#include "glm/ext/vector_float3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>CullingSet<\code> keeps the world space bounding spheres of all objects of a scene in structure of arrays
+ *  layout and culls them against a frustum. Objects are identified by the index <code>add()<\code> returned.
+ *
+ *  The kernel tests <code>SIMD_WIDTH<\code> objects per instruction: 8 with AVX, 4 with SSE2 and 1 on other targets.
+ *  The arrays are padded to a multiple of the widest width with spheres that are never visible, so the kernel needs no
+ *  tail loop.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class CullingSet
+{
+public:
+    CullingSet() = default;
+    ~CullingSet() = default;
+
+    CullingSet(const CullingSet&) = delete;
+    CullingSet(CullingSet&&) = delete;
+    CullingSet& operator=(const CullingSet&) = delete;
+    CullingSet& operator=(CullingSet&&) = delete;
+
+    static const std::uint32_t SIMD_WIDTH;
+    static const std::string_view SIMD_NAME;
+
+    /** Add an object with the model space bounds of its mesh, translated and uniformly scaled into world space */
+    std::uint32_t add(const MeshBounds& bounds, const glm::vec3& translation = { 0.f, 0.f, 0.f }, float scale = 1.f);
+    void setTransform(std::uint32_t object, const glm::vec3& translation, float scale = 1.f);
+    void clear();
+
+    /** Replace <code>visible<\code> with the ascending indices of all objects that intersect the frustum */
+    void cull(const Frustum& frustum, std::vector<std::uint32_t>& visible) const;
+
+    [[nodiscard]] std::size_t size() const { return m_localCenters.size(); }
+
+private:
+    std::vector<glm::vec3> m_localCenters;
+    std::vector<float> m_localRadii;
+
+    std::vector<float> m_centerX;
+    std::vector<float> m_centerY;
+    std::vector<float> m_centerZ;
+    std::vector<float> m_radius;
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_SCENE_CULLING_SET_HPP
@@ -0,0 +1,47 @@
+#ifndef RRENDERER_ENGINE_SCENE_FRUSTUM_HPP
+#define RRENDERER_ENGINE_SCENE_FRUSTUM_HPP
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "glm/ext/vector_float3.hpp"
+#include "glm/ext/vector_float4.hpp"
+
+#include <array>
+
+namespace rr
+{
+
+/** Six planes as normal and distance, the normals point inside */
+struct Frustum
+{
+    std::array<glm::vec4, 6> planes;
+
+    /** View volume of Vulkan normalized device coordinates, for geometry that is drawn without a camera */
+    [[nodiscard]] static Frustum ndc()
+    {
+        return { .planes = { {
+            { 1.f, 0.f, 0.f, 1.f },
+            { -1.f, 0.f, 0.f, 1.f },
+            { 0.f, 1.f, 0.f, 1.f },
+            { 0.f, -1.f, 0.f, 1.f },
+            { 0.f, 0.f, 1.f, 0.f },
+            { 0.f, 0.f, -1.f, 1.f }
+        } } };
+    }
+
+    /** Conservative, spheres that only touch the frustum outside of a corner count as visible */
+    [[nodiscard]] bool isSphereVisible(const glm::vec3& center, float radius) const
+    {
+        for(const auto& plane : planes)
+        {
+            if(plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_SCENE_FRUSTUM_HPP
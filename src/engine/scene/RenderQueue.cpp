@@ -0,0 +1,88 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace rr
+{
+
+namespace
+{
+
+constexpr std::size_t DIGIT_BITS{ 8 };
+constexpr std::size_t DIGIT_COUNT{ 64 / DIGIT_BITS };
+constexpr std::size_t BUCKET_COUNT{ 1U << DIGIT_BITS };
+
+constexpr std::size_t digitOf(std::uint64_t key, std::size_t digit)
+{
+    return (key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1);
+}
+
+} // !namespace
+
+std::uint64_t SortKey::make(const DrawOrder& order, std::uint32_t pipeline, std::uint32_t mesh)
+{
+    assert(order.layer < MAX_LAYERS && "Layer does not fit into the sort key");
+    assert(pipeline < MAX_PIPELINES && "Pipeline does not fit into the sort key");
+    assert(mesh < MAX_MESHES && "Mesh does not fit into the sort key");
+
+    const std::uint64_t layer{ static_cast<std::uint64_t>(order.layer) << (64U - LAYER_BITS) };
+    const std::uint64_t depth{ quantizeDepth(order.depth) };
+    const std::uint64_t material{ order.material };
+
+    if(!order.translucent)
+        return layer | (std::uint64_t{ pipeline } << (MATERIAL_BITS + MESH_BITS + DEPTH_BITS)) | (material << (MESH_BITS + DEPTH_BITS)) | (std::uint64_t{ mesh } << DEPTH_BITS) | depth;
+
+    const std::uint64_t farFirst{ (1U << DEPTH_BITS) - 1 - depth };
+    return layer | (std::uint64_t{ 1 } << (63U - LAYER_BITS)) | (farFirst << (PIPELINE_BITS + MATERIAL_BITS + MESH_BITS)) | (std::uint64_t{ pipeline } << (MATERIAL_BITS + MESH_BITS)) | (material << MESH_BITS) | mesh;
+}
+
+std::uint32_t SortKey::quantizeDepth(float depth)
+{
+    // NOTE: NaN compares false against everything, so it ends up in front like depth 0
+    const float clamped{ depth > 0.f ? std::min(depth, 1.f) : 0.f };
+
+    return static_cast<std::uint32_t>(std::lround(clamped * static_cast<float>((1U << DEPTH_BITS) - 1)));
+}
+
+void RenderQueue::sort()
+{
+    if(m_items.size() < 2)
+        return;
+
+    std::array<std::array<std::size_t, BUCKET_COUNT>, DIGIT_COUNT> histograms{};
+    for(const auto& item : m_items)
+    {
+        for(std::size_t digit{ 0 }; digit < DIGIT_COUNT; ++digit)
+            ++histograms[digit][digitOf(item.key, digit)];
+    }
+
+    m_scratch.resize(m_items.size());
+    for(std::size_t digit{ 0 }; digit < DIGIT_COUNT; ++digit)
+    {
+        auto& histogram{ histograms[digit] };
+
+        // NOTE: a single bucket holding every item means the pass would not move anything
+        if(histogram[digitOf(m_items.front().key, digit)] == m_items.size())
+            continue;
+
+        std::size_t offset{ 0 };
+        for(auto& count : histogram)
+        {
+            const std::size_t bucketSize{ count };
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for(const auto& item : m_items)
+            m_scratch[histogram[digitOf(item.key, digit)]++] = item;
+
+        m_items.swap(m_scratch);
+    }
+}
+
+} // !rr
@@ -0,0 +1,100 @@
+#ifndef RRENDERER_ENGINE_SCENE_RENDER_QUEUE_HPP
+#define RRENDERER_ENGINE_SCENE_RENDER_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Where a draw goes in the frame, independent of the state it binds. Lower layers are drawn first, translucent draws
+ *  after all opaque draws of their layer. <code>depth<\code> is the view depth in [0, 1].
+*/
+struct DrawOrder
+{
+    std::uint8_t layer{ 0 };
+    bool translucent{ false };
+    std::uint16_t material{ 0 };
+    float depth{ 0.f };
+};
+
+/**
+ *  Packs a draw into 64 bits, so that ascending keys are the order draws should be recorded in:
+ *
+ *  <pre>
+ *  opaque:      layer:4 | 0 | pipeline:11 | material:16 | mesh:16     | depth:16
+ *  translucent: layer:4 | 1 | ~depth:16   | pipeline:11 | material:16 | mesh:16
+ *  </pre>
+ *
+ *  Opaque draws are grouped by state first and sorted front to back inside a group. Translucent draws have to blend
+ *  back to front, so their inverted depth takes precedence over any state.
+*/
+struct SortKey
+{
+    static constexpr std::uint32_t LAYER_BITS{ 4 };
+    static constexpr std::uint32_t PIPELINE_BITS{ 11 };
+    static constexpr std::uint32_t MATERIAL_BITS{ 16 };
+    static constexpr std::uint32_t MESH_BITS{ 16 };
+    static constexpr std::uint32_t DEPTH_BITS{ 16 };
+
+    static constexpr std::uint32_t MAX_LAYERS{ 1U << LAYER_BITS };
+    static constexpr std::uint32_t MAX_PIPELINES{ 1U << PIPELINE_BITS };
+    static constexpr std::uint32_t MAX_MESHES{ 1U << MESH_BITS };
+
+    [[nodiscard]] static std::uint64_t make(const DrawOrder& order, std::uint32_t pipeline, std::uint32_t mesh);
+    /** Map a depth in [0, 1] to <code>DEPTH_BITS<\code>, values outside are clamped */
+    [[nodiscard]] static std::uint32_t quantizeDepth(float depth);
+
+    [[nodiscard]] static std::uint32_t layerOf(std::uint64_t key) { return static_cast<std::uint32_t>(key >> (64U - LAYER_BITS)); }
+    [[nodiscard]] static bool isTranslucent(std::uint64_t key) { return ((key >> (63U - LAYER_BITS)) & 1U) != 0; }
+};
+
+/**
+ *  <code>RenderQueue<\code> collects the sort keys of the draws of a frame together with an index into whatever the
+ *  caller keeps per draw, and sorts them with a least significant digit radix sort over bytes. The sort is stable, so
+ *  draws with equal keys keep the order they were pushed in.
+ *
+ *  Keys and indices are moved together in a single array, every pass streams through it once and scatters into a
+ *  second one. The histograms of all digits are built in one pass up front, digits that are the same for every key
+ *  skip their pass entirely, which is common for the layer and translucency bits.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class RenderQueue
+{
+public:
+    struct Item
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    RenderQueue() = default;
+    ~RenderQueue() = default;
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue(RenderQueue&&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+    RenderQueue& operator=(RenderQueue&&) = delete;
+
+    void push(std::uint64_t key, std::uint32_t index) { m_items.push_back({ .key = key, .index = index }); }
+    void sort();
+    /** Forget all items but keep the memory for the next frame */
+    void clear() { m_items.clear(); }
+
+    [[nodiscard]] std::span<const Item> items() const { return m_items; }
+    [[nodiscard]] std::size_t size() const { return m_items.size(); }
+    [[nodiscard]] bool empty() const { return m_items.empty(); }
+
+private:
+    std::vector<Item> m_items;
+    std::vector<Item> m_scratch;
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_SCENE_RENDER_QUEUE_HPP
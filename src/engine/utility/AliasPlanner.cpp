@@ -0,0 +1,66 @@
+#include "AliasPlanner.hpp"
+
+#include "utility/FreeListAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Compute the offsets of all <code>resources<\code> inside a shared allocation.
+ *
+ *  @returns AliasPlan - offsets per resource plus size and alignment the shared allocation needs
+*/
+AliasPlan AliasPlanner::plan(const std::vector<AliasedResource>& resources)
+{
+    AliasPlan result{
+        .offsets = std::vector<std::uint64_t>(resources.size(), 0),
+        .size = 0,
+        .alignment = 1
+    };
+
+    std::vector<std::size_t> order(resources.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&resources](std::size_t lhs, std::size_t rhs) { return resources[lhs].size > resources[rhs].size; });
+
+    std::vector<std::size_t> placed;
+    placed.reserve(resources.size());
+
+    for(const std::size_t index : order)
+    {
+        const auto& resource{ resources[index] };
+        result.alignment = std::max(result.alignment, resource.alignment);
+
+        std::vector<std::size_t> conflicts;
+        for(const std::size_t other : placed)
+        {
+            if(resource.overlaps(resources[other]))
+                conflicts.push_back(other);
+        }
+        std::ranges::sort(conflicts, {}, [&result](std::size_t other) { return result.offsets[other]; });
+
+        // NOTE: walk the gaps between the conflicting resources in order of their offset
+        std::uint64_t offset{ 0 };
+        for(const std::size_t other : conflicts)
+        {
+            const std::uint64_t candidate{ FreeListAllocator::alignUp(offset, resource.alignment) };
+            if(candidate + resource.size <= result.offsets[other])
+                break;
+
+            offset = std::max(offset, result.offsets[other] + resources[other].size);
+        }
+
+        result.offsets[index] = FreeListAllocator::alignUp(offset, resource.alignment);
+        result.size = std::max(result.size, result.offsets[index] + resource.size);
+        placed.push_back(index);
+    }
+
+    return result;
+}
+
+} // !rr
@@ -0,0 +1,48 @@
+#ifndef RRENDERER_ENGINE_UTILITY_ALIAS_PLANNER_HPP
+#define RRENDERER_ENGINE_UTILITY_ALIAS_PLANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  A resource that only has to live from pass <code>firstUse<\code> to pass <code>lastUse<\code> (inclusive).
+*/
+struct AliasedResource
+{
+    std::uint64_t size{ 0 };
+    std::uint64_t alignment{ 1 };
+    std::uint32_t firstUse{ 0 };
+    std::uint32_t lastUse{ 0 };
+
+    [[nodiscard]] bool overlaps(const AliasedResource& other) const { return firstUse <= other.lastUse && other.firstUse <= lastUse; }
+};
+
+struct AliasPlan
+{
+    /** Offset of every resource inside the shared memory, same order as the input */
+    std::vector<std::uint64_t> offsets;
+    std::uint64_t size{ 0 };
+    std::uint64_t alignment{ 1 };
+};
+
+/**
+ *  <code>AliasPlanner<\code> places resources in one shared piece of memory so that resources whose lifetimes do
+ *  not overlap can use the same bytes. The biggest resources are placed first, each at the lowest offset that does
+ *  not collide with an already placed resource that is alive at the same time.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class AliasPlanner
+{
+public:
+    [[nodiscard]] static AliasPlan plan(const std::vector<AliasedResource>& resources);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_ALIAS_PLANNER_HPP
@@ -0,0 +1,126 @@
+#include "FreeListAllocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+
+namespace rr
+{
+
+FreeListAllocator::FreeListAllocator(std::uint64_t size)
+    : m_size(size)
+{
+    if(size > 0)
+        m_freeRanges.emplace(0, size);
+}
+
+/**
+ *  Find the smallest free range that can hold <code>size<\code> bytes at the requested alignment (best fit).
+ *
+ *  @param size - amount of bytes that are needed
+ *  @param alignment - required alignment of the returned offset
+ *  @returns the offset of the allocation or an empty optional if no free range is big enough
+*/
+std::optional<std::uint64_t> FreeListAllocator::allocate(std::uint64_t size, std::uint64_t alignment)
+{
+    if(size == 0)
+        return std::nullopt;
+
+    auto best{ m_freeRanges.end() };
+    std::uint64_t bestWaste{ std::numeric_limits<std::uint64_t>::max() };
+
+    for(auto it{ m_freeRanges.begin() }; it != m_freeRanges.end(); ++it)
+    {
+        const auto [rangeOffset, rangeSize]{ *it };
+        const std::uint64_t alignedOffset{ alignUp(rangeOffset, alignment) };
+        const std::uint64_t padding{ alignedOffset - rangeOffset };
+
+        if(padding + size > rangeSize)
+            continue;
+
+        const std::uint64_t waste{ rangeSize - size };
+        if(waste < bestWaste)
+        {
+            best = it;
+            bestWaste = waste;
+
+            if(waste == 0)
+                break;
+        }
+    }
+
+    if(best == m_freeRanges.end())
+        return std::nullopt;
+
+    const auto [rangeOffset, rangeSize]{ *best };
+    m_freeRanges.erase(best);
+
+    const std::uint64_t alignedOffset{ alignUp(rangeOffset, alignment) };
+    const std::uint64_t padding{ alignedOffset - rangeOffset };
+
+    if(padding > 0)
+        m_freeRanges.emplace(rangeOffset, padding);
+
+    const std::uint64_t tail{ rangeSize - padding - size };
+    if(tail > 0)
+        m_freeRanges.emplace(alignedOffset + size, tail);
+
+    m_allocations.emplace(alignedOffset, size);
+    m_usedSize += size;
+
+    return alignedOffset;
+}
+
+/**
+ *  Release the allocation that starts at <code>offset<\code> and merge it with adjacent free ranges.
+*/
+void FreeListAllocator::free(std::uint64_t offset)
+{
+    auto allocation{ m_allocations.find(offset) };
+    assert(allocation != m_allocations.end() && "Trying to free an offset that was never allocated");
+    if(allocation == m_allocations.end())
+        return;
+
+    const std::uint64_t size{ allocation->second };
+    m_allocations.erase(allocation);
+    m_usedSize -= size;
+
+    insertFreeRange(offset, size);
+}
+
+std::uint64_t FreeListAllocator::largestFreeRange() const
+{
+    std::uint64_t largest{ 0 };
+    for(const auto& [offset, size] : m_freeRanges)
+        largest = std::max(largest, size);
+
+    return largest;
+}
+
+void FreeListAllocator::insertFreeRange(std::uint64_t offset, std::uint64_t size)
+{
+    auto next{ m_freeRanges.lower_bound(offset) };
+
+    if(next != m_freeRanges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = m_freeRanges.erase(next);
+    }
+
+    if(next != m_freeRanges.begin())
+    {
+        auto previous{ std::prev(next) };
+        if(previous->first + previous->second == offset)
+        {
+            previous->second += size;
+            return;
+        }
+    }
+
+    m_freeRanges.emplace_hint(next, offset, size);
+}
+
+} // !rr
@@ -0,0 +1,60 @@
+#ifndef RRENDERER_ENGINE_UTILITY_FREE_LIST_ALLOCATOR_HPP
+#define RRENDERER_ENGINE_UTILITY_FREE_LIST_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+namespace rr
+{
+
+/**
+ *  <code>FreeListAllocator<\code> manages offsets inside a fixed size range. It does not own any memory itself, it
+ *  only decides where inside the range a sub-allocation lives. Free ranges are kept sorted by offset so that
+ *  neighbouring ranges can be merged again when an allocation is released.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class FreeListAllocator
+{
+public:
+    explicit FreeListAllocator(std::uint64_t size);
+    ~FreeListAllocator() = default;
+
+    FreeListAllocator(const FreeListAllocator&) = delete;
+    FreeListAllocator(FreeListAllocator&&) = default;
+    FreeListAllocator& operator=(const FreeListAllocator&) = delete;
+    FreeListAllocator& operator=(FreeListAllocator&&) = default;
+
+    [[nodiscard]] std::optional<std::uint64_t> allocate(std::uint64_t size, std::uint64_t alignment);
+    void free(std::uint64_t offset);
+
+    [[nodiscard]] std::uint64_t size() const { return m_size; }
+    [[nodiscard]] std::uint64_t usedSize() const { return m_usedSize; }
+    [[nodiscard]] std::uint64_t largestFreeRange() const;
+    [[nodiscard]] std::size_t allocationCount() const { return m_allocations.size(); }
+    [[nodiscard]] std::size_t freeRangeCount() const { return m_freeRanges.size(); }
+    [[nodiscard]] bool empty() const { return m_allocations.empty(); }
+
+    static constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+    {
+        return alignment <= 1 ? value : (value + alignment - 1) / alignment * alignment;
+    }
+
+private:
+    std::uint64_t m_size;
+    std::uint64_t m_usedSize{ 0 };
+
+    /** offset -> size */
+    std::map<std::uint64_t, std::uint64_t> m_freeRanges;
+    std::unordered_map<std::uint64_t, std::uint64_t> m_allocations;
+
+    void insertFreeRange(std::uint64_t offset, std::uint64_t size);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_FREE_LIST_ALLOCATOR_HPP
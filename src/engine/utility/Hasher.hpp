@@ -0,0 +1,51 @@
+#ifndef RRENDERER_ENGINE_UTILITY_HASHER_HPP
+#define RRENDERER_ENGINE_UTILITY_HASHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace rr
+{
+
+/**
+ *  <code>Hasher<\code> folds the bytes of any number of values into a single 64 bit FNV-1a hash. Values are hashed by
+ *  their object representation, so types with padding bytes must not be added.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class Hasher
+{
+public:
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    Hasher& add(const T& value)
+    {
+        return addBytes(std::as_bytes(std::span{ &value, 1 }));
+    }
+
+    Hasher& addBytes(std::span<const std::byte> bytes)
+    {
+        for(const std::byte byte : bytes)
+        {
+            m_state ^= static_cast<std::uint64_t>(byte);
+            m_state *= PRIME;
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] constexpr std::uint64_t value() const { return m_state; }
+
+private:
+    static constexpr std::uint64_t OFFSET_BASIS{ 14695981039346656037ULL };
+    static constexpr std::uint64_t PRIME{ 1099511628211ULL };
+
+    std::uint64_t m_state{ OFFSET_BASIS };
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_HASHER_HPP
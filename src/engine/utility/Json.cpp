@@ -0,0 +1,329 @@
+#include "Json.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace rr
+{
+
+namespace
+{
+
+/** Nesting depth after which a document is rejected so malicious input cannot overflow the stack */
+constexpr std::size_t MAX_DEPTH{ 256 };
+
+class Parser
+{
+public:
+    explicit Parser(std::string_view text) : m_text(text) {}
+
+    std::optional<JsonValue> parseDocument()
+    {
+        auto value{ parseValue(0) };
+        skipWhitespace();
+
+        if(!value || m_position != m_text.size())
+            return std::nullopt;
+
+        return value;
+    }
+
+private:
+    std::string_view m_text;
+    std::size_t m_position{ 0 };
+
+    [[nodiscard]] bool atEnd() const { return m_position >= m_text.size(); }
+    [[nodiscard]] char peek() const { return atEnd() ? '\0' : m_text[m_position]; }
+
+    void skipWhitespace()
+    {
+        while(!atEnd() && (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r'))
+            ++m_position;
+    }
+
+    bool consume(char expected)
+    {
+        skipWhitespace();
+        if(peek() != expected)
+            return false;
+
+        ++m_position;
+        return true;
+    }
+
+    bool consumeLiteral(std::string_view literal)
+    {
+        if(!m_text.substr(m_position).starts_with(literal))
+            return false;
+
+        m_position += literal.size();
+        return true;
+    }
+
+    std::optional<JsonValue> parseValue(std::size_t depth)
+    {
+        if(depth > MAX_DEPTH)
+            return std::nullopt;
+
+        skipWhitespace();
+        switch(peek())
+        {
+            case '{': return parseObject(depth);
+            case '[': return parseArray(depth);
+            case '"':
+            {
+                auto string{ parseString() };
+                return string ? std::optional{ JsonValue{ std::move(*string) } } : std::nullopt;
+            }
+            case 't': return consumeLiteral("true") ? std::optional{ JsonValue{ true } } : std::nullopt;
+            case 'f': return consumeLiteral("false") ? std::optional{ JsonValue{ false } } : std::nullopt;
+            case 'n': return consumeLiteral("null") ? std::optional{ JsonValue{} } : std::nullopt;
+            default: return parseNumber();
+        }
+    }
+
+    std::optional<JsonValue> parseObject(std::size_t depth)
+    {
+        ++m_position;
+        JsonValue::Object members;
+
+        if(consume('}'))
+            return JsonValue{ std::move(members) };
+
+        do
+        {
+            skipWhitespace();
+            auto key{ parseString() };
+            if(!key || !consume(':'))
+                return std::nullopt;
+
+            auto value{ parseValue(depth + 1) };
+            if(!value)
+                return std::nullopt;
+
+            members.emplace_back(std::move(*key), std::move(*value));
+        } while(consume(','));
+
+        if(!consume('}'))
+            return std::nullopt;
+
+        return JsonValue{ std::move(members) };
+    }
+
+    std::optional<JsonValue> parseArray(std::size_t depth)
+    {
+        ++m_position;
+        JsonValue::Array elements;
+
+        if(consume(']'))
+            return JsonValue{ std::move(elements) };
+
+        do
+        {
+            auto value{ parseValue(depth + 1) };
+            if(!value)
+                return std::nullopt;
+
+            elements.push_back(std::move(*value));
+        } while(consume(','));
+
+        if(!consume(']'))
+            return std::nullopt;
+
+        return JsonValue{ std::move(elements) };
+    }
+
+    std::optional<JsonValue> parseNumber()
+    {
+        // NOTE: from_chars does not accept a leading '+', neither does JSON
+        double value{ 0.0 };
+        const char* begin{ m_text.data() + m_position };
+        const auto [end, error]{ std::from_chars(begin, m_text.data() + m_text.size(), value) };
+        if(error != std::errc{} || end == begin)
+            return std::nullopt;
+
+        m_position += static_cast<std::size_t>(end - begin);
+        return JsonValue{ value };
+    }
+
+    std::optional<std::uint32_t> parseHex4()
+    {
+        if(m_text.size() - m_position < 4)
+            return std::nullopt;
+
+        std::uint32_t value{ 0 };
+        const char* begin{ m_text.data() + m_position };
+        const auto [end, error]{ std::from_chars(begin, begin + 4, value, 16) };
+        if(error != std::errc{} || end != begin + 4)
+            return std::nullopt;
+
+        m_position += 4;
+        return value;
+    }
+
+    static void appendUtf8(std::string& out, std::uint32_t codepoint)
+    {
+        if(codepoint < 0x80)
+        {
+            out.push_back(static_cast<char>(codepoint));
+        }
+        else if(codepoint < 0x800)
+        {
+            out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        }
+        else if(codepoint < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+        }
+    }
+
+    std::optional<std::string> parseString()
+    {
+        if(peek() != '"')
+            return std::nullopt;
+        ++m_position;
+
+        std::string result;
+        while(!atEnd())
+        {
+            const char c{ m_text[m_position++] };
+            if(c == '"')
+                return result;
+            if(c != '\\')
+            {
+                result.push_back(c);
+                continue;
+            }
+
+            if(atEnd())
+                return std::nullopt;
+
+            switch(m_text[m_position++])
+            {
+                case '"': result.push_back('"'); break;
+                case '\\': result.push_back('\\'); break;
+                case '/': result.push_back('/'); break;
+                case 'b': result.push_back('\b'); break;
+                case 'f': result.push_back('\f'); break;
+                case 'n': result.push_back('\n'); break;
+                case 'r': result.push_back('\r'); break;
+                case 't': result.push_back('\t'); break;
+                case 'u':
+                {
+                    auto codepoint{ parseHex4() };
+                    if(!codepoint)
+                        return std::nullopt;
+
+                    // NOTE: characters outside of the BMP are escaped as UTF-16 surrogate pairs
+                    if(*codepoint >= 0xD800 && *codepoint < 0xDC00 && consumeLiteral("\\u"))
+                    {
+                        auto low{ parseHex4() };
+                        if(!low || *low < 0xDC00 || *low >= 0xE000)
+                            return std::nullopt;
+
+                        *codepoint = 0x10000 + ((*codepoint - 0xD800) << 10) + (*low - 0xDC00);
+                    }
+
+                    appendUtf8(result, *codepoint);
+                    break;
+                }
+                default: return std::nullopt;
+            }
+        }
+
+        return std::nullopt;
+    }
+};
+
+} // !namespace
+
+const JsonValue* JsonValue::find(std::string_view key) const
+{
+    if(!isObject())
+        return nullptr;
+
+    for(const auto& [name, value] : std::get<Object>(m_value))
+    {
+        if(name == key)
+            return &value;
+    }
+
+    return nullptr;
+}
+
+std::size_t JsonValue::size() const
+{
+    if(isArray())
+        return std::get<Array>(m_value).size();
+    if(isObject())
+        return std::get<Object>(m_value).size();
+
+    return 0;
+}
+
+const JsonValue* JsonValue::at(std::size_t index) const
+{
+    if(!isArray() || index >= std::get<Array>(m_value).size())
+        return nullptr;
+
+    return &std::get<Array>(m_value)[index];
+}
+
+bool JsonValue::asBool(bool fallback) const
+{
+    return isBool() ? std::get<bool>(m_value) : fallback;
+}
+
+double JsonValue::asNumber(double fallback) const
+{
+    return isNumber() ? std::get<double>(m_value) : fallback;
+}
+
+std::string_view JsonValue::asString() const
+{
+    return isString() ? std::string_view{ std::get<std::string>(m_value) } : std::string_view{};
+}
+
+const JsonValue::Array& JsonValue::asArray() const
+{
+    static const Array empty;
+
+    return isArray() ? std::get<Array>(m_value) : empty;
+}
+
+const JsonValue::Object& JsonValue::asObject() const
+{
+    static const Object empty;
+
+    return isObject() ? std::get<Object>(m_value) : empty;
+}
+
+double JsonValue::getNumber(std::string_view key, double fallback) const
+{
+    const auto* value{ find(key) };
+
+    return value != nullptr ? value->asNumber(fallback) : fallback;
+}
+
+std::optional<JsonValue> Json::parse(std::string_view text)
+{
+    return Parser{ text }.parseDocument();
+}
+
+} // !rr
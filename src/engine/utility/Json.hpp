@@ -0,0 +1,75 @@
+#ifndef RRENDERER_ENGINE_UTILITY_JSON_HPP
+#define RRENDERER_ENGINE_UTILITY_JSON_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  Parsed JSON value. Objects keep their members in document order, lookups are linear which is fine for the
+ *  small objects found in asset descriptions.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class JsonValue
+{
+public:
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+    explicit JsonValue(bool value) : m_value(value) {}
+    explicit JsonValue(double value) : m_value(value) {}
+    explicit JsonValue(std::string value) : m_value(std::move(value)) {}
+    explicit JsonValue(Array value) : m_value(std::move(value)) {}
+    explicit JsonValue(Object value) : m_value(std::move(value)) {}
+
+    [[nodiscard]] bool isNull() const { return std::holds_alternative<std::nullptr_t>(m_value); }
+    [[nodiscard]] bool isBool() const { return std::holds_alternative<bool>(m_value); }
+    [[nodiscard]] bool isNumber() const { return std::holds_alternative<double>(m_value); }
+    [[nodiscard]] bool isString() const { return std::holds_alternative<std::string>(m_value); }
+    [[nodiscard]] bool isArray() const { return std::holds_alternative<Array>(m_value); }
+    [[nodiscard]] bool isObject() const { return std::holds_alternative<Object>(m_value); }
+
+    /** Value of the member <code>key<\code>, nullptr if this is not an object or has no such member */
+    [[nodiscard]] const JsonValue* find(std::string_view key) const;
+
+    /** Number of elements of an array or members of an object, 0 for everything else */
+    [[nodiscard]] std::size_t size() const;
+    /** Element <code>index<\code> of an array, nullptr if out of range or not an array */
+    [[nodiscard]] const JsonValue* at(std::size_t index) const;
+
+    [[nodiscard]] bool asBool(bool fallback = false) const;
+    [[nodiscard]] double asNumber(double fallback = 0.0) const;
+    [[nodiscard]] std::string_view asString() const;
+    [[nodiscard]] const Array& asArray() const;
+    [[nodiscard]] const Object& asObject() const;
+
+    /** Shorthand for looking up a number member, <code>fallback<\code> if it is missing */
+    [[nodiscard]] double getNumber(std::string_view key, double fallback) const;
+
+private:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> m_value{ nullptr };
+};
+
+/**
+ *  Minimal RFC 8259 parser, enough for glTF documents. Returns std::nullopt for malformed input instead of
+ *  throwing so callers can report errors with their own context.
+*/
+class Json
+{
+public:
+    [[nodiscard]] static std::optional<JsonValue> parse(std::string_view text);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_JSON_HPP
@@ -0,0 +1,92 @@
+#ifndef RRENDERER_ENGINE_UTILITY_LRU_TRACKER_HPP
+#define RRENDERER_ENGINE_UTILITY_LRU_TRACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace rr
+{
+
+/**
+ *  <code>LruTracker<\code> remembers when resources were used last so that the least recently used ones can be
+ *  released first under memory pressure. It does not own the resources, owners <code>touch()<\code> them when they
+ *  are used and decide in the eviction callback whether a resource can actually be released.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+template<typename Key>
+class LruTracker
+{
+public:
+    /** Mark <code>key<\code> as used right now */
+    void touch(const Key& key, std::uint64_t size)
+    {
+        if(auto it{ m_lookup.find(key) }; it != m_lookup.end())
+        {
+            m_totalBytes -= it->second->second;
+            m_entries.erase(it->second);
+        }
+
+        m_entries.emplace_front(key, size);
+        m_lookup[key] = m_entries.begin();
+        m_totalBytes += size;
+    }
+
+    void remove(const Key& key)
+    {
+        auto it{ m_lookup.find(key) };
+        if(it == m_lookup.end())
+            return;
+
+        m_totalBytes -= it->second->second;
+        m_entries.erase(it->second);
+        m_lookup.erase(it);
+    }
+
+    /**
+     *  Walk the entries from least to most recently used and hand them to <code>evict<\code> until
+     *  <code>bytes<\code> were released. Entries for which <code>evict<\code> returns false stay tracked.
+     *
+     *  @returns std::uint64_t - amount of bytes that were released
+    */
+    template<typename Evict>
+    std::uint64_t evict(std::uint64_t bytes, Evict&& evict)
+    {
+        std::uint64_t released{ 0 };
+
+        for(auto it{ m_entries.rbegin() }; it != m_entries.rend() && released < bytes;)
+        {
+            if(!evict(std::as_const(it->first)))
+            {
+                ++it;
+                continue;
+            }
+
+            released += it->second;
+            m_totalBytes -= it->second;
+            m_lookup.erase(it->first);
+            it = std::make_reverse_iterator(m_entries.erase(std::next(it).base()));
+        }
+
+        return released;
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const { return m_lookup.contains(key); }
+    [[nodiscard]] std::size_t size() const { return m_entries.size(); }
+    [[nodiscard]] std::uint64_t totalBytes() const { return m_totalBytes; }
+
+private:
+    /** Most recently used entry first */
+    std::list<std::pair<Key, std::uint64_t>> m_entries;
+    std::unordered_map<Key, typename std::list<std::pair<Key, std::uint64_t>>::iterator> m_lookup;
+    std::uint64_t m_totalBytes{ 0 };
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_LRU_TRACKER_HPP
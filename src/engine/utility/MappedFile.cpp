@@ -0,0 +1,111 @@
+#include "MappedFile.hpp"
+
+#include "exception/EngineException.hpp"
+#include "exception/FileIOException.hpp"
+
+#include <source_location>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <filesystem>
+
+namespace rr
+{
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file = nullptr;
+        throwWithLog<FileIOException>(std::source_location::current(), path.string());
+    }
+
+    LARGE_INTEGER size{};
+    if(GetFileSizeEx(m_file, &size) == 0)
+    {
+        CloseHandle(m_file);
+        throwWithLog<FileIOException>(std::source_location::current(), path.string());
+    }
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if(m_size == 0)
+        return;
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view{ m_mapping != nullptr ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr };
+    if(view == nullptr)
+    {
+        if(m_mapping != nullptr)
+            CloseHandle(m_mapping);
+        CloseHandle(m_file);
+        throwWithLog<FileIOException>(std::source_location::current(), path.string());
+    }
+
+    m_data = static_cast<const std::byte*>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if(m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if(m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if(m_file != nullptr)
+        CloseHandle(m_file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+    : m_file(open(path.c_str(), O_RDONLY | O_CLOEXEC)) // NOLINT
+{
+    struct stat status{};
+    if(m_file < 0 || fstat(m_file, &status) != 0)
+    {
+        if(m_file >= 0)
+            close(m_file);
+        throwWithLog<FileIOException>(std::source_location::current(), path.string());
+    }
+
+    m_size = static_cast<std::size_t>(status.st_size);
+    if(m_size == 0)
+        return;
+
+    void* mapping{ mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0) };
+    if(mapping == MAP_FAILED)
+    {
+        close(m_file);
+        throwWithLog<FileIOException>(std::source_location::current(), path.string());
+    }
+
+    // NOTE: files are read front to back, let the kernel read ahead aggressively
+    madvise(mapping, m_size, MADV_SEQUENTIAL);
+    madvise(mapping, m_size, MADV_WILLNEED);
+
+    m_data = static_cast<const std::byte*>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+    if(m_data != nullptr)
+        munmap(const_cast<std::byte*>(m_data), m_size); // NOLINT
+    if(m_file >= 0)
+        close(m_file);
+}
+
+#endif
+
+} // !rr
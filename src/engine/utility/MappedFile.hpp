@@ -0,0 +1,45 @@
+#ifndef RRENDERER_ENGINE_UTILITY_MAPPED_FILE_HPP
+#define RRENDERER_ENGINE_UTILITY_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace rr
+{
+
+/**
+ *  Read only memory mapping of a whole file. Pages are only read from disk when they are first touched, so opening
+ *  a file is cheap regardless of its size and no copy of the contents is made in user space.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> getData() const { return { m_data, m_size }; }
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+private:
+    const std::byte* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+#ifdef _WIN32
+    void* m_file{ nullptr };
+    void* m_mapping{ nullptr };
+#else
+    int m_file{ -1 };
+#endif
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_MAPPED_FILE_HPP
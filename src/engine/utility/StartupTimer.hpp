@@ -0,0 +1,52 @@
+#ifndef RRENDERER_ENGINE_UTILITY_STARTUP_TIMER_HPP
+#define RRENDERER_ENGINE_UTILITY_STARTUP_TIMER_HPP
+
+#include <chrono>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>StartupTimer<\code> records how long each stage of an initialization took. Stages are measured by wrapping
+ *  their creation in <code>measure()<\code>, which also works inside of member initializer lists.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class StartupTimer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage
+    {
+        std::string_view name;
+        Clock::duration duration;
+    };
+
+    /** Run <code>create<\code>, record its duration as <code>stage<\code> and pass its result through */
+    template<typename Create>
+    auto measure(std::string_view stage, Create&& create)
+    {
+        const auto start{ Clock::now() };
+        auto result{ std::forward<Create>(create)() };
+        m_stages.push_back({ .name = stage, .duration = Clock::now() - start });
+
+        return result;
+    }
+
+    [[nodiscard]] const std::vector<Stage>& getStages() const { return m_stages; }
+    /** Time since the timer was created, including everything that was not measured as a stage */
+    [[nodiscard]] Clock::duration elapsed() const { return Clock::now() - m_start; }
+
+private:
+    Clock::time_point m_start{ Clock::now() };
+    std::vector<Stage> m_stages;
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_STARTUP_TIMER_HPP
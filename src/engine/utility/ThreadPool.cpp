@@ -0,0 +1,60 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace rr
+{
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+    m_workers.reserve(std::max<std::size_t>(threadCount, 1));
+    for(std::size_t i{ 0 }; i < std::max<std::size_t>(threadCount, 1); ++i)
+        m_workers.emplace_back([this](const std::stop_token& stopToken) { workerLoop(stopToken); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    for(auto& worker : m_workers)
+        worker.request_stop();
+
+    m_condition.notify_all();
+}
+
+std::size_t ThreadPool::defaultThreadCount()
+{
+    const std::size_t hardwareThreads{ std::thread::hardware_concurrency() };
+
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+}
+
+/**
+ *  Run tasks until the pool is stopped. Tasks that are still queued on shutdown are finished first.
+*/
+void ThreadPool::workerLoop(const std::stop_token& stopToken)
+{
+    while(true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock{ m_mutex };
+            m_condition.wait(lock, stopToken, [this] { return !m_tasks.empty(); });
+
+            if(m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+} // !rr
@@ -0,0 +1,98 @@
+#ifndef RRENDERER_ENGINE_UTILITY_THREAD_POOL_HPP
+#define RRENDERER_ENGINE_UTILITY_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rr
+{
+
+/**
+ *  <code>ThreadPool<\code> runs tasks on a fixed set of worker threads. Tasks are taken from a single queue in the
+ *  order they were submitted.
+ *
+ *  @author Felix Hommel
+ *  @date 10/17/2026
+*/
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t threadCount = defaultThreadCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /** One thread less than the hardware offers so the thread that submits work keeps a core */
+    [[nodiscard]] static std::size_t defaultThreadCount();
+    [[nodiscard]] std::size_t threadCount() const { return m_workers.size(); }
+
+    template<typename Task>
+    [[nodiscard]] auto submit(Task&& task) -> std::future<std::invoke_result_t<std::decay_t<Task>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Task>>;
+
+        // NOTE: std::function needs a copyable target, packaged_task is move only
+        auto packaged{ std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task)) };
+        auto future{ packaged->get_future() };
+
+        {
+            std::lock_guard lock{ m_mutex };
+            m_tasks.emplace_back([packaged] { (*packaged)(); });
+        }
+        m_condition.notify_one();
+
+        return future;
+    }
+
+    /**
+     *  Call <code>body(begin, end)<\code> for consecutive ranges covering <code>[0, count)<\code> and wait for all
+     *  of them. Exceptions thrown by <code>body<\code> are rethrown. Must not be called from inside of a task.
+    */
+    template<typename Body>
+    void parallelFor(std::size_t count, std::size_t minRangeSize, Body&& body)
+    {
+        if(count == 0)
+            return;
+
+        const std::size_t rangeCount{ std::max<std::size_t>(1, std::min(threadCount(), count / std::max<std::size_t>(minRangeSize, 1))) };
+        const std::size_t rangeSize{ (count + rangeCount - 1) / rangeCount };
+
+        std::vector<std::future<void>> pending;
+        pending.reserve(rangeCount);
+        for(std::size_t begin{ 0 }; begin < count; begin += rangeSize)
+            pending.push_back(submit([&body, begin, end = std::min(begin + rangeSize, count)] { body(begin, end); }));
+
+        // NOTE: every range has to finish before an exception of one of them is rethrown, they all use body and
+        //       whatever it references
+        for(auto& future : pending)
+            future.wait();
+        for(auto& future : pending)
+            future.get();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::jthread> m_workers;
+
+    void workerLoop(const std::stop_token& stopToken);
+};
+
+} // !rr
+
+#endif // !RRENDERER_ENGINE_UTILITY_THREAD_POOL_HPP
@@ -2,12 +2,12 @@
 
 layout(location = 0) out vec4 outColor;
 
-layout(push_constant) uniform Push {
+layout(set = 0, binding = 0) uniform DrawData {
     vec2 offset;
     vec3 color;
-} push;
+} draw;
 
 
 void main() {
-    outColor = vec4(push.color, 1.0);
+    outColor = vec4(draw.color, 1.0);
 }
@@ -1,14 +1,14 @@
 #version 450
 
-layout(location = 0) in vec2 position;
+layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 color;
 
-layout(push_constant) uniform Push {
+layout(set = 0, binding = 0) uniform DrawData {
     vec2 offset;
     vec3 color;
-} push;
+} draw;
 
 void main()
 {
-    gl_Position = vec4(position + push.offset, 0.0, 1.0);
+    gl_Position = vec4(position.xy + draw.offset, position.z, 1.0);
 }
@@ -0,0 +1,17 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+
+// NOTE: advance once per instance, see InstanceData
+layout(location = 2) in vec4 instanceTransform;
+layout(location = 3) in vec4 instanceColor;
+layout(location = 4) in vec4 instancePayload;
+
+layout(location = 0) out vec3 fragColor;
+
+void main()
+{
+    gl_Position = vec4(position * instanceTransform.w + instanceTransform.xyz, 1.0);
+    fragColor = instanceColor.rgb;
+}
@@ -0,0 +1,44 @@
+#include "utility/AliasPlanner.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+TEST(AliasPlanner, disjointLifetimesShareMemory)
+{
+    auto plan{ rr::AliasPlanner::plan({
+        { .size = 100, .alignment = 1, .firstUse = 0, .lastUse = 1 },
+        { .size = 60, .alignment = 1, .firstUse = 2, .lastUse = 3 }
+    }) };
+
+    EXPECT_EQ(plan.offsets, (std::vector<std::uint64_t>{ 0, 0 }));
+    EXPECT_EQ(plan.size, 100);
+}
+
+TEST(AliasPlanner, overlappingLifetimesDoNotShareMemory)
+{
+    auto plan{ rr::AliasPlanner::plan({
+        { .size = 100, .alignment = 1, .firstUse = 0, .lastUse = 2 },
+        { .size = 60, .alignment = 64, .firstUse = 2, .lastUse = 3 }
+    }) };
+
+    EXPECT_EQ(plan.offsets[0], 0);
+    EXPECT_EQ(plan.offsets[1], 128);
+    EXPECT_EQ(plan.size, 188);
+    EXPECT_EQ(plan.alignment, 64);
+}
+
+TEST(AliasPlanner, fillsGapsBetweenLiveResources)
+{
+    auto plan{ rr::AliasPlanner::plan({
+        { .size = 100, .alignment = 1, .firstUse = 0, .lastUse = 0 },
+        { .size = 100, .alignment = 1, .firstUse = 0, .lastUse = 2 },
+        { .size = 80, .alignment = 1, .firstUse = 1, .lastUse = 2 }
+    }) };
+
+    EXPECT_EQ(plan.offsets[0], 0);
+    EXPECT_EQ(plan.offsets[1], 100);
+    EXPECT_EQ(plan.offsets[2], 0);
+    EXPECT_EQ(plan.size, 200);
+}
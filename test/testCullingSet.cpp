@@ -0,0 +1,89 @@
+#include "mesh/MeshData.hpp"
+#include "scene/CullingSet.hpp"
+#include "scene/Frustum.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+rr::MeshBounds makeSphere(float radius)
+{
+    return { .min = { -radius, -radius, -radius }, .max = { radius, radius, radius }, .center = { 0.f, 0.f, 0.f }, .radius = radius };
+}
+
+} // !namespace
+
+TEST(CullingSet, emptySetHasNothingVisible)
+{
+    rr::CullingSet set;
+    std::vector<std::uint32_t> visible{ 1, 2, 3 };
+
+    set.cull(rr::Frustum::ndc(), visible);
+
+    EXPECT_TRUE(visible.empty());
+}
+
+TEST(CullingSet, cullsAgainstEveryPlane)
+{
+    rr::CullingSet set;
+    set.add(makeSphere(0.25f), { 0.f, 0.f, 0.5f });
+    set.add(makeSphere(0.25f), { 1.2f, 0.f, 0.5f });
+    set.add(makeSphere(0.25f), { 1.3f, 0.f, 0.5f });
+    set.add(makeSphere(0.25f), { 0.f, -1.3f, 0.5f });
+    set.add(makeSphere(0.25f), { 0.f, 0.f, -0.3f });
+    set.add(makeSphere(0.25f), { 0.f, 0.f, 1.2f });
+
+    std::vector<std::uint32_t> visible;
+    set.cull(rr::Frustum::ndc(), visible);
+
+    EXPECT_EQ(visible, (std::vector<std::uint32_t>{ 0, 1, 5 }));
+}
+
+TEST(CullingSet, transformsMoveAndScaleSpheres)
+{
+    rr::CullingSet set;
+    const auto object{ set.add(makeSphere(0.25f), { 3.f, 0.f, 0.5f }) };
+
+    std::vector<std::uint32_t> visible;
+    set.cull(rr::Frustum::ndc(), visible);
+    EXPECT_TRUE(visible.empty());
+
+    set.setTransform(object, { 3.f, 0.f, 0.5f }, 10.f);
+    set.cull(rr::Frustum::ndc(), visible);
+    EXPECT_EQ(visible, (std::vector<std::uint32_t>{ object }));
+}
+
+TEST(CullingSet, matchesScalarTestForEveryCount)
+{
+    std::mt19937 random{ 42 }; //NOLINT
+    std::uniform_real_distribution<float> position{ -2.f, 2.f };
+    std::uniform_real_distribution<float> radius{ 0.f, 0.5f };
+    const auto frustum{ rr::Frustum::ndc() };
+
+    // NOTE: every count up to three kernel widths, so full blocks and all tail lengths are covered
+    rr::CullingSet set;
+    std::vector<glm::vec3> centers;
+    std::vector<float> radii;
+    for(std::uint32_t count{ 1 }; count <= 24; ++count)
+    {
+        centers.push_back({ position(random), position(random), position(random) });
+        radii.push_back(radius(random));
+        set.add(makeSphere(radii.back()), centers.back());
+
+        std::vector<std::uint32_t> expected;
+        for(std::uint32_t i{ 0 }; i < count; ++i)
+        {
+            if(frustum.isSphereVisible(centers[i], radii[i]))
+                expected.push_back(i);
+        }
+
+        std::vector<std::uint32_t> visible;
+        set.cull(frustum, visible);
+        ASSERT_EQ(visible, expected) << "with " << count << " objects and " << rr::CullingSet::SIMD_NAME << " culling";
+    }
+}
@@ -0,0 +1,65 @@
+#include "utility/FreeListAllocator.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+TEST(FreeListAllocator, allocateRespectsAlignment)
+{
+    rr::FreeListAllocator allocator(1024);
+
+    auto first{ allocator.allocate(10, 1) };
+    auto second{ allocator.allocate(16, 256) };
+
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(first.value(), 0);
+    EXPECT_EQ(second.value() % 256, 0);
+    EXPECT_EQ(allocator.usedSize(), 26);
+    EXPECT_EQ(allocator.allocationCount(), 2);
+}
+
+TEST(FreeListAllocator, allocateFailsWhenFull)
+{
+    rr::FreeListAllocator allocator(64);
+
+    ASSERT_TRUE(allocator.allocate(64, 1).has_value());
+    EXPECT_FALSE(allocator.allocate(1, 1).has_value());
+}
+
+TEST(FreeListAllocator, freeMergesNeighbours)
+{
+    rr::FreeListAllocator allocator(300);
+
+    auto a{ allocator.allocate(100, 1) };
+    auto b{ allocator.allocate(100, 1) };
+    auto c{ allocator.allocate(100, 1) };
+    ASSERT_TRUE(a.has_value() && b.has_value() && c.has_value());
+
+    allocator.free(a.value());
+    allocator.free(c.value());
+    EXPECT_EQ(allocator.freeRangeCount(), 2);
+    EXPECT_EQ(allocator.largestFreeRange(), 100);
+
+    allocator.free(b.value());
+    EXPECT_TRUE(allocator.empty());
+    EXPECT_EQ(allocator.freeRangeCount(), 1);
+    EXPECT_EQ(allocator.largestFreeRange(), 300);
+}
+
+TEST(FreeListAllocator, allocatePrefersBestFit)
+{
+    rr::FreeListAllocator allocator(1000);
+
+    auto a{ allocator.allocate(500, 1) };
+    auto b{ allocator.allocate(100, 1) };
+    auto c{ allocator.allocate(50, 1) };
+    ASSERT_TRUE(a.has_value() && b.has_value() && c.has_value());
+
+    allocator.free(a.value());
+    allocator.free(c.value());
+
+    auto d{ allocator.allocate(40, 1) };
+    ASSERT_TRUE(d.has_value());
+    EXPECT_EQ(d.value(), 600);
+}
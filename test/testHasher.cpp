@@ -0,0 +1,28 @@
+#include "utility/Hasher.hpp"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+
+TEST(Hasher, equalValuesHashEqual)
+{
+    const std::array values{ 1U, 2U, 3U };
+
+    EXPECT_EQ(rr::Hasher{}.add(values).add(4.f).value(), rr::Hasher{}.add(values).add(4.f).value());
+}
+
+TEST(Hasher, dependsOnValuesAndOrder)
+{
+    const auto hash{ rr::Hasher{}.add(std::uint32_t{ 1 }).add(std::uint32_t{ 2 }).value() };
+
+    EXPECT_NE(hash, rr::Hasher{}.add(std::uint32_t{ 2 }).add(std::uint32_t{ 1 }).value());
+    EXPECT_NE(hash, rr::Hasher{}.add(std::uint32_t{ 1 }).add(std::uint32_t{ 3 }).value());
+    EXPECT_NE(hash, rr::Hasher{}.value());
+}
+
+TEST(Hasher, matchesFnv1a)
+{
+    // NOTE: reference value of FNV-1a 64 for the single byte 'a'
+    EXPECT_EQ(rr::Hasher{}.add('a').value(), 0xaf63dc4c8601ec8cULL);
+}
@@ -0,0 +1,37 @@
+#include "utility/Json.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string_view>
+
+TEST(Json, parsesNestedDocument)
+{
+    const auto document{ rr::Json::parse(R"({ "name": "aé\n", "values": [1, -2.5e1, true, null], "nested": { "x": {} } })") };
+
+    ASSERT_TRUE(document.has_value());
+    ASSERT_TRUE(document->isObject());
+    EXPECT_EQ(document->find("name")->asString(), std::string_view{ "a\xc3\xa9\n" });
+
+    const auto* values{ document->find("values") };
+    ASSERT_NE(values, nullptr);
+    ASSERT_EQ(values->size(), 4);
+    EXPECT_DOUBLE_EQ(values->at(0)->asNumber(), 1.0);
+    EXPECT_DOUBLE_EQ(values->at(1)->asNumber(), -25.0);
+    EXPECT_TRUE(values->at(2)->asBool());
+    EXPECT_TRUE(values->at(3)->isNull());
+    EXPECT_EQ(values->at(4), nullptr);
+
+    EXPECT_TRUE(document->find("nested")->find("x")->isObject());
+    EXPECT_EQ(document->find("missing"), nullptr);
+    EXPECT_DOUBLE_EQ(document->getNumber("missing", 7.0), 7.0);
+}
+
+TEST(Json, rejectsMalformedDocuments)
+{
+    EXPECT_FALSE(rr::Json::parse("").has_value());
+    EXPECT_FALSE(rr::Json::parse("{").has_value());
+    EXPECT_FALSE(rr::Json::parse("[1,]").has_value());
+    EXPECT_FALSE(rr::Json::parse(R"({"a" 1})").has_value());
+    EXPECT_FALSE(rr::Json::parse("[1] 2").has_value());
+    EXPECT_FALSE(rr::Json::parse(R"("\x")").has_value());
+}
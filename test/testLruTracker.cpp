@@ -0,0 +1,49 @@
+#include "utility/LruTracker.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+TEST(LruTracker, evictsLeastRecentlyUsedFirst)
+{
+    rr::LruTracker<int> tracker;
+    tracker.touch(1, 100);
+    tracker.touch(2, 100);
+    tracker.touch(3, 100);
+    tracker.touch(1, 100);
+
+    std::vector<int> evicted;
+    auto released{ tracker.evict(150, [&evicted](int key) { evicted.push_back(key); return true; }) };
+
+    EXPECT_EQ(released, 200);
+    EXPECT_EQ(evicted, (std::vector<int>{ 2, 3 }));
+    EXPECT_TRUE(tracker.contains(1));
+    EXPECT_EQ(tracker.totalBytes(), 100);
+}
+
+TEST(LruTracker, keepsEntriesThatCannotBeEvicted)
+{
+    rr::LruTracker<int> tracker;
+    tracker.touch(1, 50);
+    tracker.touch(2, 50);
+
+    auto released{ tracker.evict(100, [](int key) { return key != 1; }) };
+
+    EXPECT_EQ(released, 50);
+    EXPECT_EQ(tracker.size(), 1);
+    EXPECT_TRUE(tracker.contains(1));
+}
+
+TEST(LruTracker, touchUpdatesSize)
+{
+    rr::LruTracker<int> tracker;
+    tracker.touch(1, 10);
+    tracker.touch(1, 30);
+    tracker.remove(2);
+
+    EXPECT_EQ(tracker.size(), 1);
+    EXPECT_EQ(tracker.totalBytes(), 30);
+
+    tracker.remove(1);
+    EXPECT_EQ(tracker.totalBytes(), 0);
+}
@@ -0,0 +1,119 @@
+#include "exception/MeshImportException.hpp"
+#include "mesh/MeshFile.hpp"
+#include "mesh/MeshLod.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class MeshFileTest : public testing::Test
+{
+protected:
+    std::filesystem::path path{ std::filesystem::temp_directory_path() / "rrenderer-test-mesh.rrmesh" };
+    std::vector<rr::Vertex> vertices{
+        { .position = { -1.f, 0.f, 0.f }, .color = { 1.f, 0.f, 0.f } },
+        { .position = { 1.f, 0.f, 0.f }, .color = { 0.f, 1.f, 0.f } },
+        { .position = { 1.f, 2.f, 0.f }, .color = { 0.f, 0.f, 1.f } },
+        { .position = { -1.f, 2.f, 0.f }, .color = { 1.f, 1.f, 1.f } }
+    };
+    std::vector<std::uint32_t> indices{ 0, 1, 2, 0, 2, 3 };
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    void corruptByte(std::size_t offset)
+    {
+        std::fstream file{ path, std::ios::in | std::ios::out | std::ios::binary };
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.put('\x7f');
+    }
+};
+
+} // !namespace
+
+TEST_F(MeshFileTest, roundTripKeepsSectionsAligned)
+{
+    rr::MeshFile::write(path, vertices, indices);
+    const rr::MeshFile file{ path };
+
+    EXPECT_EQ(file.getVertexCount(), 4);
+    EXPECT_EQ(file.getIndexCount(), 6);
+    EXPECT_EQ(file.getIndexType(), VK_INDEX_TYPE_UINT16);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(file.getVertexData().data()) % rr::MeshFile::SECTION_ALIGNMENT, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(file.getIndexData().data()) % rr::MeshFile::SECTION_ALIGNMENT, 0);
+
+    ASSERT_EQ(file.getVertexData().size(), vertices.size() * sizeof(rr::Vertex));
+    EXPECT_EQ(std::memcmp(file.getVertexData().data(), vertices.data(), file.getVertexData().size()), 0);
+
+    const std::vector<std::uint16_t> expectedIndices{ 0, 1, 2, 0, 2, 3 };
+    ASSERT_EQ(file.getIndexData().size(), expectedIndices.size() * sizeof(std::uint16_t));
+    EXPECT_EQ(std::memcmp(file.getIndexData().data(), expectedIndices.data(), file.getIndexData().size()), 0);
+
+    EXPECT_FLOAT_EQ(file.getBounds().min.x, -1.f);
+    EXPECT_FLOAT_EQ(file.getBounds().max.y, 2.f);
+    EXPECT_FLOAT_EQ(file.getBounds().center.y, 1.f);
+}
+
+TEST_F(MeshFileTest, roundTripKeepsLods)
+{
+    auto lodIndices{ indices };
+    lodIndices.insert(lodIndices.end(), { 0, 1, 2 });
+    const std::vector<rr::MeshLod> lods{ { .firstIndex = 0, .indexCount = 6, .error = 0.f }, { .firstIndex = 6, .indexCount = 3, .error = 0.5f } };
+
+    rr::MeshFile::write(path, vertices, lodIndices, lods);
+    const rr::MeshFile file{ path };
+
+    EXPECT_EQ(file.getIndexCount(), 9);
+    ASSERT_EQ(file.getLods().size(), 2);
+    EXPECT_EQ(file.getLods()[1].firstIndex, 6);
+    EXPECT_EQ(file.getLods()[1].indexCount, 3);
+    EXPECT_FLOAT_EQ(file.getLods()[1].error, 0.5f);
+
+    rr::MeshFile::write(path, vertices, indices);
+    EXPECT_TRUE(rr::MeshFile{ path }.getLods().empty());
+}
+
+TEST_F(MeshFileTest, detectsCorruptedContent)
+{
+    rr::MeshFile::write(path, vertices, indices);
+    // NOTE: the bounds section is stored last
+    corruptByte(std::filesystem::file_size(path) - 1);
+
+    try
+    {
+        const rr::MeshFile file{ path };
+        FAIL() << "Expected MeshImportException";
+    }
+    catch(const rr::MeshImportException& ex)
+    {
+        EXPECT_EQ(ex.cause(), rr::MeshImportExceptionCause::MESH_FILE_CORRUPTED);
+    }
+
+    EXPECT_NO_THROW(rr::MeshFile(path, false));
+}
+
+TEST_F(MeshFileTest, rejectsForeignFiles)
+{
+    {
+        std::ofstream file{ path, std::ios::binary };
+        file << "# not a mesh file, but long enough to hold a header ......................................";
+    }
+
+    try
+    {
+        const rr::MeshFile file{ path };
+        FAIL() << "Expected MeshImportException";
+    }
+    catch(const rr::MeshImportException& ex)
+    {
+        EXPECT_EQ(ex.cause(), rr::MeshImportExceptionCause::INVALID_MESH_FILE);
+    }
+}
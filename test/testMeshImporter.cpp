@@ -0,0 +1,207 @@
+#include "exception/MeshImportException.hpp"
+#include "mesh/GltfImporter.hpp"
+#include "mesh/MeshImporter.hpp"
+#include "mesh/ObjImporter.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+std::string encodeBase64(std::span<const std::byte> data)
+{
+    constexpr std::string_view ALPHABET{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+
+    std::string result;
+    for(std::size_t i{ 0 }; i < data.size(); i += 3)
+    {
+        const std::size_t byteCount{ std::min<std::size_t>(3, data.size() - i) };
+
+        std::uint32_t group{ 0 };
+        for(std::size_t j{ 0 }; j < 3; ++j)
+            group = (group << 8U) | (j < byteCount ? std::to_integer<std::uint32_t>(data[i + j]) : 0U);
+
+        for(std::size_t j{ 0 }; j < 4; ++j)
+            result.push_back(j <= byteCount ? ALPHABET[(group >> (18U - 6U * j)) & 0x3FU] : '=');
+    }
+
+    return result;
+}
+
+/** Unit quad in the xy plane, positions followed by six 16 bit indices */
+std::vector<std::byte> makeQuadBuffer()
+{
+    const std::array<float, 12> positions{ 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 0.f };
+    const std::array<std::uint16_t, 6> indices{ 0, 1, 2, 0, 2, 3 };
+
+    std::vector<std::byte> buffer(sizeof(positions) + sizeof(indices));
+    std::memcpy(buffer.data(), positions.data(), sizeof(positions));
+    std::memcpy(buffer.data() + sizeof(positions), indices.data(), sizeof(indices));
+
+    return buffer;
+}
+
+std::string makeQuadDocument(const std::string& bufferUri)
+{
+    return R"({
+        "asset": { "version": "2.0" },
+        "scene": 0,
+        "scenes": [ { "nodes": [ 0 ] } ],
+        "nodes": [ { "translation": [ 1, 2, 3 ], "children": [ 1 ] }, { "mesh": 0 } ],
+        "meshes": [ { "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1 } ] } ],
+        "buffers": [ { )" + bufferUri + R"("byteLength": 60 } ],
+        "bufferViews": [
+            { "buffer": 0, "byteOffset": 0, "byteLength": 48 },
+            { "buffer": 0, "byteOffset": 48, "byteLength": 12 }
+        ],
+        "accessors": [
+            { "bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3" },
+            { "bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR" }
+        ]
+    })";
+}
+
+void expectTranslatedQuad(const rr::MeshData& mesh)
+{
+    ASSERT_EQ(mesh.vertices.size(), 4);
+    EXPECT_EQ(mesh.indices, (std::vector<std::uint32_t>{ 0, 1, 2, 0, 2, 3 }));
+    EXPECT_FLOAT_EQ(mesh.vertices[2].position.x, 2.f);
+    EXPECT_FLOAT_EQ(mesh.vertices[2].position.y, 3.f);
+    EXPECT_FLOAT_EQ(mesh.vertices[2].position.z, 3.f);
+}
+
+} // !namespace
+
+TEST(MeshImporter, objSharesPositionsAcrossChunks)
+{
+    rr::ThreadPool pool{ 4 };
+    std::string text{ "# quad\nv 0 0 0\nv 1 0 0 1 0 0\nv 1 1 0\n" };
+    text += "v 0 1 0\nf 1 2 3 4\n";
+    text += "f -4 -2 -1\n";
+
+    // NOTE: a tiny chunk size splits this file into one chunk per thread
+    const auto mesh{ rr::ObjImporter::parse(text, pool, "quad.obj", 8) };
+
+    ASSERT_EQ(mesh.vertices.size(), 4);
+    EXPECT_EQ(mesh.indices, (std::vector<std::uint32_t>{ 0, 1, 2, 0, 2, 3, 0, 2, 3 }));
+    EXPECT_FLOAT_EQ(mesh.vertices[1].position.x, 1.f);
+    EXPECT_FLOAT_EQ(mesh.vertices[1].color.y, 0.f);
+    EXPECT_FLOAT_EQ(mesh.vertices[0].color.y, 1.f);
+}
+
+TEST(MeshImporter, objWithNormalsUsesOneVertexPerCorner)
+{
+    rr::ThreadPool pool{ 2 };
+    const std::string text{ "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nvt 0 0\nf 1/1/1 2/1/1 3//1\n" };
+
+    const auto mesh{ rr::ObjImporter::parse(text, pool, "normals.obj") };
+
+    ASSERT_EQ(mesh.vertices.size(), 3);
+    EXPECT_EQ(mesh.indices, (std::vector<std::uint32_t>{ 0, 1, 2 }));
+    EXPECT_FLOAT_EQ(mesh.vertices[2].position.y, 1.f);
+    EXPECT_FLOAT_EQ(mesh.vertices[2].color.z, 1.f);
+    EXPECT_FLOAT_EQ(mesh.vertices[2].color.x, 0.5f);
+}
+
+TEST(MeshImporter, objRejectsInvalidIndices)
+{
+    rr::ThreadPool pool{ 1 };
+
+    try
+    {
+        static_cast<void>(rr::ObjImporter::parse("v 0 0 0\nf 1 2 3\n", pool, "broken.obj"));
+        FAIL() << "Expected MeshImportException";
+    }
+    catch(const rr::MeshImportException& ex)
+    {
+        EXPECT_EQ(ex.cause(), rr::MeshImportExceptionCause::INDEX_OUT_OF_RANGE);
+        EXPECT_EQ(ex.getPath(), "broken.obj");
+    }
+
+    EXPECT_THROW(static_cast<void>(rr::ObjImporter::parse("v 0 0\n", pool, "broken.obj")), rr::MeshImportException);
+}
+
+TEST(MeshImporter, objRejectsMalformedFirstChunkWhileOthersAreParsed)
+{
+    rr::ThreadPool pool{ 4 };
+
+    // NOTE: the first chunk fails right away while the other chunks still have lots of vertices to parse
+    std::string text{ "f 1 2\n" };
+    for(std::size_t i{ 0 }; i < 200'000; ++i)
+        text += "v 0 0 0\n";
+
+    try
+    {
+        static_cast<void>(rr::ObjImporter::parse(text, pool, "x.obj", 1024));
+        FAIL() << "Expected MeshImportException";
+    }
+    catch(const rr::MeshImportException& ex)
+    {
+        EXPECT_EQ(ex.cause(), rr::MeshImportExceptionCause::MALFORMED_OBJ);
+        EXPECT_EQ(ex.getPath(), "x.obj");
+    }
+}
+
+TEST(MeshImporter, gltfWithEmbeddedBuffer)
+{
+    rr::ThreadPool pool{ 2 };
+    const auto document{ makeQuadDocument(R"("uri": "data:application/octet-stream;base64,)" + encodeBase64(makeQuadBuffer()) + R"(", )") };
+
+    expectTranslatedQuad(rr::GltfImporter::parse(std::as_bytes(std::span{ document }), {}, pool, "quad.gltf"));
+}
+
+TEST(MeshImporter, glbFromFile)
+{
+    // NOTE: chunks of a .glb are padded to 4 bytes
+    auto json{ makeQuadDocument("") };
+    json.resize((json.size() + 3) & ~std::size_t{ 3 }, ' ');
+    const auto binary{ makeQuadBuffer() };
+
+    std::vector<std::byte> glb(12 + 8 + json.size() + 8 + binary.size());
+    auto write{ [&glb](std::size_t offset, std::uint32_t value) { std::memcpy(glb.data() + offset, &value, sizeof(value)); } };
+    write(0, 0x46546C67);
+    write(4, 2);
+    write(8, static_cast<std::uint32_t>(glb.size()));
+    write(12, static_cast<std::uint32_t>(json.size()));
+    write(16, 0x4E4F534A);
+    std::memcpy(glb.data() + 20, json.data(), json.size());
+    write(20 + json.size(), static_cast<std::uint32_t>(binary.size()));
+    write(24 + json.size(), 0x004E4942);
+    std::memcpy(glb.data() + 28 + json.size(), binary.data(), binary.size());
+
+    const auto path{ std::filesystem::temp_directory_path() / "rrenderer-test-quad.glb" };
+    {
+        std::ofstream file{ path, std::ios::binary };
+        file.write(reinterpret_cast<const char*>(glb.data()), static_cast<std::streamsize>(glb.size())); // NOLINT
+    }
+
+    rr::MeshImporter importer{ 2 };
+    rr::ImportStatistics statistics;
+    const auto mesh{ importer.import(path, &statistics) };
+    std::filesystem::remove(path);
+
+    expectTranslatedQuad(mesh);
+    EXPECT_EQ(statistics.bytes, glb.size());
+    EXPECT_EQ(statistics.indexCount, 6);
+}
+
+TEST(MeshImporter, rejectsUnknownExtension)
+{
+    rr::MeshImporter importer{ 1 };
+
+    EXPECT_FALSE(rr::MeshImporter::isSupported("mesh.fbx"));
+    EXPECT_TRUE(rr::MeshImporter::isSupported("mesh.GLTF"));
+    EXPECT_THROW(static_cast<void>(importer.import("mesh.fbx")), rr::MeshImportException);
+}
@@ -0,0 +1,103 @@
+#include "mesh/MeshOptimizer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+struct TestVertex
+{
+    float x;
+    float y;
+    float z;
+};
+
+/** Regular grid of <code>size<\code> x <code>size<\code> quads as a plain triangle list */
+std::vector<TestVertex> makeGrid(std::uint32_t size)
+{
+    std::vector<TestVertex> vertices;
+    for(std::uint32_t y{ 0 }; y < size; ++y)
+    {
+        for(std::uint32_t x{ 0 }; x < size; ++x)
+        {
+            const auto fx{ static_cast<float>(x) };
+            const auto fy{ static_cast<float>(y) };
+            vertices.insert(vertices.end(), {
+                { fx, fy, 0.f }, { fx + 1.f, fy, 0.f }, { fx, fy + 1.f, 0.f },
+                { fx + 1.f, fy, 0.f }, { fx + 1.f, fy + 1.f, 0.f }, { fx, fy + 1.f, 0.f }
+            });
+        }
+    }
+
+    return vertices;
+}
+
+} // !namespace
+
+TEST(MeshOptimizer, deduplicateMergesSharedVertices)
+{
+    auto vertices{ makeGrid(4) };
+    std::vector<std::uint32_t> indices;
+
+    auto stats{ rr::MeshOptimizer::optimize(vertices, indices, 0, 3) };
+
+    EXPECT_EQ(stats.vertexCountBefore, 4 * 4 * 6);
+    EXPECT_EQ(stats.vertexCountAfter, 5 * 5);
+    EXPECT_EQ(vertices.size(), 5 * 5);
+    EXPECT_EQ(indices.size(), 4 * 4 * 6);
+    EXPECT_TRUE(std::ranges::all_of(indices, [&vertices](std::uint32_t index) { return index < vertices.size(); }));
+}
+
+TEST(MeshOptimizer, vertexCacheOptimizationLowersAcmr)
+{
+    constexpr std::uint32_t SIZE{ 32 };
+    constexpr std::uint32_t ROW{ SIZE + 1 };
+
+    // NOTE: column major order thrashes a small cache on a row major vertex grid
+    std::vector<std::uint32_t> indices;
+    for(std::uint32_t x{ 0 }; x < SIZE; ++x)
+    {
+        for(std::uint32_t y{ 0 }; y < SIZE; ++y)
+        {
+            const std::uint32_t v{ y * ROW + x };
+            indices.insert(indices.end(), { v, v + 1, v + ROW, v + 1, v + ROW + 1, v + ROW });
+        }
+    }
+    std::ranges::reverse(indices);
+
+    const auto before{ rr::MeshOptimizer::analyzeVertexCache(indices, ROW * ROW) };
+    rr::MeshOptimizer::optimizeVertexCache(indices, ROW * ROW);
+    const auto after{ rr::MeshOptimizer::analyzeVertexCache(indices, ROW * ROW) };
+
+    EXPECT_EQ(indices.size(), SIZE * SIZE * 6);
+    EXPECT_LT(after.acmr, before.acmr);
+    EXPECT_LT(after.acmr, 1.f);
+}
+
+TEST(MeshOptimizer, vertexFetchFollowsFirstUse)
+{
+    std::vector<std::byte> vertices{ std::byte{ 0 }, std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+    std::vector<std::uint32_t> indices{ 2, 0, 2 };
+
+    auto vertexCount{ rr::MeshOptimizer::optimizeVertexFetch(vertices, 1, indices) };
+
+    EXPECT_EQ(vertexCount, 2);
+    EXPECT_EQ(vertices, (std::vector<std::byte>{ std::byte{ 2 }, std::byte{ 0 } }));
+    EXPECT_EQ(indices, (std::vector<std::uint32_t>{ 0, 1, 0 }));
+}
+
+TEST(MeshOptimizer, analyzeReportsPerfectStrip)
+{
+    std::vector<std::uint32_t> indices{ 0, 1, 2, 2, 1, 3 };
+
+    auto stats{ rr::MeshOptimizer::analyzeVertexCache(indices, 4) };
+
+    EXPECT_EQ(stats.transformedVertexCount, 4);
+    EXPECT_FLOAT_EQ(stats.acmr, 2.f);
+    EXPECT_FLOAT_EQ(stats.atvr, 1.f);
+}
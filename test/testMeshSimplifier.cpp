@@ -0,0 +1,198 @@
+#include "mesh/MeshLod.hpp"
+#include "mesh/MeshSimplifier.hpp"
+#include "mesh/Vertex.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+
+const rr::SimplificationLayout LAYOUT{ .positionOffset = offsetof(rr::Vertex, position), .attributeOffset = offsetof(rr::Vertex, color), .attributeCount = 3 };
+
+struct TestMesh
+{
+    std::vector<rr::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+/** Flat grid of <code>size<\code> x <code>size<\code> quads, the left and right half have different colors */
+TestMesh makeGrid(std::uint32_t size, bool splitColors)
+{
+    TestMesh mesh;
+    const std::uint32_t half{ size / 2 };
+    auto addVertex{ [&mesh](std::uint32_t x, std::uint32_t y, float red) {
+        mesh.vertices.push_back({ .position = { static_cast<float>(x), static_cast<float>(y), 0.f }, .color = { red, 0.f, 0.f } });
+        return static_cast<std::uint32_t>(mesh.vertices.size() - 1);
+    } };
+
+    // NOTE: columns on the seam get one vertex per color
+    std::vector<std::uint32_t> left((size + 1) * (size + 1));
+    std::vector<std::uint32_t> right((size + 1) * (size + 1));
+    for(std::uint32_t y{ 0 }; y <= size; ++y)
+    {
+        for(std::uint32_t x{ 0 }; x <= size; ++x)
+        {
+            const auto index{ y * (size + 1) + x };
+            left[index] = addVertex(x, y, 0.f);
+            right[index] = splitColors && x == half ? addVertex(x, y, 1.f) : left[index];
+        }
+    }
+
+    for(std::uint32_t y{ 0 }; y < size; ++y)
+    {
+        for(std::uint32_t x{ 0 }; x < size; ++x)
+        {
+            const auto& side{ splitColors && x >= half ? right : left };
+            const auto i00{ side[y * (size + 1) + x] };
+            const auto i10{ side[y * (size + 1) + x + 1] };
+            const auto i01{ side[(y + 1) * (size + 1) + x] };
+            const auto i11{ side[(y + 1) * (size + 1) + x + 1] };
+            mesh.indices.insert(mesh.indices.end(), { i00, i10, i11, i00, i11, i01 });
+        }
+    }
+
+    if(splitColors)
+    {
+        for(std::uint32_t y{ 0 }; y <= size; ++y)
+        {
+            for(std::uint32_t x{ half + 1 }; x <= size; ++x)
+                mesh.vertices[right[y * (size + 1) + x]].color = { 1.f, 0.f, 0.f };
+        }
+    }
+
+    return mesh;
+}
+
+/** Closed torus without seams, every vertex is manifold */
+TestMesh makeTorus(std::uint32_t rings, std::uint32_t sides)
+{
+    TestMesh mesh;
+    for(std::uint32_t ring{ 0 }; ring < rings; ++ring)
+    {
+        for(std::uint32_t side{ 0 }; side < sides; ++side)
+        {
+            const float u{ 2.f * std::numbers::pi_v<float> * static_cast<float>(ring) / static_cast<float>(rings) };
+            const float v{ 2.f * std::numbers::pi_v<float> * static_cast<float>(side) / static_cast<float>(sides) };
+            const float radius{ 1.f + 0.3f * std::cos(v) };
+            mesh.vertices.push_back({ .position = { radius * std::cos(u), radius * std::sin(u), 0.3f * std::sin(v) }, .color = { 1.f, 1.f, 1.f } });
+
+            const auto nextRing{ (ring + 1) % rings };
+            const auto nextSide{ (side + 1) % sides };
+            const auto i00{ ring * sides + side };
+            const auto i10{ nextRing * sides + side };
+            const auto i01{ ring * sides + nextSide };
+            const auto i11{ nextRing * sides + nextSide };
+            mesh.indices.insert(mesh.indices.end(), { i00, i10, i11, i00, i11, i01 });
+        }
+    }
+
+    return mesh;
+}
+
+std::vector<std::uint32_t> simplify(const TestMesh& mesh, std::size_t targetIndexCount, float targetError, float* resultError = nullptr)
+{
+    return rr::MeshSimplifier::simplify(std::as_bytes(std::span{ mesh.vertices }), sizeof(rr::Vertex), LAYOUT, mesh.indices, targetIndexCount, targetError, resultError);
+}
+
+} // !namespace
+
+TEST(MeshSimplifier, flatGridCollapsesWithoutError)
+{
+    const auto mesh{ makeGrid(16, false) };
+
+    float error{ 1.f };
+    const auto result{ simplify(mesh, mesh.indices.size() / 8, 0.001f, &error) };
+
+    EXPECT_LE(result.size(), mesh.indices.size() / 8);
+    EXPECT_EQ(result.size() % 3, 0);
+    EXPECT_LT(error, 1e-3f);
+
+    // NOTE: border vertices only slide along the border, so the corners of the grid stay in place
+    for(const auto corner : { 0U, 16U, 17U * 16U, 17U * 17U - 1U })
+        EXPECT_TRUE(std::ranges::find(result, corner) != result.end()) << corner;
+}
+
+TEST(MeshSimplifier, colorSeamsAreKept)
+{
+    const auto mesh{ makeGrid(16, true) };
+
+    const auto result{ simplify(mesh, mesh.indices.size() / 4, 0.01f) };
+
+    EXPECT_LT(result.size(), mesh.indices.size() / 2);
+    for(std::size_t i{ 0 }; i < result.size(); i += 3)
+    {
+        const float red{ mesh.vertices[result[i]].color.x };
+        EXPECT_EQ(mesh.vertices[result[i + 1]].color.x, red);
+        EXPECT_EQ(mesh.vertices[result[i + 2]].color.x, red);
+    }
+}
+
+TEST(MeshSimplifier, stopsAtTargetError)
+{
+    const auto mesh{ makeTorus(64, 32) };
+
+    float coarseError{ 0.f };
+    const auto coarse{ simplify(mesh, 3 * 64, 1.f, &coarseError) };
+    float fineError{ 0.f };
+    const auto fine{ simplify(mesh, 3 * 64, 0.005f, &fineError) };
+
+    EXPECT_LE(coarse.size(), 3 * 64);
+    EXPECT_GT(coarseError, 0.005f);
+    EXPECT_GT(fine.size(), coarse.size());
+    EXPECT_LT(fine.size(), mesh.indices.size());
+    EXPECT_LE(fineError, 0.005f);
+    EXPECT_TRUE(std::ranges::all_of(coarse, [&mesh](std::uint32_t index) { return index < mesh.vertices.size(); }));
+}
+
+TEST(MeshSimplifier, generatesLodChain)
+{
+    auto mesh{ makeTorus(64, 32) };
+    const auto baseIndexCount{ mesh.indices.size() };
+
+    const auto lods{ rr::MeshSimplifier::generateLods(mesh.vertices, mesh.indices, LAYOUT) };
+
+    ASSERT_GE(lods.size(), 3);
+    EXPECT_LE(lods.size(), rr::MeshSimplifier::MAX_LOD_COUNT);
+    EXPECT_EQ(lods[0].firstIndex, 0);
+    EXPECT_EQ(lods[0].indexCount, baseIndexCount);
+    EXPECT_EQ(lods[0].error, 0.f);
+
+    for(std::size_t i{ 1 }; i < lods.size(); ++i)
+    {
+        EXPECT_EQ(lods[i].firstIndex, lods[i - 1].firstIndex + lods[i - 1].indexCount);
+        EXPECT_LT(lods[i].indexCount, lods[i - 1].indexCount);
+        EXPECT_GE(lods[i].error, lods[i - 1].error);
+    }
+
+    EXPECT_EQ(mesh.indices.size(), lods.back().firstIndex + lods.back().indexCount);
+    // NOTE: errors are in model space, the torus is 2.6 units wide
+    EXPECT_LE(lods.back().error, rr::MeshSimplifier::DEFAULT_MAX_LOD_ERROR * 2.6f + 1e-4f);
+}
+
+TEST(MeshSimplifier, selectsLodByProjectedError)
+{
+    const std::vector<rr::MeshLod> lods{
+        { .firstIndex = 0, .indexCount = 300, .error = 0.f },
+        { .firstIndex = 300, .indexCount = 150, .error = 0.01f },
+        { .firstIndex = 450, .indexCount = 75, .error = 0.1f }
+    };
+
+    const auto perspective{ rr::LodSelector::perspective(std::numbers::pi_v<float> / 2.f, 1000.f) };
+    EXPECT_EQ(perspective.select(lods, 0.f), 0);
+    EXPECT_EQ(perspective.select(lods, 1.f), 0);
+    EXPECT_EQ(perspective.select(lods, 10.f), 1);
+    EXPECT_EQ(perspective.select(lods, 100.f), 2);
+    EXPECT_EQ(perspective.select(lods, 100.f, 10.f), 1);
+
+    const auto orthographic{ rr::LodSelector::orthographic(2.f, 1000.f) };
+    EXPECT_EQ(orthographic.select(lods, 1000.f), 0);
+    EXPECT_EQ(rr::LodSelector::orthographic(20.f, 1000.f).select(lods, 0.f), 1);
+}
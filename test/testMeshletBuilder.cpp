@@ -0,0 +1,159 @@
+#include "mesh/Meshlet.hpp"
+#include "mesh/MeshletBuilder.hpp"
+#include "mesh/Vertex.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace
+{
+
+struct TestMesh
+{
+    std::vector<rr::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+/** Flat grid of <code>size<\code> x <code>size<\code> quads in the xy plane facing +z */
+TestMesh makeGrid(std::uint32_t size)
+{
+    TestMesh mesh;
+    for(std::uint32_t y{ 0 }; y <= size; ++y)
+    {
+        for(std::uint32_t x{ 0 }; x <= size; ++x)
+            mesh.vertices.push_back({ .position = { static_cast<float>(x), static_cast<float>(y), 0.f }, .color = { 1.f, 1.f, 1.f } });
+    }
+
+    for(std::uint32_t y{ 0 }; y < size; ++y)
+    {
+        for(std::uint32_t x{ 0 }; x < size; ++x)
+        {
+            const auto i00{ y * (size + 1) + x };
+            const auto i10{ i00 + 1 };
+            const auto i01{ i00 + size + 1 };
+            const auto i11{ i01 + 1 };
+            mesh.indices.insert(mesh.indices.end(), { i00, i10, i11, i00, i11, i01 });
+        }
+    }
+
+    return mesh;
+}
+
+rr::MeshletCullData makeView()
+{
+    // NOTE: box from -1 to 1 on every axis
+    return {
+        .frustumPlanes = { { { 1.f, 0.f, 0.f, 1.f }, { -1.f, 0.f, 0.f, 1.f }, { 0.f, 1.f, 0.f, 1.f }, { 0.f, -1.f, 0.f, 1.f }, { 0.f, 0.f, 1.f, 1.f }, { 0.f, 0.f, -1.f, 1.f } } },
+        .camera = { 0.f, 0.f, -1.f, 0.f },
+        .translation = { 0.f, 0.f, 0.f, 0.f },
+        .meshletCount = 1,
+        .drawIndex = 0,
+        .coneCulling = 1,
+        .firstIndex = 0,
+        .vertexOffset = 0
+    };
+}
+
+} // !namespace
+
+TEST(MeshletBuilder, coversAllTrianglesInOrder)
+{
+    const auto mesh{ makeGrid(32) };
+
+    const auto data{ rr::MeshletBuilder::build(mesh.vertices, mesh.indices, offsetof(rr::Vertex, position)) };
+
+    ASSERT_FALSE(data.meshlets.empty());
+    ASSERT_EQ(data.meshlets.size(), data.bounds.size());
+    EXPECT_EQ(data.triangles.size(), mesh.indices.size());
+
+    std::uint32_t nextTriangle{ 0 };
+    for(const auto& meshlet : data.meshlets)
+    {
+        EXPECT_LE(meshlet.vertexCount, rr::MeshletBuilder::MAX_VERTICES);
+        EXPECT_LE(meshlet.triangleCount, rr::MeshletBuilder::MAX_TRIANGLES);
+        EXPECT_GT(meshlet.triangleCount, 0);
+        ASSERT_EQ(meshlet.triangleOffset, nextTriangle);
+
+        for(std::uint32_t i{ 0 }; i < meshlet.triangleCount * 3; ++i)
+        {
+            const auto local{ data.triangles[meshlet.triangleOffset + i] };
+            ASSERT_LT(local, meshlet.vertexCount);
+            EXPECT_EQ(data.vertices[meshlet.vertexOffset + local], mesh.indices[meshlet.triangleOffset + i]);
+        }
+
+        nextTriangle += meshlet.triangleCount * 3;
+    }
+    EXPECT_EQ(nextTriangle, mesh.indices.size());
+}
+
+TEST(MeshletBuilder, respectsCustomLimits)
+{
+    const auto mesh{ makeGrid(8) };
+
+    const auto data{ rr::MeshletBuilder::build(std::as_bytes(std::span{ mesh.vertices }), sizeof(rr::Vertex), offsetof(rr::Vertex, position), mesh.indices, 16, 8) };
+
+    EXPECT_GE(data.meshlets.size(), mesh.indices.size() / 3 / 8);
+    for(const auto& meshlet : data.meshlets)
+    {
+        EXPECT_LE(meshlet.vertexCount, 16);
+        EXPECT_LE(meshlet.triangleCount, 8);
+    }
+}
+
+TEST(MeshletBuilder, boundsContainVerticesAndFlatConesAreTight)
+{
+    const auto mesh{ makeGrid(32) };
+
+    const auto data{ rr::MeshletBuilder::build(mesh.vertices, mesh.indices, offsetof(rr::Vertex, position)) };
+
+    for(std::size_t i{ 0 }; i < data.meshlets.size(); ++i)
+    {
+        const auto& meshlet{ data.meshlets[i] };
+        const auto& bounds{ data.bounds[i] };
+        for(std::uint32_t k{ 0 }; k < meshlet.vertexCount; ++k)
+        {
+            const auto& position{ mesh.vertices[data.vertices[meshlet.vertexOffset + k]].position };
+            const float dx{ position.x - bounds.center.x };
+            const float dy{ position.y - bounds.center.y };
+            const float dz{ position.z - bounds.center.z };
+            EXPECT_LE(std::sqrt(dx * dx + dy * dy + dz * dz), bounds.radius + 1e-4f);
+        }
+
+        // NOTE: all triangles of the grid face +z, so the cone has no width
+        EXPECT_NEAR(bounds.coneAxis.z, 1.f, 1e-5f);
+        EXPECT_NEAR(bounds.coneCutoff, 0.f, 1e-3f);
+    }
+}
+
+TEST(MeshletBuilder, culling)
+{
+    const rr::MeshletBounds bounds{ .center = { 0.f, 0.f, 0.f }, .radius = 0.5f, .coneAxis = { 0.f, 0.f, 1.f }, .coneCutoff = 0.f };
+    auto view{ makeView() };
+
+    // NOTE: the view direction is -z, so triangles facing +z are seen from the front until it flips
+    EXPECT_TRUE(rr::isMeshletVisible(bounds, view));
+    view.camera = { 0.f, 0.f, 1.f, 0.f };
+    EXPECT_FALSE(rr::isMeshletVisible(bounds, view));
+    view.coneCulling = 0;
+    EXPECT_TRUE(rr::isMeshletVisible(bounds, view));
+
+    view.translation = { 1.4f, 0.f, 0.f, 0.f };
+    EXPECT_TRUE(rr::isMeshletVisible(bounds, view));
+    view.translation = { 1.6f, 0.f, 0.f, 0.f };
+    EXPECT_FALSE(rr::isMeshletVisible(bounds, view));
+
+    view.translation = { 0.f, 0.f, 0.f, 0.f };
+    view.coneCulling = 1;
+    view.camera = { 0.f, 0.f, 5.f, 1.f };
+    EXPECT_TRUE(rr::isMeshletVisible(bounds, view));
+    view.camera = { 0.f, 0.f, -5.f, 1.f };
+    EXPECT_FALSE(rr::isMeshletVisible(bounds, view));
+
+    const rr::MeshletBounds wide{ .center = { 0.f, 0.f, 0.f }, .radius = 0.5f, .coneAxis = { 0.f, 0.f, 1.f }, .coneCutoff = 1.f };
+    EXPECT_TRUE(rr::isMeshletVisible(wide, view));
+}
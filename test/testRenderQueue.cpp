@@ -0,0 +1,79 @@
+#include "scene/RenderQueue.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST(RenderQueue, sortsLikeAComparisonSort)
+{
+    std::mt19937_64 random{ 42 };
+    rr::RenderQueue queue;
+    std::vector<std::uint64_t> expected;
+    for(std::uint32_t i{ 0 }; i < 5000; ++i)
+    {
+        const std::uint64_t key{ random() };
+        queue.push(key, i);
+        expected.push_back(key);
+    }
+
+    queue.sort();
+    std::ranges::sort(expected);
+
+    ASSERT_EQ(queue.size(), expected.size());
+    for(std::size_t i{ 0 }; i < expected.size(); ++i)
+        EXPECT_EQ(queue.items()[i].key, expected[i]);
+}
+
+TEST(RenderQueue, keepsSubmissionOrderOfEqualKeys)
+{
+    rr::RenderQueue queue;
+    queue.push(7, 0);
+    queue.push(3, 1);
+    queue.push(7, 2);
+    queue.push(3, 3);
+    queue.push(0x0100000000000007, 4);
+
+    queue.sort();
+
+    std::vector<std::uint32_t> order;
+    for(const auto& item : queue.items())
+        order.push_back(item.index);
+    EXPECT_EQ(order, (std::vector<std::uint32_t>{ 1, 3, 0, 2, 4 }));
+}
+
+TEST(SortKey, groupsOpaqueDrawsByStateAndThenFrontToBack)
+{
+    const auto nearA{ rr::SortKey::make({ .depth = 0.1f }, 1, 0) };
+    const auto farA{ rr::SortKey::make({ .depth = 0.9f }, 1, 0) };
+    const auto nearB{ rr::SortKey::make({ .depth = 0.1f }, 2, 0) };
+    const auto otherMesh{ rr::SortKey::make({ .depth = 0.f }, 1, 1) };
+
+    EXPECT_LT(nearA, farA);
+    EXPECT_LT(farA, otherMesh);
+    EXPECT_LT(otherMesh, nearB);
+}
+
+TEST(SortKey, drawsTranslucentAfterOpaqueAndBackToFront)
+{
+    const auto opaque{ rr::SortKey::make({ .depth = 1.f }, rr::SortKey::MAX_PIPELINES - 1, 0) };
+    const auto nearGlass{ rr::SortKey::make({ .translucent = true, .depth = 0.2f }, 0, 0) };
+    const auto farGlass{ rr::SortKey::make({ .translucent = true, .depth = 0.8f }, 5, 0) };
+    const auto overlay{ rr::SortKey::make({ .layer = 1 }, 0, 0) };
+
+    EXPECT_LT(opaque, farGlass);
+    EXPECT_LT(farGlass, nearGlass);
+    EXPECT_LT(nearGlass, overlay);
+    EXPECT_TRUE(rr::SortKey::isTranslucent(nearGlass));
+    EXPECT_FALSE(rr::SortKey::isTranslucent(opaque));
+    EXPECT_EQ(rr::SortKey::layerOf(overlay), 1U);
+}
+
+TEST(SortKey, clampsDepth)
+{
+    EXPECT_EQ(rr::SortKey::quantizeDepth(-1.f), 0U);
+    EXPECT_EQ(rr::SortKey::quantizeDepth(2.f), (1U << rr::SortKey::DEPTH_BITS) - 1);
+    EXPECT_LT(rr::SortKey::quantizeDepth(0.25f), rr::SortKey::quantizeDepth(0.5f));
+}
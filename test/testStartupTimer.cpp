@@ -0,0 +1,28 @@
+#include "utility/StartupTimer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+TEST(StartupTimer, measurePassesResultThrough)
+{
+    rr::StartupTimer timer;
+
+    auto value{ timer.measure("value", [] { return std::make_unique<int>(42); }) };
+
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 42);
+}
+
+TEST(StartupTimer, recordsStagesInOrder)
+{
+    rr::StartupTimer timer;
+
+    (void)timer.measure("first", [] { return 1; });
+    (void)timer.measure("second", [] { return 2; });
+
+    ASSERT_EQ(timer.getStages().size(), 2);
+    EXPECT_EQ(timer.getStages()[0].name, "first");
+    EXPECT_EQ(timer.getStages()[1].name, "second");
+    EXPECT_GE(timer.elapsed(), timer.getStages()[0].duration + timer.getStages()[1].duration);
+}
@@ -0,0 +1,43 @@
+#include "utility/ThreadPool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPool, submitReturnsResult)
+{
+    rr::ThreadPool pool{ 2 };
+
+    auto future{ pool.submit([] { return 42; }) };
+
+    EXPECT_EQ(pool.threadCount(), 2);
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(ThreadPool, parallelForCoversEveryIndexOnce)
+{
+    rr::ThreadPool pool{ 4 };
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallelFor(visits.size(), 16, [&visits](std::size_t begin, std::size_t end) {
+        for(std::size_t i{ begin }; i < end; ++i)
+            ++visits[i];
+    });
+
+    for(const auto& count : visits)
+        EXPECT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPool, parallelForRethrows)
+{
+    rr::ThreadPool pool{ 2 };
+
+    EXPECT_THROW(pool.parallelFor(8, 1, [](std::size_t begin, std::size_t) {
+        if(begin == 0)
+            throw std::runtime_error{ "failed" };
+    }), std::runtime_error);
+}
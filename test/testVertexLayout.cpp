@@ -0,0 +1,114 @@
+#include "mesh/InstanceData.hpp"
+#include "mesh/PackedVertex.hpp"
+#include "mesh/Vertex.hpp"
+#include "mesh/VertexLayout.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+
+struct PositionStream
+{
+    rr::Half4 position;
+
+    static constexpr auto getBindingDescriptions() { return std::array{ rr::vertexBinding<PositionStream>(0) }; }
+    static constexpr auto getAttributeDescriptions() { return std::array{ rr::vertexAttribute<rr::Half4>(0, offsetof(PositionStream, position)) }; }
+};
+
+struct ShadingStream
+{
+    rr::Octahedral16 normal;
+    rr::Unorm8x4 color;
+
+    static constexpr auto getBindingDescriptions() { return std::array{ rr::vertexBinding<ShadingStream>(0) }; }
+    static constexpr auto getAttributeDescriptions()
+    {
+        return std::array{
+            rr::vertexAttribute<rr::Octahedral16>(1, offsetof(ShadingStream, normal)),
+            rr::vertexAttribute<rr::Unorm8x4>(2, offsetof(ShadingStream, color))
+        };
+    }
+};
+
+using SplitVertex = rr::VertexStreams<PositionStream, ShadingStream>;
+
+} // !namespace
+
+TEST(VertexLayout, descriptionsAreConstant)
+{
+    static_assert(rr::VertexType<rr::Vertex> && rr::VertexType<rr::PackedVertex> && rr::VertexType<SplitVertex>);
+    static_assert(rr::Vertex::getAttributeDescriptions()[1].offset == offsetof(rr::Vertex, color));
+    static_assert(rr::Vertex::getAttributeDescriptions()[1].format == VK_FORMAT_R32G32B32_SFLOAT);
+    static_assert(rr::PackedVertex::getBindingDescriptions()[0].stride == 12);
+
+    constexpr auto bindings{ SplitVertex::getBindingDescriptions() };
+    constexpr auto attributes{ SplitVertex::getAttributeDescriptions() };
+
+    EXPECT_EQ(bindings.size(), 2);
+    EXPECT_EQ(bindings[1].binding, 1);
+    EXPECT_EQ(bindings[1].stride, sizeof(ShadingStream));
+    ASSERT_EQ(attributes.size(), 3);
+    EXPECT_EQ(attributes[0].binding, 0);
+    EXPECT_EQ(attributes[2].binding, 1);
+    EXPECT_EQ(attributes[2].location, 2);
+    EXPECT_EQ(attributes[2].format, VK_FORMAT_R8G8B8A8_UNORM);
+    EXPECT_EQ(attributes[1].format, VK_FORMAT_R16G16_SNORM);
+}
+
+TEST(VertexLayout, instanceStreamsAdvancePerInstance)
+{
+    constexpr auto bindings{ rr::InstancedVertex::getBindingDescriptions() };
+    constexpr auto attributes{ rr::InstancedVertex::getAttributeDescriptions() };
+
+    static_assert(bindings[0].inputRate == VK_VERTEX_INPUT_RATE_VERTEX);
+    static_assert(bindings[rr::INSTANCE_BINDING].inputRate == VK_VERTEX_INPUT_RATE_INSTANCE);
+    static_assert(bindings[rr::INSTANCE_BINDING].stride == sizeof(rr::InstanceData));
+
+    ASSERT_EQ(attributes.size(), 5);
+    EXPECT_EQ(attributes[2].binding, rr::INSTANCE_BINDING);
+    EXPECT_EQ(attributes[2].location, 2);
+    EXPECT_EQ(attributes[4].offset, offsetof(rr::InstanceData, payload));
+    EXPECT_EQ(attributes[4].format, VK_FORMAT_R32G32B32A32_SFLOAT);
+}
+
+TEST(VertexLayout, halfFloatConversion)
+{
+    static_assert(rr::floatToHalf(1.f) == 0x3C00);
+    static_assert(rr::floatToHalf(-2.f) == 0xC000);
+    static_assert(rr::floatToHalf(65504.f) == 0x7BFF);
+    static_assert(rr::floatToHalf(1e6f) == 0x7C00);
+    static_assert(rr::halfToFloat(0x3555) == 0.333251953125f);
+
+    EXPECT_EQ(rr::floatToHalf(5.9604645e-8f), 0x0001);
+    EXPECT_EQ(rr::floatToHalf(1e-9f), 0x0000);
+    EXPECT_TRUE(std::isnan(rr::halfToFloat(rr::floatToHalf(std::nanf("")))));
+
+    for(float value{ -100.f }; value < 100.f; value += 0.37f)
+        EXPECT_NEAR(rr::halfToFloat(rr::floatToHalf(value)), value, std::abs(value) / 1024.f);
+}
+
+TEST(VertexLayout, normalizedPacking)
+{
+    EXPECT_EQ(rr::packUnorm8(1.f), 255);
+    EXPECT_EQ(rr::packUnorm8(0.5f), 128);
+    EXPECT_EQ(rr::packUnorm8(-3.f), 0);
+    EXPECT_EQ(rr::packSnorm8(-1.f), -127);
+    EXPECT_EQ(rr::packSnorm16(0.5f), 16384);
+}
+
+TEST(VertexLayout, octahedralNormalsRoundTrip)
+{
+    for(const auto& [x, y, z] : { std::array{ 0.f, 0.f, 1.f }, std::array{ 0.f, 0.f, -1.f }, std::array{ 0.48f, -0.6f, -0.64f }, std::array{ -0.6f, 0.f, 0.8f } })
+    {
+        const auto decoded{ rr::decodeOctahedral(rr::encodeOctahedral(x, y, z)) };
+
+        EXPECT_NEAR(decoded[0], x, 1e-3f);
+        EXPECT_NEAR(decoded[1], y, 1e-3f);
+        EXPECT_NEAR(decoded[2], z, 1e-3f);
+    }
+}